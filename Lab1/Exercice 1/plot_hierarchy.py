@@ -0,0 +1,50 @@
+import pandas as pd
+import matplotlib.pyplot as plt
+import numpy as np
+
+# Read data written by ./stride --latency and ./stride --surface
+latency = pd.read_csv("latency.csv")
+surface = pd.read_csv("surface.csv")
+
+
+# Create figure with subplots
+fig, axes = plt.subplots(1, 3, figsize=(20, 6))
+fig.suptitle('Memory Hierarchy Probe: Caches and TLB', fontsize=16, fontweight='bold')
+
+# 1. Load latency vs working set, 4K vs 2M pages
+ax1 = axes[0]
+for pages, marker, color in (("4K", "o", "red"), ("2M", "s", "green")):
+    data = latency[latency["pages"] == pages]
+    if len(data) == 0:
+        continue
+    ax1.plot(data["working_set"] / 1024, data["ns_per_load"], marker=marker, linewidth=2,
+             markersize=6, label=f"{pages} pages", color=color)
+ax1.set_xscale("log", base=2)
+ax1.set_yscale("log")
+ax1.set_xlabel("Working set (KB)", fontsize=12, fontweight='bold')
+ax1.set_ylabel("Latency (ns per load)", fontsize=12, fontweight='bold')
+ax1.set_title("Pointer-Chasing Latency", fontsize=13, fontweight='bold')
+ax1.legend(fontsize=10)
+ax1.grid(True, alpha=0.3, which="both")
+
+# 2-3. Bandwidth surface (cache-line MB/s) for each page size
+for ax, pages in zip(axes[1:], ("4K", "2M")):
+    data = surface[surface["pages"] == pages]
+    if len(data) == 0:
+        ax.set_visible(False)
+        continue
+    grid = data.pivot(index="working_set", columns="stride", values="line_rate(MB/s)")
+    image = ax.imshow(np.log10(grid.values), aspect="auto", origin="lower", cmap="viridis")
+    ax.set_xticks(range(len(grid.columns)))
+    ax.set_xticklabels(grid.columns, rotation=45)
+    ax.set_yticks(range(len(grid.index)))
+    ax.set_yticklabels([f"{s // 1024}K" if s < 1024 * 1024 else f"{s // (1024 * 1024)}M" for s in grid.index])
+    ax.set_xlabel("Stride (bytes)", fontsize=12, fontweight='bold')
+    ax.set_ylabel("Working set", fontsize=12, fontweight='bold')
+    ax.set_title(f"Line Bandwidth, {pages} pages (log10 MB/s)", fontsize=13, fontweight='bold')
+    fig.colorbar(image, ax=ax)
+
+plt.tight_layout()
+plt.savefig('memory_hierarchy.png', dpi=300, bbox_inches='tight')
+print("✓ Saved: memory_hierarchy.png")
+plt.show()
@@ -1,35 +1,868 @@
+// Build: gcc -O2 -fopenmp -I../../common stride.c ../../common/bench.c ../../common/perf_counters.c ../../common/cache_info.c ../../common/tune_profile.c ../../common/affinity.c ../../common/mem_policy.c -lm -lpthread -o stride
+//
+// Usage: ./stride                    classic stride 1..20 table (read by plot.py)
+//        ./stride --surface[=FILE]   bandwidth surface: working set x stride (surface.csv)
+//        ./stride --latency[=FILE]   pointer-chasing load latency per working set (latency.csv)
+//        ./stride --parallel[=FILE]  read/write/RMW/non-temporal GB/s for T = 1..threads (parallel.csv)
+// Options: --min=SIZE --max=SIZE     working-set range (default 4K..1G; --parallel splits --max)
+//          --pages=default|4k|thp|hugetlb|2m|both   page policy of the probed buffer (default
+//                                    both = 4k then hugetlb, 2m = hugetlb; the classic table
+//                                    takes one policy, else MEM_PAGES)
+//          --numa=default|local|interleave   NUMA placement of every buffer (or MEM_NUMA)
+//          --threads=T               highest thread count of --parallel (default: all CPUs)
+//          --affinity=none|compact|scatter   thread placement of --parallel (default scatter)
+//          --save                    store the detected cache sizes and the saturating thread
+//                                    count in the tuning profile (used by gemm_default_params)
+#define _GNU_SOURCE
 #include "stdio.h"
 #include "stdlib.h"
-#include "time.h"
+#include "string.h"
+#include "stdint.h"
+#include "emmintrin.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+#include "bench.h"
+#include "cache_info.h"
+#include "tune_profile.h"
+#include "affinity.h"
+#include "mem_policy.h"
 
 #define MAX_STRIDE 20
 
-int main()
+// Probe ranges: working set 4 KB .. 1 GB, stride 8 B .. 4 KB
+#define PROBE_MIN_BYTES   (4UL * 1024)
+#define PROBE_MAX_BYTES   (1024UL * 1024 * 1024)
+#define PROBE_MIN_STRIDE  8
+#define PROBE_MAX_STRIDE  4096
+
+// Accesses per timed run, so that small working sets are traversed many times
+#define SURFACE_ACCESSES  (1L << 22)
+#define CHASE_LOADS       (1L << 22)
+
+// A cache level ends where latency grows by more than this between neighbouring sizes
+#define CHASE_KNEE        1.3
+
+#define MAX_POINTS        64
+
+// Parallel mode: each run moves at least this many bytes; a thread count
+// saturates once it reaches this fraction of the best aggregate bandwidth
+#define PARALLEL_MIN_BYTES  (256UL * 1024 * 1024)
+#define PARALLEL_SATURATION 0.9
+
+typedef enum
+{
+    BW_READ,
+    BW_WRITE,
+    BW_RMW,
+    BW_NT_STORE,
+    BW_NUM_KINDS
+} BandwidthKind;
+
+static const char *bw_names[BW_NUM_KINDS] = {"read", "write", "rmw", "nt-store"};
+
+// Bytes per element as the program sees them; the write-allocate read of plain
+// stores is not counted (STREAM convention), which is what nt-store avoids
+static const int bw_bytes[BW_NUM_KINDS] = {8, 8, 16, 8};
+
+// NUMA placement of the probed buffers (--numa)
+static NumaPolicy numa_policy = NUMA_DEFAULT;
+
+typedef struct
+{
+    const double *a;
+    int n;
+    int stride;
+    double sum;
+} StrideRun;
+
+typedef struct
+{
+    const double *a;
+    long count;         // elements in the working set
+    long step;          // stride in elements
+    long passes;
+    double sum;
+} SurfaceRun;
+
+typedef struct
+{
+    void **start;
+    long loads;
+    void *end;          // keeps the chain live
+} ChaseRun;
+
+typedef struct
+{
+    double *a;
+    long slice;         // elements per thread, a multiple of 8 (64-byte aligned slices)
+    BandwidthKind kind;
+    long passes;
+    double best[AFFINITY_MAX_CPUS];   // fastest sweep of each thread, seconds
+    double sum;
+} ParallelRun;
+
+// Function to sum n elements read with the given stride (benchmark callback)
+void strided_sum(void *ctx)
+{
+    StrideRun *r = ctx;
+    double sum = 0.0;
+
+    for (int i = 0; i < r->n * r->stride; i += r->stride)
+        sum += r->a[i];
+
+    r->sum = sum;
+}
+
+// Function to read a working set with a stride, several passes (benchmark callback).
+// Four partial sums keep the add latency from hiding the memory system.
+void surface_sum(void *ctx)
+{
+    SurfaceRun *r = ctx;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    long last = r->count - 3 * r->step;
+
+    for (long p = 0; p < r->passes; p++)
+    {
+        long i = 0;
+        for (; i < last; i += 4 * r->step)
+        {
+            s0 += r->a[i];
+            s1 += r->a[i + r->step];
+            s2 += r->a[i + 2 * r->step];
+            s3 += r->a[i + 3 * r->step];
+        }
+        for (; i < r->count; i += r->step)
+            s0 += r->a[i];
+    }
+
+    r->sum = s0 + s1 + s2 + s3;
+}
+
+// Function to follow the pointer chain (benchmark callback): every load depends
+// on the previous one, so the time per load is the latency of the level holding it
+void chase(void *ctx)
+{
+    ChaseRun *r = ctx;
+    void **p = r->start;
+
+    for (long i = 0; i < r->loads; i += 8)
+    {
+        p = *p; p = *p; p = *p; p = *p;
+        p = *p; p = *p; p = *p; p = *p;
+    }
+
+    r->end = p;
+}
+
+// Function to sweep one thread's slice with a read, write, RMW or streaming-store pattern
+double sweep_slice(double *a, long n, BandwidthKind kind, long passes)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    const __m128d one = _mm_set1_pd(1.0);
+
+    for (long p = 0; p < passes; p++)
+    {
+        switch (kind)
+        {
+        case BW_READ:
+            for (long i = 0; i < n; i += 4)
+            {
+                s0 += a[i];
+                s1 += a[i + 1];
+                s2 += a[i + 2];
+                s3 += a[i + 3];
+            }
+            break;
+        case BW_WRITE:
+            for (long i = 0; i < n; i++)
+                a[i] = 1.0;
+            break;
+        case BW_RMW:
+            for (long i = 0; i < n; i++)
+                a[i] += 1.0;
+            break;
+        default:
+            // Non-temporal stores bypass the caches and skip the write-allocate read
+            for (long i = 0; i < n; i += 2)
+                _mm_stream_pd(a + i, one);
+            _mm_sfence();
+            break;
+        }
+    }
+
+    return s0 + s1 + s2 + s3;
+}
+
+// Function to sweep every thread's own slice (benchmark callback); each thread
+// times itself after a barrier so per-thread and aggregate rates can be compared
+void parallel_sweep(void *ctx)
+{
+    ParallelRun *r = ctx;
+    double sum = 0.0;
+
+    #pragma omp parallel reduction(+:sum)
+    {
+#ifdef _OPENMP
+        int t = omp_get_thread_num();
+#else
+        int t = 0;
+#endif
+        #pragma omp barrier
+        double start = bench_now();
+        sum += sweep_slice(r->a + t * r->slice, r->slice, r->kind, r->passes);
+        double elapsed = bench_now() - start;
+        if (t < AFFINITY_MAX_CPUS && elapsed < r->best[t])
+            r->best[t] = elapsed;
+    }
+
+    r->sum = sum;
+}
+
+// Function to parse a byte count with an optional K/M/G suffix
+size_t parse_bytes(const char *s)
+{
+    char *end;
+    size_t v = strtoul(s, &end, 10);
+    if (*end == 'k' || *end == 'K') v *= 1024;
+    else if (*end == 'm' || *end == 'M') v *= 1024 * 1024;
+    else if (*end == 'g' || *end == 'G') v *= 1024UL * 1024 * 1024;
+    return v;
+}
+
+// Function to format a byte count as "48K", "2M", "1G"
+const char *format_bytes(size_t bytes, char *buf, size_t len)
+{
+    if (bytes >= 1024UL * 1024 * 1024 && bytes % (1024UL * 1024 * 1024) == 0)
+        snprintf(buf, len, "%zuG", bytes >> 30);
+    else if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0)
+        snprintf(buf, len, "%zuM", bytes >> 20);
+    else if (bytes >= 1024 && bytes % 1024 == 0)
+        snprintf(buf, len, "%zuK", bytes >> 10);
+    else
+        snprintf(buf, len, "%zu", bytes);
+    return buf;
+}
+
+// Function to label a page policy by its page size in the output ("4K", "2M")
+const char *page_label(PagePolicy kind)
+{
+    if (kind == PAGES_4K)
+        return "4K";
+    return kind == PAGES_DEFAULT ? "default" : "2M";
+}
+
+// Function to map a buffer with 4 KB pages or 2 MB huge pages and touch it.
+// 2 MB tries hugetlbfs first, then transparent huge pages on a 2 MB-aligned
+// mapping; mem_region_backing tells what the kernel actually used.
+int region_alloc(MemRegion *r, size_t bytes, PagePolicy kind)
+{
+    MemPolicy policy = {kind, numa_policy};
+    if (!mem_region_alloc(r, bytes, &policy))
+        return 0;
+    memset(r->data, 0, r->len);
+    return 1;
+}
+
+// Function to link one pointer per cache line into a single random cycle
+// (Sattolo's algorithm), so hardware prefetchers cannot predict the next line
+void **build_chain(char *base, size_t bytes, int line)
+{
+    size_t count = bytes / line;
+    size_t *next = malloc(count * sizeof(size_t));
+    if (!next)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL; // Fixed seed for reproducibility
+    for (size_t i = 0; i < count; i++)
+        next[i] = i;
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t j = seed % i;
+        size_t tmp = next[i];
+        next[i] = next[j];
+        next[j] = tmp;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        *(void **)(base + i * line) = base + next[i] * line;
+
+    free(next);
+    return (void **)base;
+}
+
+// Function to list the probed working sets: one or two points per octave
+int probe_sizes(size_t min_bytes, size_t max_bytes, int per_octave, size_t *sizes)
+{
+    int count = 0;
+    for (size_t s = PROBE_MIN_BYTES; s <= max_bytes && count < MAX_POINTS; s *= 2)
+    {
+        if (s >= min_bytes)
+            sizes[count++] = s;
+        if (per_octave > 1 && s + s / 2 <= max_bytes && s + s / 2 >= min_bytes && count < MAX_POINTS)
+            sizes[count++] = s + s / 2;
+    }
+    return count;
+}
+
+// Function to find the cache sizes from a latency curve: a level ends before
+// each local maximum of the growth ratio between neighbouring sizes that exceeds
+// CHASE_KNEE, so a transition sampled over two points still counts once
+int detect_levels(const size_t *sizes, const double *ns, int count, size_t *levels, int max_levels)
+{
+    int found = 0;
+    for (int i = 1; i < count && found < max_levels; i++)
+    {
+        if (ns[i - 1] <= 0.0 || ns[i] <= 0.0)
+            continue;
+        double ratio = ns[i] / ns[i - 1];
+        double before = (i > 1 && ns[i - 2] > 0.0) ? ns[i - 1] / ns[i - 2] : 0.0;
+        double after = (i + 1 < count && ns[i + 1] > 0.0) ? ns[i + 1] / ns[i] : 0.0;
+        if (ratio > CHASE_KNEE && ratio >= before && ratio >= after)
+            levels[found++] = sizes[i - 1];
+    }
+    return found;
+}
+
+// Function to measure every access pattern with T = 1..max_threads threads, each
+// on its own slice first-touched by itself. The buffer follows --numa: under the
+// default policy each thread's pages land on its own node.
+// Returns the smallest thread count saturating read and write bandwidth.
+int run_parallel(FILE *out, size_t bytes, int max_threads, const CpuTopology *topo, AffinityMode mode)
+{
+    BenchConfig cfg;
+    BenchResult result;
+    double aggregate[BW_NUM_KINDS][AFFINITY_MAX_CPUS + 1];
+
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    printf("%7s", "");
+    for (int k = 0; k < BW_NUM_KINDS; k++)
+        printf(" | %-16s", bw_names[k]);
+    printf("\n%7s", "Threads");
+    for (int k = 0; k < BW_NUM_KINDS; k++)
+        printf(" | %7s %8s", "GB/s", "/thread");
+    printf("\n");
+
+    for (int t = 1; t <= max_threads; t++)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(t);
+#endif
+        affinity_pin_threads(topo, mode);
+
+        long slice = bytes / sizeof(double) / t;
+        slice -= slice % 8;
+        size_t len = (size_t)slice * t * sizeof(double);
+        MemPolicy policy = {PAGES_DEFAULT, numa_policy};
+        MemRegion region;
+        if (!mem_region_alloc(&region, len, &policy))
+        {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+        double *a = region.data;
+
+        // First touch: every thread faults in the slice it will sweep
+        #pragma omp parallel
+        {
+#ifdef _OPENMP
+            int id = omp_get_thread_num();
+#else
+            int id = 0;
+#endif
+            for (long i = 0; i < slice; i++)
+                a[id * slice + i] = 1.0;
+        }
+
+        long passes = (PARALLEL_MIN_BYTES + len - 1) / len;
+        printf("%7d", t);
+        for (int k = 0; k < BW_NUM_KINDS; k++)
+        {
+            ParallelRun run = {a, slice, k, passes, {0.0}, 0.0};
+            for (int i = 0; i < AFFINITY_MAX_CPUS; i++)
+                run.best[i] = 1e30;
+            double moved = (double)bw_bytes[k] * slice * t * passes;
+            bench_run(bw_names[k], "", parallel_sweep, &run, &cfg, 0, moved, &result);
+
+            // Per-thread rate from each thread's own fastest sweep
+            double per_thread = 0.0, slowest = 1e30;
+            for (int i = 0; i < t && i < AFFINITY_MAX_CPUS; i++)
+            {
+                double rate = bw_bytes[k] * (double)slice * passes / run.best[i] / 1e9;
+                per_thread += rate / t;
+                if (rate < slowest)
+                    slowest = rate;
+            }
+            aggregate[k][t] = bench_gbps(&result);
+
+            fprintf(out, "%d,%s,%f,%f,%f,%f\n", t, bw_names[k], aggregate[k][t], per_thread,
+                    slowest, aggregate[k][t] / (t * aggregate[k][1]));
+            printf(" | %7.2f %8.2f", aggregate[k][t], per_thread);
+            fflush(stdout);
+        }
+        printf("\n");
+        mem_region_free(&region);
+    }
+
+    printf("\nSaturation (first T within %.0f%% of the best aggregate):\n", 100.0 * PARALLEL_SATURATION);
+    int saturating[BW_NUM_KINDS];
+    for (int k = 0; k < BW_NUM_KINDS; k++)
+    {
+        double best = 0.0;
+        int best_t = 1;
+        for (int t = 1; t <= max_threads; t++)
+        {
+            if (aggregate[k][t] > best)
+            {
+                best = aggregate[k][t];
+                best_t = t;
+            }
+        }
+        saturating[k] = best_t;
+        for (int t = 1; t <= best_t; t++)
+        {
+            if (aggregate[k][t] >= PARALLEL_SATURATION * best)
+            {
+                saturating[k] = t;
+                break;
+            }
+        }
+        printf("  %-9s T=%-3d %7.2f GB/s (best %.2f GB/s at T=%d, 1 thread %.2f GB/s)\n",
+               bw_names[k], saturating[k], aggregate[k][saturating[k]], best, best_t, aggregate[k][1]);
+    }
+
+    // Loads plus plain stores, like compute_addition (c[i] = a[i] + b[i])
+    return saturating[BW_READ] > saturating[BW_WRITE] ? saturating[BW_READ] : saturating[BW_WRITE];
+}
+
+// Function to run the classic lab table: stride 1..20 over a 160 MB array
+// mapped under the given page / NUMA policy
+int run_classic(const MemPolicy *policy)
 {
     int N = 1000000;
     double *a;
-    a = malloc(N * MAX_STRIDE * sizeof(double));
-    double sum, rate, msec, start, end;
+    double rate, msec;
+    BenchConfig cfg;
+    BenchResult result;
+    MemRegion region;
+    MemFaults before, after;
+    char backing[32];
+
+    if (!mem_region_alloc(&region, (size_t)N * MAX_STRIDE * sizeof(double), policy))
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    a = (double *)region.data;
 
+    mem_faults_read(&before);
+    double start = bench_now();
     for (int i = 0; i < N * MAX_STRIDE; i++)
         a[i] = 1.;
+    double init = bench_now() - start;
+    mem_faults_read(&after);
+
+    // On stderr: stdout is the CSV plot.py reads
+    fprintf(stderr, "# pages %s (%s), NUMA %s: first touch %.1f ms, %ld page faults\n",
+            page_policy_name(policy->pages), mem_region_backing(&region, backing, sizeof(backing)),
+            numa_policy_name(policy->numa), init * 1000.0,
+            after.minor - before.minor + after.major - before.major);
+
+    // Wall-clock median over BENCH_REPS runs after BENCH_WARMUP warmup runs
+    bench_default_config(&cfg);
 
-    printf("stride,sum,time(msec),rate(MB/s)\n");
+    printf("stride,sum,time(msec),rate(MB/s),min(msec),stddev(msec)\n");
 
     for (int i_stride = 1; i_stride <= MAX_STRIDE; i_stride++)
     {
-        sum = 0.0;
-        start = (double)clock() / CLOCKS_PER_SEC;
+        StrideRun run = {a, N, i_stride, 0.0};
+        bench_run("stride", "", strided_sum, &run, &cfg, N, sizeof(double) * N, &result);
 
-        for (int i = 0; i < N * i_stride; i += i_stride)
-            sum += a[i];
-
-        end = (double)clock() / CLOCKS_PER_SEC;
-        msec = (end - start) * 1000.0; // Time in milliseconds
+        msec = result.median * 1000.0; // Time in milliseconds
         rate = sizeof(double) * N * (1000.0 / msec) / (1024 * 1024);
 
-        printf("%d,%f,%f,%f\n", i_stride, sum, msec, rate);
+        printf("%d,%f,%f,%f,%f,%f\n", i_stride, run.sum, msec, rate,
+               result.min * 1000.0, result.stddev * 1000.0);
+    }
+
+    mem_region_free(&region);
+    return EXIT_SUCCESS;
+}
+
+// Function to measure time per access over every (working set, stride) pair
+void run_surface(FILE *out, const size_t *sizes, int num_sizes, PagePolicy kind, const CacheInfo *c)
+{
+    BenchConfig cfg;
+    BenchResult result;
+    MemRegion region;
+    char backing[32], label[16];
+
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    for (int s = 0; s < num_sizes; s++)
+    {
+        if (!region_alloc(&region, sizes[s], kind))
+        {
+            fprintf(stderr, "Could not map %s\n", format_bytes(sizes[s], label, sizeof(label)));
+            continue;
+        }
+        mem_region_backing(&region, backing, sizeof(backing));
+
+        double *a = (double *)region.data;
+        long count = sizes[s] / sizeof(double);
+        for (long i = 0; i < count; i++)
+            a[i] = 1.;
+
+        printf("  %-6s %-14s", format_bytes(sizes[s], label, sizeof(label)), backing);
+        for (int stride = PROBE_MIN_STRIDE; stride <= PROBE_MAX_STRIDE; stride *= 2)
+        {
+            long step = stride / sizeof(double);
+            long accesses = (count + step - 1) / step;
+            if (accesses < 1)
+                continue;
+            long passes = (SURFACE_ACCESSES + accesses - 1) / accesses;
+
+            SurfaceRun run = {a, count, step, passes, 0.0};
+            bench_run("surface", "", surface_sum, &run, &cfg, 0, 0, &result);
+
+            double total = (double)accesses * passes;
+            double ns = result.median / total * 1e9;
+            // Useful bytes (one double per access) and cache-line bytes actually moved
+            double rate = sizeof(double) * total / result.median / (1024 * 1024);
+            double line_bytes = stride < c->line ? stride : c->line;
+            double line_rate = line_bytes * total / result.median / (1024 * 1024);
+
+            fprintf(out, "%s,%zu,%d,%f,%f,%f\n", page_label(kind),
+                    sizes[s], stride, ns, rate, line_rate);
+            printf(" %6.2f", ns);
+            fflush(stdout);
+        }
+        printf("\n");
+        mem_region_free(&region);
+    }
+}
+
+// Function to measure the load latency of every working set (0 where mapping failed)
+void run_latency(FILE *out, const size_t *sizes, int num_sizes, PagePolicy kind,
+                const CacheInfo *c, double *ns_out)
+{
+    BenchConfig cfg;
+    BenchResult result;
+    MemRegion region;
+    char backing[32], label[16];
+
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    for (int s = 0; s < num_sizes; s++)
+    {
+        ns_out[s] = 0.0;
+        if (!region_alloc(&region, sizes[s], kind))
+        {
+            fprintf(stderr, "Could not map %s\n", format_bytes(sizes[s], label, sizeof(label)));
+            continue;
+        }
+        mem_region_backing(&region, backing, sizeof(backing));
+
+        ChaseRun run = {build_chain(region.data, sizes[s], c->line), CHASE_LOADS, NULL};
+        bench_run("chase", "", chase, &run, &cfg, 0, 0, &result);
+
+        double ns = result.median / CHASE_LOADS * 1e9;
+        double cycles = result.cycles / CHASE_LOADS;
+        ns_out[s] = ns;
+
+        fprintf(out, "%s,%zu,%f,%f,%f\n", page_label(kind), sizes[s], ns, cycles,
+                result.stddev / CHASE_LOADS * 1e9);
+        printf("  %-6s %-14s %10.2f %10.1f\n", format_bytes(sizes[s], label, sizeof(label)),
+               backing, ns, cycles);
+        fflush(stdout);
+        mem_region_free(&region);
+    }
+}
+
+// Function to store probe results in this machine's tuning profile
+// (found < 0 keeps the cache sizes, stream_threads <= 0 keeps the thread count)
+int save_profile(const size_t *levels, int found, int stream_threads)
+{
+    char path[768];
+    TuneProfile profile;
+    tune_profile_path(path, sizeof(path));
+    if (!tune_profile_load(&profile))
+    {
+        memset(&profile, 0, sizeof(profile));
+        tune_cpu_name(profile.cpu, sizeof(profile.cpu));
+    }
+    if (found >= 0)
+    {
+        profile.cache_l1d = found > 0 ? levels[0] : 0;
+        profile.cache_l2 = found > 1 ? levels[1] : 0;
+        profile.cache_llc = found > 2 ? levels[2] : 0;
+    }
+    if (stream_threads > 0)
+        profile.stream_threads = stream_threads;
+    if (!tune_profile_save(&profile))
+        return 0;
+
+    if (found >= 0)
+        printf("Cache sizes saved to %s (used by gemm_default_params)\n", path);
+    if (stream_threads > 0)
+        printf("Stream thread count saved to %s\n", path);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *surface_file = NULL;
+    const char *latency_file = NULL;
+    size_t min_bytes = PROBE_MIN_BYTES;
+    size_t max_bytes = PROBE_MAX_BYTES;
+    PagePolicy kinds[2] = {PAGES_4K, PAGES_HUGETLB};
+    int num_kinds = 2, parsed;
+    const char *parallel_file = NULL;
+    int max_threads = 0;
+    AffinityMode mode = AFFINITY_SCATTER;
+    int save = 0;
+    MemPolicy policy;
+
+    // Page and NUMA policy from MEM_PAGES / MEM_NUMA, overridden below
+    mem_policy_default(&policy);
+
+    // Parse command-line arguments (none: the classic table)
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--surface", 9) == 0)
+            surface_file = argv[i][9] == '=' ? argv[i] + 10 : "surface.csv";
+        else if (strncmp(argv[i], "--latency", 9) == 0)
+            latency_file = argv[i][9] == '=' ? argv[i] + 10 : "latency.csv";
+        else if (strncmp(argv[i], "--parallel", 10) == 0)
+            parallel_file = argv[i][10] == '=' ? argv[i] + 11 : "parallel.csv";
+        else if (strncmp(argv[i], "--threads=", 10) == 0)
+        {
+            max_threads = atoi(argv[i] + 10);
+            if (max_threads <= 0 || max_threads > AFFINITY_MAX_CPUS)
+            {
+                fprintf(stderr, "Thread count must be in 1..%d\n", AFFINITY_MAX_CPUS);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strncmp(argv[i], "--affinity=", 11) == 0)
+        {
+            int m = affinity_parse_mode(argv[i] + 11);
+            if (m < 0)
+            {
+                fprintf(stderr, "Unknown affinity mode: %s\n", argv[i] + 11);
+                return EXIT_FAILURE;
+            }
+            mode = (AffinityMode)m;
+        }
+        else if (strncmp(argv[i], "--min=", 6) == 0)
+            min_bytes = parse_bytes(argv[i] + 6);
+        else if (strncmp(argv[i], "--max=", 6) == 0)
+            max_bytes = parse_bytes(argv[i] + 6);
+        else if (strcmp(argv[i], "--pages=both") == 0)
+            num_kinds = 2;
+        else if (strcmp(argv[i], "--pages=2m") == 0)
+        {
+            policy.pages = kinds[0] = PAGES_HUGETLB;
+            num_kinds = 1;
+        }
+        else if ((parsed = mem_policy_parse_arg(&policy, argv[i])) != 0)
+        {
+            if (parsed < 0)
+                return EXIT_FAILURE;
+            if (strncmp(argv[i], "--pages=", 8) == 0)
+            {
+                kinds[0] = policy.pages;
+                num_kinds = 1;
+            }
+        }
+        else if (strcmp(argv[i], "--save") == 0)
+            save = 1;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--surface[=FILE]] [--latency[=FILE]] [--parallel[=FILE]]\n"
+                            "          [--min=SIZE] [--max=SIZE] [--pages=default|4k|thp|hugetlb|2m|both] [--numa=default|local|interleave]\n"
+                            "          [--threads=T] [--affinity=none|compact|scatter] [--save]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    numa_policy = policy.numa;
+    if (!surface_file && !latency_file && !parallel_file)
+    {
+        // One page policy asked for on the command line, else MEM_PAGES
+        if (num_kinds == 1)
+            policy.pages = kinds[0];
+        return run_classic(&policy);
+    }
+
+    if (min_bytes < PROBE_MIN_BYTES || max_bytes < min_bytes)
+    {
+        fprintf(stderr, "Invalid working-set range\n");
+        return EXIT_FAILURE;
+    }
+
+    CacheInfo c;
+    CpuTopology topo;
+    char l1[16], l2[16], llc[16], lo[16], hi[16];
+    cache_info_detect(&c);
+    affinity_detect(&topo, mode);
+    if (max_threads == 0)
+        max_threads = topo.num_cpus < AFFINITY_MAX_CPUS ? topo.num_cpus : AFFINITY_MAX_CPUS;
+#ifndef _OPENMP
+    max_threads = 1;
+#endif
+
+    printf("=================================================================\n");
+    printf("           MEMORY HIERARCHY PROBE: CACHES AND TLB                \n");
+    printf("=================================================================\n");
+    printf("Caches (sysfs):      L1d %s, L2 %s, LLC %s, %d-byte lines\n",
+           format_bytes(c.l1d, l1, sizeof(l1)), format_bytes(c.l2, l2, sizeof(l2)),
+           format_bytes(c.llc, llc, sizeof(llc)), c.line);
+    if (surface_file || latency_file)
+    {
+        printf("Working sets:        %s .. %s\n", format_bytes(min_bytes, lo, sizeof(lo)),
+               format_bytes(max_bytes, hi, sizeof(hi)));
+        printf("Pages:              ");
+        for (int k = 0; k < num_kinds; k++)
+            printf("%s %s%s", k ? " +" : "", page_policy_name(kinds[k]),
+                   kinds[k] == PAGES_HUGETLB ? " (2M, else transparent huge pages)"
+                   : kinds[k] == PAGES_THP ? " (2M)" : "");
+        printf("\n");
+    }
+    if (parallel_file)
+    {
+        printf("Threads:             1..%d\n", max_threads);
+        affinity_print(&topo);
+    }
+    printf("=================================================================\n\n");
+
+    if (num_kinds == 2)
+    {
+        kinds[0] = PAGES_4K;
+        kinds[1] = PAGES_HUGETLB;
+    }
+
+    if (surface_file)
+    {
+        size_t sizes[MAX_POINTS];
+        int num_sizes = probe_sizes(min_bytes, max_bytes, 1, sizes);
+        if (num_sizes == 0)
+        {
+            fprintf(stderr, "Invalid working-set range\n");
+            return EXIT_FAILURE;
+        }
+        FILE *out = fopen(surface_file, "w");
+        if (!out)
+        {
+            perror(surface_file);
+            return EXIT_FAILURE;
+        }
+        fprintf(out, "pages,working_set,stride,ns_per_access,rate(MB/s),line_rate(MB/s)\n");
+
+        for (int k = 0; k < num_kinds; k++)
+        {
+            printf("Bandwidth surface, ns per access (%s pages)\n", page_label(kinds[k]));
+            printf("  %-6s %-14s", "Set", "Backing");
+            for (int stride = PROBE_MIN_STRIDE; stride <= PROBE_MAX_STRIDE; stride *= 2)
+                printf(" %6d", stride);
+            printf("\n");
+            run_surface(out, sizes, num_sizes, kinds[k], &c);
+            printf("\n");
+        }
+        fclose(out);
+        printf("Surface written to %s\n\n", surface_file);
+    }
+
+    if (latency_file)
+    {
+        size_t sizes[MAX_POINTS];
+        double ns[2][MAX_POINTS];
+        int num_sizes = probe_sizes(min_bytes, max_bytes, 2, sizes);
+        if (num_sizes == 0)
+        {
+            fprintf(stderr, "Invalid working-set range\n");
+            return EXIT_FAILURE;
+        }
+        FILE *out = fopen(latency_file, "w");
+        if (!out)
+        {
+            perror(latency_file);
+            return EXIT_FAILURE;
+        }
+        fprintf(out, "pages,working_set,ns_per_load,cycles_per_load,stddev(ns)\n");
+
+        for (int k = 0; k < num_kinds; k++)
+        {
+            printf("Pointer-chasing latency (%s pages, random cyclic permutation)\n",
+                   page_label(kinds[k]));
+            printf("  %-6s %-14s %10s %10s\n", "Set", "Backing", "ns/load", "TSC/load");
+            run_latency(out, sizes, num_sizes, kinds[k], &c, ns[k]);
+            printf("\n");
+        }
+        fclose(out);
+        printf("Latency written to %s\n\n", latency_file);
+
+        // Huge pages take the TLB out of the curve, so detect the caches on them
+        int clean = num_kinds - 1;
+        size_t levels[3] = {0, 0, 0};
+        int found = detect_levels(sizes, ns[clean], num_sizes, levels, 3);
+
+        printf("Detected levels (%s pages, steepest >%.0f%% latency jumps):\n",
+               page_label(kinds[clean]), 100.0 * (CHASE_KNEE - 1.0));
+        const char *names[3] = {"L1d", "L2", "LLC"};
+        const size_t sysfs[3] = {c.l1d, c.l2, c.llc};
+        for (int i = 0; i < 3; i++)
+        {
+            printf("  %-4s measured %-8s sysfs %s\n", names[i],
+                   i < found ? format_bytes(levels[i], l1, sizeof(l1)) : "-",
+                   format_bytes(sysfs[i], l2, sizeof(l2)));
+        }
+
+        // TLB cost: the 4K / 2M latency ratio at the largest working set
+        if (num_kinds == 2 && ns[1][num_sizes - 1] > 0.0)
+        {
+            printf("TLB cost at %s:      %.2f ns/load (4K %.2f vs 2M %.2f)\n",
+                   format_bytes(sizes[num_sizes - 1], l1, sizeof(l1)),
+                   ns[0][num_sizes - 1] - ns[1][num_sizes - 1], ns[0][num_sizes - 1], ns[1][num_sizes - 1]);
+        }
+
+        if (save && !save_profile(levels, found, 0))
+            return EXIT_FAILURE;
+    }
+
+    if (parallel_file)
+    {
+        FILE *out = fopen(parallel_file, "w");
+        if (!out)
+        {
+            perror(parallel_file);
+            return EXIT_FAILURE;
+        }
+        fprintf(out, "threads,kind,aggregate(GB/s),per_thread(GB/s),slowest_thread(GB/s),efficiency\n");
+
+        printf("Parallel bandwidth, %s split over T threads (%s placement)\n",
+               format_bytes(max_bytes, hi, sizeof(hi)), affinity_mode_name(mode));
+        int stream_threads = run_parallel(out, max_bytes, max_threads, &topo, mode);
+        fclose(out);
+        printf("Memory-bound streams (loads + stores, e.g. compute_addition): use %d thread%s\n",
+               stream_threads, stream_threads > 1 ? "s" : "");
+        printf("Bandwidth written to %s\n\n", parallel_file);
+
+        if (save && !save_profile(NULL, -1, stream_threads))
+            return EXIT_FAILURE;
     }
 
-    free(a);
+    return EXIT_SUCCESS;
 }
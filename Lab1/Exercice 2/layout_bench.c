@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "bench.h"
+
+// Largest size at which the O(n^3) ijk order is still timed (4096 takes minutes)
+#ifndef IJK_MAX_N
+#define IJK_MAX_N 1024
+#endif
+
+// From this size on, a single product takes seconds: time the median of fewer runs
+#define LARGE_N      2048
+#define LARGE_N_REPS 3
+
+// ===== Old layout: one malloc per row, kept only for comparison =====
+
+// Function to allocate a matrix (original double** layout)
+double** allocate_matrix_rows(int n) {
+    double **matrix = (double**)malloc(n * sizeof(double*));
+    if (!matrix) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        matrix[i] = (double*)malloc(n * sizeof(double));
+        if (!matrix[i]) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return matrix;
+}
+
+// Function to free a matrix (original double** layout)
+void free_matrix_rows(double **matrix, int n) {
+    if (!matrix) return;
+    for (int i = 0; i < n; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Function to copy a contiguous matrix into the double** layout
+void copy_to_rows(double **dst, const Matrix *src) {
+    for (int i = 0; i < src->rows; i++) {
+        for (int j = 0; j < src->cols; j++) {
+            dst[i][j] = MAT(src, i, j);
+        }
+    }
+}
+
+// Standard matrix multiplication (ijk order) on the double** layout
+void rows_multiply_ijk(double **a, double **b, double **c, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            for (int k = 0; k < n; k++) {
+                c[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+// Optimized matrix multiplication (ikj order) on the double** layout
+void rows_multiply_ikj(double **a, double **b, double **c, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < n; k++) {
+            double r = a[i][k];
+            for (int j = 0; j < n; j++) {
+                c[i][j] += r * b[k][j];
+            }
+        }
+    }
+}
+
+// Block matrix multiplication on the double** layout
+void rows_multiply_block(double **A, double **B, double **C, int n, int block_size) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            C[i][j] = 0.0;
+        }
+    }
+    for (int i0 = 0; i0 < n; i0 += block_size) {
+        for (int j0 = 0; j0 < n; j0 += block_size) {
+            for (int k0 = 0; k0 < n; k0 += block_size) {
+                for (int i = i0; i < i0 + block_size && i < n; i++) {
+                    for (int j = j0; j < j0 + block_size && j < n; j++) {
+                        double sum = C[i][j];
+                        for (int k = k0; k < k0 + block_size && k < n; k++) {
+                            sum += A[i][k] * B[k][j];
+                        }
+                        C[i][j] = sum;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Function to calculate GFLOPS
+double calculate_gflops(int n, double time_sec) {
+    double operations = 2.0 * n * n * n;
+    return (operations / time_sec) / 1e9;
+}
+
+// One layout under test: the double** rows, or a contiguous matrix (padded or not)
+typedef struct {
+    int n, block_size;
+    double **ar, **br, **cr;    // NULL for the contiguous layouts
+    Matrix *a, *b, *c;
+} LayoutRun;
+
+// Benchmark callbacks
+void run_ijk(void *ctx) {
+    LayoutRun *r = ctx;
+    if (r->ar) rows_multiply_ijk(r->ar, r->br, r->cr, r->n);
+    else matrix_multiply_ijk(r->a, r->b, r->c);
+}
+
+void run_ikj(void *ctx) {
+    LayoutRun *r = ctx;
+    if (r->ar) rows_multiply_ikj(r->ar, r->br, r->cr, r->n);
+    else matrix_multiply_ikj(r->a, r->b, r->c);
+}
+
+void run_block(void *ctx) {
+    LayoutRun *r = ctx;
+    if (r->ar) rows_multiply_block(r->ar, r->br, r->cr, r->n, r->block_size);
+    else matrix_multiply_block(r->a, r->b, r->c, r->block_size);
+}
+
+// Function to clear C before each run, since the kernels accumulate into it
+void reset_c(void *ctx) {
+    LayoutRun *r = ctx;
+    if (r->ar) {
+        for (int i = 0; i < r->n; i++)
+            for (int j = 0; j < r->n; j++)
+                r->cr[i][j] = 0.0;
+    } else {
+        zero_matrix(r->c);
+    }
+}
+
+// Function to time one kernel on the three layouts and print a row of GFLOPS
+void compare_kernel(const char *name, bench_func fn, LayoutRun runs[3], const BenchConfig *cfg) {
+    int n = runs[0].n;
+    double t[3];
+    BenchResult result;
+    for (int l = 0; l < 3; l++) {
+        bench_run(name, "", fn, &runs[l], cfg, 2.0 * n * n * n, 0.0, &result);
+        t[l] = result.median;
+    }
+    printf("  %-8s %10.2f %10.2f %10.2f %9.2fx\n", name, calculate_gflops(n, t[0]),
+           calculate_gflops(n, t[1]), calculate_gflops(n, t[2]), t[0] / t[2]);
+}
+
+// Function to compare the three layouts for one matrix size
+void compare_layouts(int n, int block_size) {
+    Matrix a = allocate_matrix(n, n, MATRIX_NO_PAD);
+    Matrix b = allocate_matrix(n, n, MATRIX_NO_PAD);
+    Matrix c = allocate_matrix(n, n, MATRIX_NO_PAD);
+    Matrix ap = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix bp = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix cp = allocate_matrix(n, n, MATRIX_PAD);
+    double **ar = allocate_matrix_rows(n);
+    double **br = allocate_matrix_rows(n);
+    double **cr = allocate_matrix_rows(n);
+
+    initialize_matrix(&a);
+    initialize_matrix(&b);
+    copy_matrix(&ap, &a);
+    copy_matrix(&bp, &b);
+    copy_to_rows(ar, &a);
+    copy_to_rows(br, &b);
+
+    LayoutRun runs[3] = {
+        {n, block_size, ar, br, cr, NULL, NULL, NULL},
+        {n, block_size, NULL, NULL, NULL, &a, &b, &c},
+        {n, block_size, NULL, NULL, NULL, &ap, &bp, &cp},
+    };
+
+    // Warmup, then the median of the timed runs; fewer of them where one run takes seconds
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+    cfg.reset = reset_c;
+    cfg.counters = 0;
+    if (n >= LARGE_N && cfg.reps > LARGE_N_REPS) cfg.reps = LARGE_N_REPS;
+
+    printf("N = %d (ld: unpadded %d, padded %d)\n", n, a.ld, ap.ld);
+
+    if (n <= IJK_MAX_N) {
+        compare_kernel("ijk", run_ijk, runs, &cfg);
+    } else {
+        printf("  %-8s %10s %10s %10s %10s\n", "ijk", "-", "-", "-", "skipped");
+    }
+    compare_kernel("ikj", run_ikj, runs, &cfg);
+    compare_kernel("block", run_block, runs, &cfg);
+
+    if (!verify_matrices(&c, &cp)) {
+        printf("  ✗ Padded and unpadded results differ\n");
+    }
+    printf("\n");
+
+    free_matrix_rows(ar, n);
+    free_matrix_rows(br, n);
+    free_matrix_rows(cr, n);
+    free_matrix(&a);
+    free_matrix(&b);
+    free_matrix(&c);
+    free_matrix(&ap);
+    free_matrix(&bp);
+    free_matrix(&cp);
+}
+
+int main(int argc, char *argv[]) {
+    int sizes[] = {256, 512, 1024, 2048, 4096};
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    int block_size = 32;
+
+    // Optional: a single matrix size and a block size
+    if (argc > 1) {
+        sizes[0] = atoi(argv[1]);
+        num_sizes = 1;
+        if (sizes[0] <= 0) {
+            fprintf(stderr, "Invalid matrix size\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc > 2) {
+        block_size = atoi(argv[2]);
+        if (block_size <= 0) {
+            fprintf(stderr, "Invalid block size\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("=================================================================\n");
+    printf("     MATRIX LAYOUT COMPARISON: double** vs contiguous buffer    \n");
+    printf("=================================================================\n");
+    printf("Block size for block kernel: %d\n", block_size);
+    printf("Columns: GFLOPS for double** | contiguous | contiguous+padding\n");
+    printf("Timing: median after warmup (BENCH_WARMUP / BENCH_REPS; at most %d reps from N = %d)\n",
+           LARGE_N_REPS, LARGE_N);
+    printf("=================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    printf("  %-8s %10s %10s %10s %10s\n", "Kernel", "double**", "flat", "padded", "Speedup");
+    printf("-----------------------------------------------------------------\n");
+    for (int i = 0; i < num_sizes; i++) {
+        compare_layouts(sizes[i], block_size);
+    }
+    printf("=================================================================\n");
+
+    return EXIT_SUCCESS;
+}
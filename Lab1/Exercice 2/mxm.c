@@ -2,73 +2,23 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "bench.h"
+#include "cache_info.h"
+#include "roofline.h"
+
 #ifndef N
 #define N 1024
 #endif
 
-// Function to allocate a matrix
-double** allocate_matrix(int n) {
-    double **matrix = (double**)malloc(n * sizeof(double*));
-    if (!matrix) {
-        fprintf(stderr, "Memory allocation failed\n");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i < n; i++) {
-        matrix[i] = (double*)malloc(n * sizeof(double));
-        if (!matrix[i]) {
-            fprintf(stderr, "Memory allocation failed\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-    return matrix;
-}
-
-// Function to free a matrix
-void free_matrix(double **matrix, int n) {
-    if (!matrix) return;
-    for (int i = 0; i < n; i++) {
-        free(matrix[i]);
-    }
-    free(matrix);
-}
-
-// Function to initialize a matrix with random values
-void initialize_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (double)(rand() % 100) / 10.0;
-        }
-    }
-}
-
-// Function to zero-initialize a matrix
-void zero_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = 0.0;
-        }
-    }
-}
-
-// Standard matrix multiplication (ijk order) - ORIGINAL VERSION
-void matrix_multiply_ijk(double **a, double **b, double **c, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            for (int k = 0; k < n; k++) {
-                c[i][j] += a[i][k] * b[k][j];
-            }
-        }
-    }
-}
-
-// Function to calculate memory bandwidth
+// Function to calculate memory bandwidth from the modelled traffic of the ijk
+// order between the level holding the matrices and the cache above it
 double calculate_bandwidth(int n, double time_sec) {
-    // Memory accesses: reading A (n^3), reading B (n^3), reading+writing C (2*n^3)
-    // Total: 4*n^3 * sizeof(double)
-    double memory_accessed = 4.0 * n * n * n * sizeof(double);
-    double bandwidth_bytes_per_sec = memory_accessed / time_sec;
-    double bandwidth_gb_per_sec = bandwidth_bytes_per_sec / (1024.0 * 1024.0 * 1024.0);
-    return bandwidth_gb_per_sec;
+    CacheInfo caches;
+    cache_info_detect(&caches);
+    double memory_accessed = roofline_traffic_loop_order(&caches, loop_order_index("ijk"), n);
+    return memory_accessed / time_sec / 1e9;
 }
 
 // Function to calculate GFLOPS
@@ -79,6 +29,21 @@ double calculate_gflops(int n, double time_sec) {
     return gflops;
 }
 
+typedef struct {
+    Matrix *a, *b, *c;
+} MultiplyRun;
+
+// Function to run one ijk product (benchmark callback)
+void run_ijk(void *ctx) {
+    MultiplyRun *r = ctx;
+    matrix_multiply_ijk(r->a, r->b, r->c);
+}
+
+// Function to clear C before each run, since the kernel accumulates into it
+void reset_c(void *ctx) {
+    zero_matrix(((MultiplyRun*)ctx)->c);
+}
+
 int main(int argc, char *argv[]) {
     int n = N;
     
@@ -103,24 +68,27 @@ int main(int argc, char *argv[]) {
     
     // Allocate matrices
     printf("Allocating matrices...\n");
-    double **a = allocate_matrix(n);
-    double **b = allocate_matrix(n);
-    double **c = allocate_matrix(n);
+    Matrix a = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix b = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix c = allocate_matrix(n, n, MATRIX_PAD);
     
     // Initialize matrices
     printf("Initializing matrices...\n");
-    initialize_matrix(a, n);
-    initialize_matrix(b, n);
-    zero_matrix(c, n);
+    initialize_matrix(&a);
+    initialize_matrix(&b);
+    zero_matrix(&c);
     
     printf("Starting matrix multiplication (ijk order)...\n\n");
     
-    // Measure time
-    clock_t start = clock();
-    matrix_multiply_ijk(a, b, c, n);
-    clock_t end = clock();
+    // Measure wall time: warmup, then the median of several runs
+    MultiplyRun run = {&a, &b, &c};
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.reset = reset_c;
+    bench_run("ijk", "", run_ijk, &run, &cfg, 2.0 * n * n * n, 0.0, &result);
     
-    double time_sec = ((double)(end - start)) / CLOCKS_PER_SEC;
+    double time_sec = result.median;
     double bandwidth = calculate_bandwidth(n, time_sec);
     double gflops = calculate_gflops(n, time_sec);
     
@@ -129,18 +97,22 @@ int main(int argc, char *argv[]) {
     printf("                      PERFORMANCE RESULTS                        \n");
     printf("=================================================================\n");
     printf("Loop Order:      ijk (standard)\n");
-    printf("Execution Time:  %.4f seconds\n", time_sec);
-    printf("Bandwidth:       %.2f GB/s\n", bandwidth);
+    printf("Execution Time:  %.4f seconds (median of %d, min %.4f, stddev %.1f%%)\n",
+           time_sec, result.reps, result.min, 100.0 * result.stddev / time_sec);
+    CacheInfo caches;
+    cache_info_detect(&caches);
+    printf("Bandwidth:       %.2f GB/s (modelled traffic from %s)\n", bandwidth,
+           roofline_level_name(roofline_home_level(&caches, n)));
     printf("Performance:     %.2f GFLOPS\n", gflops);
     printf("=================================================================\n\n");
     
     // Print sample results for verification
-    printf("Sample result (first element): c[0][0] = %.4f\n\n", c[0][0]);
+    printf("Sample result (first element): c[0][0] = %.4f\n\n", MAT(&c, 0, 0));
     
     // Free matrices
-    free_matrix(a, n);
-    free_matrix(b, n);
-    free_matrix(c, n);
+    free_matrix(&a);
+    free_matrix(&b);
+    free_matrix(&c);
     
     return EXIT_SUCCESS;
 }
\ No newline at end of file
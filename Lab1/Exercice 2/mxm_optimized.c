@@ -1,132 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <string.h>
 
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "bench.h"
+#include "cache_info.h"
+#include "roofline.h"
+
 #ifndef N
 #define N 1024
 #endif
 
-// Function to allocate a matrix
-double** allocate_matrix(int n) {
-    double **matrix = (double**)malloc(n * sizeof(double*));
-    if (!matrix) {
-        fprintf(stderr, "Memory allocation failed\n");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i < n; i++) {
-        matrix[i] = (double*)malloc(n * sizeof(double));
-        if (!matrix[i]) {
-            fprintf(stderr, "Memory allocation failed\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-    return matrix;
-}
-
-// Function to free a matrix
-void free_matrix(double **matrix, int n) {
-    if (!matrix) return;
-    for (int i = 0; i < n; i++) {
-        free(matrix[i]);
-    }
-    free(matrix);
-}
-
-// Function to initialize a matrix with random values
-void initialize_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (double)(rand() % 100) / 10.0;
-        }
-    }
-}
-
-// Function to zero-initialize a matrix
-void zero_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = 0.0;
-        }
-    }
-}
-
-// Standard matrix multiplication (ijk order) - ORIGINAL
-void matrix_multiply_ijk(double **a, double **b, double **c, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            for (int k = 0; k < n; k++) {
-                c[i][j] += a[i][k] * b[k][j];
-            }
-        }
-    }
-}
-
-// Optimized matrix multiplication (ikj order) - CACHE OPTIMIZED
-void matrix_multiply_ikj(double **a, double **b, double **c, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int k = 0; k < n; k++) {
-            double r = a[i][k];
-            for (int j = 0; j < n; j++) {
-                c[i][j] += r * b[k][j];
-            }
-        }
-    }
-}
-
-// Alternative: jik order
-void matrix_multiply_jik(double **a, double **b, double **c, int n) {
-    for (int j = 0; j < n; j++) {
-        for (int i = 0; i < n; i++) {
-            for (int k = 0; k < n; k++) {
-                c[i][j] += a[i][k] * b[k][j];
-            }
-        }
-    }
-}
-
-// Alternative: kij order
-void matrix_multiply_kij(double **a, double **b, double **c, int n) {
-    for (int k = 0; k < n; k++) {
-        for (int i = 0; i < n; i++) {
-            double r = a[i][k];
-            for (int j = 0; j < n; j++) {
-                c[i][j] += r * b[k][j];
-            }
-        }
-    }
-}
-
-// Alternative: jki order
-void matrix_multiply_jki(double **a, double **b, double **c, int n) {
-    for (int j = 0; j < n; j++) {
-        for (int k = 0; k < n; k++) {
-            double r = b[k][j];
-            for (int i = 0; i < n; i++) {
-                c[i][j] += a[i][k] * r;
-            }
-        }
-    }
-}
-
-// Alternative: kji order
-void matrix_multiply_kji(double **a, double **b, double **c, int n) {
-    for (int k = 0; k < n; k++) {
-        for (int j = 0; j < n; j++) {
-            double r = b[k][j];
-            for (int i = 0; i < n; i++) {
-                c[i][j] += a[i][k] * r;
-            }
-        }
-    }
-}
-
-// Function to calculate memory bandwidth
-double calculate_bandwidth(int n, double time_sec) {
-    double memory_accessed = 4.0 * n * n * n * sizeof(double);
-    double bandwidth_bytes_per_sec = memory_accessed / time_sec;
-    double bandwidth_gb_per_sec = bandwidth_bytes_per_sec / (1024.0 * 1024.0 * 1024.0);
-    return bandwidth_gb_per_sec;
+// Function to calculate memory bandwidth from the modelled traffic of one loop
+// order between the level holding the matrices and the cache above it
+double calculate_bandwidth(int order, int n, double time_sec) {
+    CacheInfo caches;
+    cache_info_detect(&caches);
+    double memory_accessed = roofline_traffic_loop_order(&caches, order, n);
+    return memory_accessed / time_sec / 1e9;
 }
 
 // Function to calculate GFLOPS
@@ -136,9 +28,6 @@ double calculate_gflops(int n, double time_sec) {
     return gflops;
 }
 
-// Function to measure execution time
-typedef void (*multiply_func)(double**, double**, double**, int);
-
 typedef struct {
     const char *name;
     multiply_func func;
@@ -147,6 +36,22 @@ typedef struct {
     double gflops;
 } LoopOrder;
 
+typedef struct {
+    multiply_func func;
+    Matrix *a, *b, *c;
+} MultiplyRun;
+
+// Function to run one product (benchmark callback)
+void run_multiply(void *ctx) {
+    MultiplyRun *r = ctx;
+    r->func(r->a, r->b, r->c);
+}
+
+// Function to clear C before each run, since the kernels accumulate into it
+void reset_c(void *ctx) {
+    zero_matrix(((MultiplyRun*)ctx)->c);
+}
+
 int main(int argc, char *argv[]) {
     int n = N;
     
@@ -164,6 +69,10 @@ int main(int argc, char *argv[]) {
     printf("=================================================================\n");
     printf("Matrix size: %d x %d\n", n, n);
     printf("Testing all 6 loop permutations: ijk, ikj, jik, jki, kij, kji\n");
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+    cfg.reset = reset_c;
+    printf("Timing: wall clock, %d warmup + median of %d runs\n", cfg.warmup, cfg.reps);
     printf("=================================================================\n\n");
     
     // Seed random number generator
@@ -171,14 +80,14 @@ int main(int argc, char *argv[]) {
     
     // Allocate matrices
     printf("Allocating matrices...\n");
-    double **a = allocate_matrix(n);
-    double **b = allocate_matrix(n);
-    double **c = allocate_matrix(n);
+    Matrix a = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix b = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix c = allocate_matrix(n, n, MATRIX_PAD);
     
     // Initialize matrices
     printf("Initializing matrices...\n\n");
-    initialize_matrix(a, n);
-    initialize_matrix(b, n);
+    initialize_matrix(&a);
+    initialize_matrix(&b);
     
     // Define all loop orders
     LoopOrder orders[] = {
@@ -191,6 +100,7 @@ int main(int argc, char *argv[]) {
     };
     
     int num_orders = sizeof(orders) / sizeof(orders[0]);
+    BenchResult results[sizeof(orders) / sizeof(orders[0])];
     
     printf("=================================================================\n");
     printf("                      PERFORMANCE RESULTS                        \n");
@@ -198,20 +108,19 @@ int main(int argc, char *argv[]) {
     
     // Test each loop order
     for (int i = 0; i < num_orders; i++) {
-        zero_matrix(c, n);
-        
         printf("Testing %s...\n", orders[i].name);
         
-        clock_t start = clock();
-        orders[i].func(a, b, c, n);
-        clock_t end = clock();
+        MultiplyRun run = {orders[i].func, &a, &b, &c};
+        BenchResult *result = &results[i];
+        bench_run(orders[i].name, "", run_multiply, &run, &cfg, 2.0 * n * n * n, 0.0, result);
         
-        orders[i].time = ((double)(end - start)) / CLOCKS_PER_SEC;
-        orders[i].bandwidth = calculate_bandwidth(n, orders[i].time);
+        orders[i].time = result->median;
+        orders[i].bandwidth = calculate_bandwidth(i, n, orders[i].time);
         orders[i].gflops = calculate_gflops(n, orders[i].time);
         
-        printf("  Time: %.4f s | Bandwidth: %.2f GB/s | GFLOPS: %.2f\n\n",
-               orders[i].time, orders[i].bandwidth, orders[i].gflops);
+        printf("  Time: %.4f s (stddev %.1f%%) | Bandwidth: %.2f GB/s | GFLOPS: %.2f\n\n",
+               orders[i].time, 100.0 * result->stddev / result->median,
+               orders[i].bandwidth, orders[i].gflops);
     }
     
     // Find best performer
@@ -249,26 +158,33 @@ int main(int argc, char *argv[]) {
     printf("Speedup vs ijk:  %.2fx\n", orders[0].time / orders[best_idx].time);
     printf("=================================================================\n\n");
     
-    printf("Cache Efficiency Explanation:\n");
-    printf("------------------------------\n");
-    printf("ijk order: Poor cache locality for matrix B (stride-n access)\n");
-    printf("ikj order: BEST - Sequential access to both B and C arrays\n");
-    printf("jik order: Similar to ijk, poor locality for A and B\n");
-    printf("jki order: Moderate performance\n");
-    printf("kij order: Good locality, similar to ikj\n");
-    printf("kji order: Poor locality for matrix A\n\n");
-    
-    printf("The '%s' order is optimal because:\n", orders[best_idx].name);
-    printf("1. Inner loop (j) accesses B[k][j] and C[i][j] sequentially\n");
-    printf("2. Sequential access maximizes cache line utilization\n");
-    printf("3. A[i][k] is loaded once and reused for entire row of B\n");
-    printf("4. Better spatial and temporal locality\n");
+    // Cache behaviour, measured rather than asserted
+    printf("Hardware Counters (per multiplication):\n");
+    printf("---------------------------------------\n");
+    const char *reason = "";
+    if (bench_counters_available(&reason) == 0 || !cfg.counters) {
+        printf("Unavailable: %s\n", cfg.counters ? reason : "disabled by BENCH_COUNTERS=0");
+        printf("Run on a host whose PMU is visible to perf_event_open to see IPC and miss rates.\n");
+    } else {
+        bench_print_counters_header(stdout);
+        for (int i = 0; i < num_orders; i++) {
+            bench_print_counters(stdout, orders[i].name, &results[i]);
+        }
+        
+        double best_l1d = perf_per_kflop(&results[best_idx].counters, PERF_L1D_MISSES,
+                                         results[best_idx].flops);
+        double ijk_l1d = perf_per_kflop(&results[0].counters, PERF_L1D_MISSES, results[0].flops);
+        if (best_l1d > 0 && ijk_l1d > 0) {
+            printf("\n'%s' takes %.2f L1D misses per kflop against %.2f for ijk (%.1fx fewer).\n",
+                   orders[best_idx].name, best_l1d, ijk_l1d, ijk_l1d / best_l1d);
+        }
+    }
     printf("=================================================================\n");
     
     // Free matrices
-    free_matrix(a, n);
-    free_matrix(b, n);
-    free_matrix(c, n);
+    free_matrix(&a);
+    free_matrix(&b);
+    free_matrix(&c);
     
     return EXIT_SUCCESS;
 }
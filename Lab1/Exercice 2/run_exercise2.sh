@@ -2,6 +2,10 @@
 
 RESULTS_FILE="exercise2_results.txt"
 
+# Shared matrix module (contiguous 64-byte aligned layout + kernels)
+COMMON_DIR="../../common"
+COMMON_SRC="$COMMON_DIR/matrix.c $COMMON_DIR/arena.c $COMMON_DIR/mxm_kernels.c $COMMON_DIR/tune_profile.c $COMMON_DIR/bench.c $COMMON_DIR/perf_counters.c $COMMON_DIR/cache_info.c $COMMON_DIR/roofline.c"
+
 # Function to output to both terminal and file
 output() {
     echo "$1" | tee -a "$RESULTS_FILE"
@@ -33,7 +37,7 @@ output "========================================================================
 
 # Compile standard version
 output "Compiling mxm.c (standard ijk order)..."
-gcc -O2 -o mxm mxm.c -lm 2>&1 | tee -a "$RESULTS_FILE"
+gcc -O2 -I$COMMON_DIR -o mxm mxm.c $COMMON_SRC -lm 2>&1 | tee -a "$RESULTS_FILE"
 
 if [ $? -ne 0 ]; then
     output "✗ Compilation of mxm.c failed!"
@@ -44,7 +48,7 @@ output ""
 
 # Compile optimized version
 output "Compiling mxm_optimized.c (all loop orders)..."
-gcc -O2 -o mxm_optimized mxm_optimized.c -lm 2>&1 | tee -a "$RESULTS_FILE"
+gcc -O2 -I$COMMON_DIR -o mxm_optimized mxm_optimized.c $COMMON_SRC -lm 2>&1 | tee -a "$RESULTS_FILE"
 
 if [ $? -ne 0 ]; then
     output "✗ Compilation of mxm_optimized.c failed!"
@@ -53,6 +57,17 @@ fi
 output "✓ mxm_optimized.c compiled successfully!"
 output ""
 
+# Compile layout comparison (double** vs contiguous buffer)
+output "Compiling layout_bench.c (double** vs contiguous layout)..."
+gcc -O2 -I$COMMON_DIR -o layout_bench layout_bench.c $COMMON_SRC -lm 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of layout_bench.c failed!"
+    exit 1
+fi
+output "✓ layout_bench.c compiled successfully!"
+output ""
+
 # Test matrix sizes
 MATRIX_SIZES=(256 512 1024)
 
@@ -79,6 +94,12 @@ do
     output ""
 done
 
+output "========================================================================"
+output "              LAYOUT COMPARISON (N = 256 .. 4096)"
+output "========================================================================"
+./layout_bench 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
 output "========================================================================"
 output "                         TESTING COMPLETE"
 output "========================================================================"
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "gemm.h"
+#include "arena.h"
+#include "bench.h"
+
+// Sizes where the per-call packing buffers weigh the most
+static const int default_sizes[] = {32, 64, 128, 256, 512};
+
+// Benchmark runs simulated in the arena comparison
+#define RUNS 50
+
+typedef struct {
+    Matrix *a, *b, *c;
+} GemmRun;
+
+// Benchmark callbacks
+void run_gemm(void *ctx) {
+    GemmRun *r = ctx;
+    gemm_packed(r->a, r->b, r->c, NULL);
+}
+
+void reset_c(void *ctx) {
+    zero_matrix(((GemmRun*)ctx)->c);
+}
+
+typedef struct {
+    int n;
+    Arena *arena;        // NULL: allocate_matrix / free_matrix
+} RunSetup;
+
+// One benchmark run's worth of matrices: allocate A, B, C, touch them, drop them
+void run_matrices(void *ctx) {
+    RunSetup *s = ctx;
+    Matrix m[3];
+    ArenaMark mark;
+    if (s->arena) mark = arena_mark(s->arena);
+    for (int i = 0; i < 3; i++) {
+        m[i] = s->arena ? arena_matrix(s->arena, s->n, s->n, MATRIX_PAD)
+                        : allocate_matrix(s->n, s->n, MATRIX_PAD);
+        zero_matrix(&m[i]);
+    }
+    if (s->arena) {
+        arena_release(s->arena, mark);
+    } else {
+        for (int i = 0; i < 3; i++) free_matrix(&m[i]);
+    }
+}
+
+// Function to time a callback and count the system allocations it makes per call
+double timed_allocs(const char *name, void (*fn)(void*), void *ctx, const BenchConfig *cfg,
+                    BenchResult *result) {
+    MemStats st;
+    mem_stats_reset();
+    bench_run(name, "", fn, ctx, cfg, 0.0, 0.0, result);
+    mem_stats(&st);
+    return (double)st.system_allocs / (cfg->warmup + result->reps);
+}
+
+int main(int argc, char *argv[]) {
+    int sizes[16];
+    int num_sizes = 0;
+
+    // Parse command-line arguments: [n ...]
+    for (int i = 1; i < argc && num_sizes < 16; i++) {
+        sizes[num_sizes] = atoi(argv[i]);
+        if (sizes[num_sizes] <= 0) {
+            fprintf(stderr, "Invalid matrix size: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        num_sizes++;
+    }
+    if (num_sizes == 0) {
+        num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+        memcpy(sizes, default_sizes, sizeof(default_sizes));
+    }
+
+    printf("=================================================================================\n");
+    printf("           ALLOCATION COST: malloc PER CALL vs POOL vs ARENA                     \n");
+    printf("=================================================================================\n");
+#ifdef MEM_DEBUG
+    printf("Build:               MEM_DEBUG (leak / double-free tracker with origins)\n");
+#else
+    printf("Build:               release (counters only; -DMEM_DEBUG adds origins and free checks)\n");
+#endif
+    printf("GEMM kernel:         gemm_packed (%s)\n", gemm_kernel_name());
+    printf("=================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    // 1. Packing buffers of gemm_packed: fresh from the system on every call,
+    //    or recycled by the pool (A, B, C are allocated before timing)
+    printf("gemm_packed: packing buffers per call\n");
+    printf("%6s %14s %12s %14s %12s %9s\n", "N", "malloc/call", "Time (us)", "pool: malloc", "Time (us)",
+           "Saved");
+    printf("---------------------------------------------------------------------------------\n");
+    cfg.reset = reset_c;
+    for (int si = 0; si < num_sizes; si++) {
+        int n = sizes[si];
+        Matrix A = allocate_matrix(n, n, MATRIX_PAD);
+        Matrix B = allocate_matrix(n, n, MATRIX_PAD);
+        Matrix C = allocate_matrix(n, n, MATRIX_PAD);
+        initialize_matrix(&A);
+        initialize_matrix(&B);
+        GemmRun run = {&A, &B, &C};
+
+        pool_set_enabled(0);
+        double allocs_off = timed_allocs("gemm.malloc", run_gemm, &run, &cfg, &result);
+        double t_off = result.median;
+        pool_set_enabled(1);
+        double allocs_on = timed_allocs("gemm.pool", run_gemm, &run, &cfg, &result);
+        double t_on = result.median;
+
+        printf("%6d %14.2f %12.1f %14.2f %12.1f %8.1f%%\n", n, allocs_off, t_off * 1e6, allocs_on,
+               t_on * 1e6, 100.0 * (t_off - t_on) / t_off);
+        free_matrix(&A);
+        free_matrix(&B);
+        free_matrix(&C);
+    }
+    printf("---------------------------------------------------------------------------------\n\n");
+
+    // 2. A benchmark run's matrices: three allocate_matrix / free_matrix pairs
+    //    (system or pool), or one arena released at once (chunk sized for the
+    //    run, kept between runs)
+    printf("Benchmark run (A, B, C allocated, zeroed and dropped), %d runs\n", RUNS);
+    printf("%6s %10s %10s %10s %10s %10s %10s\n", "N", "malloc", "Time (us)", "pool", "Time (us)",
+           "arena", "Time (us)");
+    printf("---------------------------------------------------------------------------------\n");
+    cfg.reset = NULL;
+    cfg.reps = RUNS;
+    for (int si = 0; si < num_sizes; si++) {
+        int n = sizes[si];
+        size_t run_bytes = 3 * (size_t)n * matrix_leading_dim(n, MATRIX_PAD) * sizeof(double);
+        RunSetup plain = {n, NULL};
+
+        pool_set_enabled(0);
+        double allocs_off = timed_allocs("run.malloc", run_matrices, &plain, &cfg, &result);
+        double t_off = result.median;
+        pool_set_enabled(1);
+        double allocs_pool = timed_allocs("run.pool", run_matrices, &plain, &cfg, &result);
+        double t_pool = result.median;
+
+        Arena arena;
+        arena_init(&arena, run_bytes);
+        RunSetup scoped = {n, &arena};
+        double allocs_arena = timed_allocs("run.arena", run_matrices, &scoped, &cfg, &result);
+        double t_arena = result.median;
+        arena_destroy(&arena);
+
+        printf("%6d %10.2f %10.1f %10.2f %10.1f %10.2f %10.1f\n", n, allocs_off, t_off * 1e6,
+               allocs_pool, t_pool * 1e6, allocs_arena, t_arena * 1e6);
+    }
+    printf("(allocations from the system per run)\n");
+    printf("=================================================================================\n");
+
+    pool_trim();
+    int leaks = mem_report_leaks();
+    printf("Leak check: %s\n", leaks == 0 ? "✓ PASSED (no live pool blocks or arena chunks)" : "✗ FAILED");
+
+    return leaks == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
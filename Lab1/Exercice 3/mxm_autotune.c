@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "autotune.h"
+#include "tune_profile.h"
+
+// Matrix sizes tuned when none are given on the command line
+static const int default_sizes[] = {256, 512, 1024, 2048};
+
+// Function to tune one matrix size and store the winners in the profile
+void tune_size(int n, TuneProfile *profile) {
+    Matrix A = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix B = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C = allocate_matrix(n, n, MATRIX_PAD);
+    initialize_matrix(&A);
+    initialize_matrix(&B);
+
+    // Untuned baselines
+    TileConfig tile_default;
+    GemmParams gemm_default;
+    tile_default_config(&tile_default);
+    gemm_default_params(&gemm_default);
+    double tiled_base = autotune_time_tiled(&A, &B, &C, &tile_default);
+    double gemm_base = autotune_time_gemm(&A, &B, &C, &gemm_default);
+
+    TuneStats stats = {0, 0, 0.0};
+    TileConfig tile;
+    GemmParams gemm;
+    double tiled_best = autotune_tiled(&A, &B, &C, &tile, &stats);
+    double gemm_best = autotune_gemm(&A, &B, &C, &gemm, &stats);
+
+    TuneEntry e;
+    memset(&e, 0, sizeof(e));
+    e.n = n;
+    e.mc = gemm.mc;
+    e.kc = gemm.kc;
+    e.nc = gemm.nc;
+    e.tile_m = tile.mc;
+    e.tile_k = tile.kc;
+    e.tile_n = tile.nc;
+    snprintf(e.order, sizeof(e.order), "%s", loop_order_name(tile.order));
+    e.unroll = tile.unroll;
+    e.gemm_gflops = gemm_best;
+    e.tiled_gflops = tiled_best;
+    tune_profile_set(profile, &e);
+
+    printf("%6d %9.2f %6d %6d | %3s U=%d %4dx%4dx%4d %6.2f -> %6.2f | %4dx%4dx%4d %6.2f -> %6.2f\n",
+           n, stats.seconds, stats.evaluations, stats.pruned,
+           e.order, e.unroll, e.tile_m, e.tile_k, e.tile_n, tiled_base, tiled_best,
+           e.mc, e.kc, e.nc, gemm_base, gemm_best);
+
+    free_matrix(&A);
+    free_matrix(&B);
+    free_matrix(&C);
+}
+
+int main(int argc, char *argv[]) {
+    int sizes[32];
+    int num_sizes = 0;
+    int reset = 0;
+
+    // Parse command-line arguments: [--reset] [n ...]
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reset") == 0) {
+            reset = 1;
+        } else if (num_sizes < 32) {
+            sizes[num_sizes] = atoi(argv[i]);
+            if (sizes[num_sizes] <= 0) {
+                fprintf(stderr, "Invalid matrix size: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            num_sizes++;
+        }
+    }
+    if (num_sizes == 0) {
+        num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+        memcpy(sizes, default_sizes, sizeof(default_sizes));
+    }
+
+    char path[768];
+    TuneProfile profile;
+    tune_profile_path(path, sizeof(path));
+    if (reset || !tune_profile_load(&profile)) {
+        memset(&profile, 0, sizeof(profile));
+        tune_cpu_name(profile.cpu, sizeof(profile.cpu));
+    }
+
+    printf("==========================================================================================\n");
+    printf("                 AUTOTUNING: TILE SHAPES, LOOP ORDERS, UNROLL FACTORS                     \n");
+    printf("==========================================================================================\n");
+    printf("CPU:          %s\n", profile.cpu);
+    printf("Profile:      %s (%d existing entries)\n", path, profile.count);
+    printf("Micro-kernel: %s\n", gemm_kernel_name());
+    printf("Search:       6 loop orders -> unroll {1,2,4,8} for orders within %.0f%% of best\n",
+           100.0 * AUTOTUNE_ORDER_CUTOFF);
+    printf("              -> coordinate descent on KC, NC, MC (patience %d)\n", AUTOTUNE_PATIENCE);
+    printf("==========================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    printf("%6s %9s %6s %6s | %-40s | %-30s\n", "N", "Tune (s)", "Evals", "Pruned",
+           "Tiled kernel: config, GFLOPS default->tuned", "Packed GEMM: MCxKCxNC, GFLOPS");
+    printf("------------------------------------------------------------------------------------------\n");
+
+    for (int i = 0; i < num_sizes; i++) {
+        tune_size(sizes[i], &profile);
+        // Save after every size so an interrupted run keeps what it found
+        if (!tune_profile_save(&profile)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("==========================================================================================\n");
+    printf("Profile written to %s\n", path);
+    printf("gemm_packed() and matrix_multiply_tiled() pick it up on their next run\n");
+    printf("(set MXM_PROFILE=off to ignore it).\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm_batch.h"
+#include "bench.h"
+
+// Products per size: A, B and C of the whole batch take about this many bytes
+// (cache resident, as in a stream of small products), and never fewer than
+// MIN_COUNT products
+#define BATCH_FOOTPRINT (4L << 20)
+#define MIN_COUNT 64
+
+// Sizes compared when none are given on the command line: the specialized
+// kernels plus two shapes that take the generic loop
+static const int default_sizes[] = {4, 6, 8, 12, 16, 32, 64};
+
+typedef struct {
+    int n, count;
+    double *A, *B, *C;
+    const double **ap, **bp;
+    double **cp;
+    Matrix *a, *b, *c;       // views for the matrix_multiply_ikj loop
+} Batch;
+
+// Benchmark callbacks
+void run_ikj_loop(void *ctx) {
+    Batch *x = ctx;
+    for (int i = 0; i < x->count; i++) {
+        matrix_multiply_ikj(&x->a[i], &x->b[i], &x->c[i]);
+    }
+}
+
+void run_strided(void *ctx) {
+    Batch *x = ctx;
+    GemmBatchShape s = {x->n, x->n, x->n, x->n, x->n, x->n};
+    long stride = (long)x->n * x->n;
+    gemm_batch_strided(&s, x->A, stride, x->B, stride, x->C, stride, x->count);
+}
+
+void run_pointers(void *ctx) {
+    Batch *x = ctx;
+    GemmBatchShape s = {x->n, x->n, x->n, x->n, x->n, x->n};
+    gemm_batch_pointers(&s, x->ap, x->bp, x->cp, x->count);
+}
+
+// C += A*B kernels start every run from C = 0
+void reset_c(void *ctx) {
+    Batch *x = ctx;
+    memset(x->C, 0, (size_t)x->count * x->n * x->n * sizeof(double));
+}
+
+// Function to allocate a batch of count n x n products, stored back to back
+void batch_alloc(Batch *x, int n, int count) {
+    size_t len = (size_t)count * n * n;
+    x->n = n;
+    x->count = count;
+    x->A = malloc(len * sizeof(double));
+    x->B = malloc(len * sizeof(double));
+    x->C = malloc(len * sizeof(double));
+    x->ap = malloc(count * sizeof(double*));
+    x->bp = malloc(count * sizeof(double*));
+    x->cp = malloc(count * sizeof(double*));
+    x->a = malloc(count * sizeof(Matrix));
+    x->b = malloc(count * sizeof(Matrix));
+    x->c = malloc(count * sizeof(Matrix));
+    if (!x->A || !x->B || !x->C || !x->ap || !x->bp || !x->cp || !x->a || !x->b || !x->c) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < len; i++) {
+        x->A[i] = (double)rand() / RAND_MAX * 9.9;
+        x->B[i] = (double)rand() / RAND_MAX * 9.9;
+    }
+    // Pointer batch in reverse order, to show it does not rely on the layout
+    for (int i = 0; i < count; i++) {
+        size_t off = (size_t)i * n * n;
+        int r = count - 1 - i;
+        x->ap[r] = x->A + off;
+        x->bp[r] = x->B + off;
+        x->cp[r] = x->C + off;
+        x->a[i] = (Matrix){x->A + off, n, n, n, 0};
+        x->b[i] = (Matrix){x->B + off, n, n, n, 0};
+        x->c[i] = (Matrix){x->C + off, n, n, n, 0};
+    }
+}
+
+void batch_free(Batch *x) {
+    free(x->A);
+    free(x->B);
+    free(x->C);
+    free(x->ap);
+    free(x->bp);
+    free(x->cp);
+    free(x->a);
+    free(x->b);
+    free(x->c);
+}
+
+// Function to find the largest |C - ref| over the whole batch
+double batch_max_error(const double *C, const double *ref, size_t len) {
+    double err = 0.0;
+    for (size_t i = 0; i < len; i++) {
+        double d = C[i] > ref[i] ? C[i] - ref[i] : ref[i] - C[i];
+        if (d > err) err = d;
+    }
+    return err;
+}
+
+int main(int argc, char *argv[]) {
+    int sizes[16];
+    int num_sizes = 0;
+    int fixed_count = 0;
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+
+    // Parse command-line arguments: [--count=C] [n ...]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--count=", 8) == 0) {
+            fixed_count = atoi(argv[i] + 8);
+            if (fixed_count <= 0) {
+                fprintf(stderr, "Invalid batch count\n");
+                return EXIT_FAILURE;
+            }
+        } else if (num_sizes < 16) {
+            sizes[num_sizes] = atoi(argv[i]);
+            if (sizes[num_sizes] <= 0) {
+                fprintf(stderr, "Invalid matrix size: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            num_sizes++;
+        }
+    }
+    if (num_sizes == 0) {
+        num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+        memcpy(sizes, default_sizes, sizeof(default_sizes));
+    }
+
+    printf("=================================================================================\n");
+    printf("         BATCHED SMALL GEMM vs A LOOP OF matrix_multiply_ikj                     \n");
+    printf("=================================================================================\n");
+    printf("Products per size:   %s\n", fixed_count ? "fixed by --count" : "4 MB of A, B and C (at least 64)");
+    printf("Interleaving:        %d products per AVX2 vector, specialized up to %d\n",
+           GEMM_BATCH_LANES, GEMM_BATCH_MAX_DIM);
+    printf("Threads:             1 and %d\n", max_threads);
+    printf("=================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+    cfg.reset = reset_c;
+
+    printf("%5s %7s %-26s %10s %10s %10s %10s %9s %9s\n", "N", "Count", "Kernel",
+           "ikj (ms)", "Batch T=1", "Batch T=max", "Pointers", "Speedup", "Max error");
+    printf("----------------------------------------------------------------------------------------------------------\n");
+
+    int all_passed = 1;
+    for (int si = 0; si < num_sizes; si++) {
+        int n = sizes[si];
+        long bytes = 3L * n * n * sizeof(double);
+        int count = fixed_count ? fixed_count
+                                : (int)(BATCH_FOOTPRINT / bytes > MIN_COUNT ? BATCH_FOOTPRINT / bytes : MIN_COUNT);
+        size_t len = (size_t)count * n * n;
+        double flops = 2.0 * n * n * n * count;
+
+        Batch x;
+        batch_alloc(&x, n, count);
+        double *ref = malloc(len * sizeof(double));
+        if (!ref) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return EXIT_FAILURE;
+        }
+
+        // Baseline: one matrix_multiply_ikj call per product, one thread
+        bench_run("ikj", "", run_ikj_loop, &x, &cfg, flops, 0.0, &result);
+        double t_ikj = result.median;
+        memcpy(ref, x.C, len * sizeof(double));
+
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        bench_run("batch", "", run_strided, &x, &cfg, flops, 0.0, &result);
+        double t_one = result.median;
+        double err = batch_max_error(x.C, ref, len);
+
+#ifdef _OPENMP
+        omp_set_num_threads(max_threads);
+#endif
+        bench_run("batch", "", run_strided, &x, &cfg, flops, 0.0, &result);
+        double t_max = result.median;
+        double gflops = bench_gflops(&result);
+        double e = batch_max_error(x.C, ref, len);
+        if (e > err) err = e;
+
+        bench_run("pointers", "", run_pointers, &x, &cfg, flops, 0.0, &result);
+        double t_ptr = result.median;
+        e = batch_max_error(x.C, ref, len);
+        if (e > err) err = e;
+
+        // FMA rounds once per product term, ikj twice: compare with a tolerance
+        int ok = err < 1e-9 * n * 100.0;
+        all_passed &= ok;
+
+        char kernel[64];
+        GemmBatchShape s = {n, n, n, n, n, n};
+        printf("%5d %7d %-26s %10.3f %10.3f %10.3f %10.3f %8.2fx %9.1e %s\n", n, count,
+               gemm_batch_kernel_name(&s, kernel, sizeof(kernel)), t_ikj * 1000.0, t_one * 1000.0,
+               t_max * 1000.0, t_ptr * 1000.0, t_ikj / (t_one < t_max ? t_one : t_max), err,
+               ok ? "✓" : "✗");
+        printf("%5s %7s %-26s %10s %10s %10.2f GFLOPS\n", "", "", "", "", "", gflops);
+
+        free(ref);
+        batch_free(&x);
+    }
+    printf("=================================================================================\n");
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (batched products match the ikj loop)" : "✗ FAILED");
+
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -4,126 +4,68 @@
 #include <string.h>
 #include <math.h>
 
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "bench.h"
+#include "cache_info.h"
+#include "roofline.h"
+
 // Matrix size (default)
 #ifndef N
 #define N 1024
 #endif
 
-// Function to allocate a matrix
-double** allocate_matrix(int n) {
-    double **matrix = (double**)malloc(n * sizeof(double*));
-    if (!matrix) {
-        fprintf(stderr, "Memory allocation failed\n");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i < n; i++) {
-        matrix[i] = (double*)malloc(n * sizeof(double));
-        if (!matrix[i]) {
-            fprintf(stderr, "Memory allocation failed\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-    return matrix;
-}
+// Best HPL result on the same i7-1255U (hpl_results.csv, Lab1/Exercice 5)
+#define HPL_PEAK_GFLOPS 52.84
 
-// Function to free a matrix
-void free_matrix(double **matrix, int n) {
-    if (!matrix) return;
-    for (int i = 0; i < n; i++) {
-        free(matrix[i]);
-    }
-    free(matrix);
-}
+// Fraction of the HPL peak the packed GEMM engine is expected to reach
+#define GEMM_TARGET_FRACTION 0.70
 
-// Function to initialize a matrix with random values
-void initialize_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (double)(rand() % 100) / 10.0;
-        }
-    }
-}
+typedef struct {
+    void (*func)(const Matrix*, const Matrix*, Matrix*, int);
+    const Matrix *A, *B;
+    Matrix *C;
+    int block_size;
+    const GemmParams *params;
+} BlockRun;
 
-// Function to initialize a matrix to zero
-void zero_matrix(double **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = 0.0;
-        }
-    }
+// Function to run one blocked product (benchmark callback)
+void run_block(void *ctx) {
+    BlockRun *r = ctx;
+    r->func(r->A, r->B, r->C, r->block_size);
 }
 
-// Standard matrix multiplication (for verification)
-void matrix_multiply_standard(double **A, double **B, double **C, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            C[i][j] = 0.0;
-            for (int k = 0; k < n; k++) {
-                C[i][j] += A[i][k] * B[k][j];
-            }
-        }
-    }
+// Function to run one packed GEMM (benchmark callback)
+void run_gemm(void *ctx) {
+    BlockRun *r = ctx;
+    gemm_packed(r->A, r->B, r->C, r->params);
 }
 
-// Block matrix multiplication
-void matrix_multiply_block(double **A, double **B, double **C, int n, int block_size) {
-    // Initialize result matrix to zero
-    zero_matrix(C, n);
-    
-    // Iterate over blocks
-    for (int i0 = 0; i0 < n; i0 += block_size) {
-        for (int j0 = 0; j0 < n; j0 += block_size) {
-            for (int k0 = 0; k0 < n; k0 += block_size) {
-                
-                // Multiply blocks
-                // Process elements within the current block
-                for (int i = i0; i < i0 + block_size && i < n; i++) {
-                    for (int j = j0; j < j0 + block_size && j < n; j++) {
-                        double sum = C[i][j];
-                        for (int k = k0; k < k0 + block_size && k < n; k++) {
-                            sum += A[i][k] * B[k][j];
-                        }
-                        C[i][j] = sum;
-                    }
-                }
-            }
-        }
-    }
+// Function to clear C before each GEMM run, since gemm_packed accumulates
+void reset_c(void *ctx) {
+    zero_matrix(((BlockRun*)ctx)->C);
 }
 
-// Function to verify if two matrices are equal (within tolerance)
-int verify_matrices(double **C1, double **C2, int n) {
-    double tolerance = 1e-6;
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (fabs(C1[i][j] - C2[i][j]) > tolerance) {
-                printf("Mismatch at [%d][%d]: %f vs %f\n", i, j, C1[i][j], C2[i][j]);
-                return 0;
-            }
-        }
-    }
-    return 1;
+// Function to measure execution time (wall clock, median over repetitions)
+double measure_time(void (*func)(const Matrix*, const Matrix*, Matrix*, int),
+                   const Matrix *A, const Matrix *B, Matrix *C, int block_size,
+                   BenchResult *result) {
+    BlockRun run = {func, A, B, C, block_size, NULL};
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+    bench_run("block", "", run_block, &run, &cfg, 2.0 * C->rows * C->cols * A->cols, 0.0, result);
+    return result->median;
 }
 
-// Function to measure execution time
-double measure_time(void (*func)(double**, double**, double**, int, int),
-                   double **A, double **B, double **C, int n, int block_size) {
-    clock_t start, end;
-    start = clock();
-    func(A, B, C, n, block_size);
-    end = clock();
-    return ((double)(end - start)) / CLOCKS_PER_SEC;
-}
-
-// Function to calculate memory bandwidth
-double calculate_bandwidth(int n, double time_sec) {
-    // Number of floating-point operations: 2*n^3 (n^3 multiplications + n^3 additions)
-    // Memory accesses: reading A (n^3), reading B (n^3), reading+writing C (2*n^3)
-    // Total memory accesses: 4*n^3 * sizeof(double)
-    double memory_accessed = 4.0 * n * n * n * sizeof(double);
-    double bandwidth_bytes_per_sec = memory_accessed / time_sec;
-    double bandwidth_gb_per_sec = bandwidth_bytes_per_sec / (1024.0 * 1024.0 * 1024.0);
-    return bandwidth_gb_per_sec;
+// Function to calculate memory bandwidth from the modelled traffic of b x b
+// blocking between the level holding the matrices and the cache above it
+// (A and B tiles once per tile step, C once per tile: 16n^3/b + 16n^2 bytes)
+double calculate_bandwidth(int n, int block_size, double time_sec) {
+    CacheInfo caches;
+    cache_info_detect(&caches);
+    double memory_accessed = roofline_traffic_blocked(&caches, n, block_size);
+    return memory_accessed / time_sec / 1e9;
 }
 
 // Function to calculate GFLOPS
@@ -136,17 +78,56 @@ double calculate_gflops(int n, double time_sec) {
 
 // Function to print performance results
 void print_results(int n, int block_size, double time_sec) {
-    double bandwidth = calculate_bandwidth(n, time_sec);
+    double bandwidth = calculate_bandwidth(n, block_size, time_sec);
     double gflops = calculate_gflops(n, time_sec);
     
     printf("Block Size: %4d | Time: %8.4f s | Bandwidth: %8.2f GB/s | GFLOPS: %8.2f\n",
            block_size, time_sec, bandwidth, gflops);
 }
 
+// Function to time the packed GEMM engine and compare it with the HPL peak
+void run_packed_gemm(const Matrix *A, const Matrix *B, Matrix *C, const Matrix *C_ref,
+                     int n, double block_time, BenchResult *result) {
+    printf("=================================================================\n");
+    printf("              PACKED GEMM ENGINE (BLIS-style)                    \n");
+    printf("=================================================================\n");
+    printf("Micro-kernel:        %s (%dx%d register tile)\n",
+           gemm_kernel_name(), GEMM_MR, GEMM_NR);
+    GemmParams params;
+    int tuned = gemm_tuned_params(n, &params);
+    printf("Blocking:            MC=%d KC=%d NC=%d (%s)\n", params.mc, params.kc, params.nc,
+           tuned ? "autotuned profile" : "defaults, run mxm_autotune to tune");
+
+    BlockRun run = {NULL, A, B, C, 0, &params};
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+    cfg.reset = reset_c;
+    bench_run("gemm", "", run_gemm, &run, &cfg, 2.0 * n * n * n, 0.0, result);
+    double time_sec = result->median;
+    double gflops = calculate_gflops(n, time_sec);
+
+    if (verify_matrices(C, C_ref)) {
+        printf("Verification:        ✓ PASSED (vs matrix_multiply_standard)\n");
+    } else {
+        printf("Verification:        ✗ FAILED (vs matrix_multiply_standard)\n");
+    }
+    printf("Time:                %.4f seconds (median of %d, min %.4f)\n",
+           time_sec, result->reps, result->min);
+    printf("Performance:         %.2f GFLOPS\n", gflops);
+    printf("Speedup vs block:    %.2fx\n", block_time / time_sec);
+    printf("HPL peak:            %.2f GFLOPS -> %.1f%% reached\n",
+           HPL_PEAK_GFLOPS, 100.0 * gflops / HPL_PEAK_GFLOPS);
+    printf("Target (%.0f%% of HPL): %s\n", 100.0 * GEMM_TARGET_FRACTION,
+           gflops >= GEMM_TARGET_FRACTION * HPL_PEAK_GFLOPS ? "MET" : "NOT MET");
+    printf("=================================================================\n\n");
+}
+
 int main(int argc, char *argv[]) {
     int n = N;
     int block_sizes[] = {8, 16, 32, 64, 128, 256};
     int num_block_sizes = sizeof(block_sizes) / sizeof(block_sizes[0]);
+    BenchResult block_results[sizeof(block_sizes) / sizeof(block_sizes[0])];
+    BenchResult gemm_result;
     
     // Parse command-line arguments
     if (argc > 1) {
@@ -161,6 +142,9 @@ int main(int argc, char *argv[]) {
     printf("         BLOCK MATRIX MULTIPLICATION PERFORMANCE ANALYSIS        \n");
     printf("=================================================================\n");
     printf("Matrix size: %d x %d\n", n, n);
+    BenchConfig timing;
+    bench_default_config(&timing);
+    printf("Timing:      wall clock, %d warmup + median of %d runs\n", timing.warmup, timing.reps);
     printf("=================================================================\n\n");
     
     // Seed random number generator
@@ -168,15 +152,15 @@ int main(int argc, char *argv[]) {
     
     // Allocate matrices
     printf("Allocating matrices...\n");
-    double **A = allocate_matrix(n);
-    double **B = allocate_matrix(n);
-    double **C = allocate_matrix(n);
-    double **C_verify = allocate_matrix(n);
+    Matrix A = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix B = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C_verify = allocate_matrix(n, n, MATRIX_PAD);
     
     // Initialize matrices
     printf("Initializing matrices...\n");
-    initialize_matrix(A, n);
-    initialize_matrix(B, n);
+    initialize_matrix(&A);
+    initialize_matrix(&B);
     
     printf("\n=================================================================\n");
     printf("                    PERFORMANCE RESULTS                          \n");
@@ -187,6 +171,7 @@ int main(int argc, char *argv[]) {
     int best_block_size = 0;
     double best_bandwidth = 0.0;
     double best_gflops = 0.0;
+    int have_reference = 0;
     
     // Test different block sizes
     for (int i = 0; i < num_block_sizes; i++) {
@@ -199,8 +184,9 @@ int main(int argc, char *argv[]) {
         }
         
         // Measure time for block multiplication
-        zero_matrix(C, n);
-        double time_sec = measure_time(matrix_multiply_block, A, B, C, n, block_size);
+        zero_matrix(&C);
+        double time_sec = measure_time(matrix_multiply_block, &A, &B, &C, block_size,
+                                       &block_results[i]);
         
         // Print results
         print_results(n, block_size, time_sec);
@@ -209,15 +195,16 @@ int main(int argc, char *argv[]) {
         if (time_sec < best_time) {
             best_time = time_sec;
             best_block_size = block_size;
-            best_bandwidth = calculate_bandwidth(n, time_sec);
+            best_bandwidth = calculate_bandwidth(n, block_size, time_sec);
             best_gflops = calculate_gflops(n, time_sec);
         }
         
         // Verify correctness for first iteration only
         if (i == 0) {
             printf("\nVerifying correctness...\n");
-            matrix_multiply_standard(A, B, C_verify, n);
-            if (verify_matrices(C, C_verify, n)) {
+            matrix_multiply_standard(&A, &B, &C_verify);
+            have_reference = 1;
+            if (verify_matrices(&C, &C_verify)) {
                 printf("✓ Verification PASSED: Block multiplication is correct\n\n");
             } else {
                 printf("✗ Verification FAILED: Results do not match\n\n");
@@ -236,37 +223,42 @@ int main(int argc, char *argv[]) {
     printf("Best Performance:    %.2f GFLOPS\n", best_gflops);
     printf("=================================================================\n\n");
     
+    // Compare the scalar tiles with the packed, register-blocked engine
+    if (!have_reference) {
+        matrix_multiply_standard(&A, &B, &C_verify);
+    }
+    run_packed_gemm(&A, &B, &C, &C_verify, n, best_time, &gemm_result);
+    
     // Analysis explanation
     printf("=================================================================\n");
     printf("                    PERFORMANCE ANALYSIS                         \n");
     printf("=================================================================\n");
-    printf("Why Block Size %d is Optimal:\n\n", best_block_size);
-    printf("1. Cache Utilization:\n");
-    printf("   - Block size %d fits well in L1/L2 cache\n", best_block_size);
-    printf("   - Memory required per block: %.2f KB\n", 
-           (3.0 * best_block_size * best_block_size * sizeof(double)) / 1024.0);
-    printf("   - Reduces cache misses by reusing data in cache\n\n");
+    printf("Block Size %d: three tiles take %.2f KB (L1D is typically 32-48 KB)\n\n",
+           best_block_size, (3.0 * best_block_size * best_block_size * sizeof(double)) / 1024.0);
     
-    printf("2. Memory Access Pattern:\n");
-    printf("   - Block multiplication accesses memory in contiguous chunks\n");
-    printf("   - Better spatial locality improves cache hit rate\n");
-    printf("   - Reduces main memory accesses\n\n");
-    
-    printf("3. TLB (Translation Lookaside Buffer) Efficiency:\n");
-    printf("   - Smaller working set reduces TLB misses\n");
-    printf("   - Improves virtual-to-physical address translation\n\n");
-    
-    printf("4. Trade-offs:\n");
-    printf("   - Too small: High loop overhead, poor cache utilization\n");
-    printf("   - Too large: Exceeds cache capacity, causes thrashing\n");
-    printf("   - Optimal: Balances cache usage and loop overhead\n");
+    // Measured cache, TLB and pipeline behaviour of every variant
+    const char *reason = "";
+    if (bench_counters_available(&reason) == 0 || !timing.counters) {
+        printf("Hardware counters unavailable: %s\n",
+               timing.counters ? reason : "disabled by BENCH_COUNTERS=0");
+        printf("Run on a host whose PMU is visible to perf_event_open to see IPC and miss rates.\n");
+    } else {
+        bench_print_counters_header(stdout);
+        for (int i = 0; i < num_block_sizes; i++) {
+            if (block_sizes[i] > n) continue;
+            char label[32];
+            snprintf(label, sizeof(label), "block %d", block_sizes[i]);
+            bench_print_counters(stdout, label, &block_results[i]);
+        }
+        bench_print_counters(stdout, "packed GEMM", &gemm_result);
+    }
     printf("=================================================================\n");
     
     // Free matrices
-    free_matrix(A, n);
-    free_matrix(B, n);
-    free_matrix(C, n);
-    free_matrix(C_verify, n);
+    free_matrix(&A);
+    free_matrix(&B);
+    free_matrix(&C);
+    free_matrix(&C_verify);
     
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "gemm_mixed.h"
+#include "bench.h"
+
+// Matrix size (default)
+#ifndef N
+#define N 1024
+#endif
+
+typedef enum { KERNEL_IKJ, KERNEL_GEMM } KernelId;
+
+// One problem, held in every precision
+typedef struct {
+    int n;
+    Matrix A, B, C;
+    MatrixF32 A32, B32, C32;
+    MatrixBF16 A16, B16;
+    GemmType type;
+    KernelId kernel;
+} MixedRun;
+
+// Benchmark callbacks
+void run_product(void *ctx) {
+    MixedRun *r = ctx;
+    switch (r->type) {
+        case GEMM_FP64:
+            if (r->kernel == KERNEL_IKJ) matrix_multiply_ikj(&r->A, &r->B, &r->C);
+            else gemm_packed(&r->A, &r->B, &r->C, NULL);
+            break;
+        case GEMM_FP32:
+            if (r->kernel == KERNEL_IKJ) matrix_multiply_ikj_f32(&r->A32, &r->B32, &r->C32);
+            else gemm_packed_f32(&r->A32, &r->B32, &r->C32, NULL);
+            break;
+        case GEMM_BF16:
+            if (r->kernel == KERNEL_IKJ) matrix_multiply_ikj_bf16(&r->A16, &r->B16, &r->C32);
+            else gemm_packed_bf16(&r->A16, &r->B16, &r->C32, NULL);
+            break;
+    }
+}
+
+// Every kernel accumulates into C
+void reset_c(void *ctx) {
+    MixedRun *r = ctx;
+    if (r->type == GEMM_FP64) zero_matrix(&r->C);
+    else zero_matrix_f32(&r->C32);
+}
+
+// Bytes of A and B in a storage type
+double operand_mb(GemmType t, int n) {
+    size_t elem = t == GEMM_FP64 ? sizeof(double) : (t == GEMM_FP32 ? sizeof(float) : sizeof(bf16));
+    return 2.0 * n * n * elem / (1024.0 * 1024.0);
+}
+
+int main(int argc, char *argv[]) {
+    int n = N;
+
+    // Parse command-line arguments
+    if (argc > 1) {
+        n = atoi(argv[1]);
+        if (n <= 0) {
+            fprintf(stderr, "Invalid matrix size\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("================================================================================================\n");
+    printf("          MIXED PRECISION: fp64 vs fp32 vs bf16 storage with fp32 accumulation                  \n");
+    printf("================================================================================================\n");
+    printf("Matrix size:         %d x %d\n", n, n);
+    printf("Micro-kernels:       fp64 %s %dx%d, float %s %dx%d\n", gemm_kernel_name(), GEMM_MR, GEMM_NR,
+           gemm_mixed_kernel_name(), GEMM_F32_MR, GEMM_F32_NR);
+    printf("Reference:           fp64 packed GEMM, relative error per element\n");
+    printf("================================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    MixedRun r;
+    r.n = n;
+    r.A = allocate_matrix(n, n, MATRIX_PAD);
+    r.B = allocate_matrix(n, n, MATRIX_PAD);
+    r.C = allocate_matrix(n, n, MATRIX_PAD);
+    r.A32 = allocate_matrix_f32(n, n, MATRIX_PAD);
+    r.B32 = allocate_matrix_f32(n, n, MATRIX_PAD);
+    r.C32 = allocate_matrix_f32(n, n, MATRIX_PAD);
+    r.A16 = allocate_matrix_bf16(n, n, MATRIX_PAD);
+    r.B16 = allocate_matrix_bf16(n, n, MATRIX_PAD);
+    Matrix C_ref = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C_low = allocate_matrix(n, n, MATRIX_PAD);
+
+    initialize_matrix(&r.A);
+    initialize_matrix(&r.B);
+    matrix_to_f32(&r.A, &r.A32);
+    matrix_to_f32(&r.B, &r.B32);
+    matrix_to_bf16(&r.A, &r.A16);
+    matrix_to_bf16(&r.B, &r.B16);
+
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+    cfg.reset = reset_c;
+    const double flops = 2.0 * n * n * n;
+
+    // fp64 reference
+    r.type = GEMM_FP64;
+    r.kernel = KERNEL_GEMM;
+    zero_matrix(&C_ref);
+    gemm_packed(&r.A, &r.B, &C_ref, NULL);
+
+    printf("%-6s %-11s %10s %10s %9s %10s %11s %11s %7s\n", "Kernel", "Precision", "Time (s)",
+           "GFLOPS", "vs fp64", "A+B (MB)", "Max rel err", "Tolerance", "Verify");
+    printf("------------------------------------------------------------------------------------------------\n");
+
+    const GemmType types[] = {GEMM_FP64, GEMM_FP32, GEMM_BF16};
+    const KernelId kernels[] = {KERNEL_IKJ, KERNEL_GEMM};
+    const char *kernel_names[] = {"ikj", "packed"};
+    int all_passed = 1;
+
+    for (int ki = 0; ki < 2; ki++) {
+        double t_fp64 = 0.0;
+        for (int ti = 0; ti < 3; ti++) {
+            r.type = types[ti];
+            r.kernel = kernels[ki];
+            bench_run(kernel_names[ki], gemm_type_name(r.type), run_product, &r, &cfg, flops, 0.0, &result);
+            if (r.type == GEMM_FP64) t_fp64 = result.median;
+
+            // Low-precision results are widened back to fp64 for the check
+            const Matrix *C = &r.C;
+            if (r.type != GEMM_FP64) {
+                matrix_from_f32(&r.C32, &C_low);
+                C = &C_low;
+            }
+            double tol = gemm_type_tolerance(r.type, n);
+            int ok = verify_matrices_rel(C, &C_ref, tol);
+            all_passed &= ok;
+
+            printf("%-6s %-11s %10.4f %10.2f %8.2fx %10.1f %11.3e %11.3e %7s\n", kernel_names[ki],
+                   gemm_type_name(r.type), result.median, bench_gflops(&result), t_fp64 / result.median,
+                   operand_mb(r.type, n), matrix_max_rel_error(C, &C_ref), tol, ok ? "✓" : "✗");
+        }
+        printf("------------------------------------------------------------------------------------------------\n");
+    }
+    printf("Tolerance: 2 u(storage) + (k + 1) u(accumulator), k = %d, inputs all of one sign\n", n);
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (verify_matrices_rel against fp64)" : "✗ FAILED");
+
+    free_matrix(&r.A);
+    free_matrix(&r.B);
+    free_matrix(&r.C);
+    free_matrix_f32(&r.A32);
+    free_matrix_f32(&r.B32);
+    free_matrix_f32(&r.C32);
+    free_matrix_bf16(&r.A16);
+    free_matrix_bf16(&r.B16);
+    free_matrix(&C_ref);
+    free_matrix(&C_low);
+
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
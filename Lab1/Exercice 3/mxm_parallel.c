@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "affinity.h"
+#include "bench.h"
+
+// Matrix size (default)
+#ifndef N
+#define N 1024
+#endif
+
+// i7-1255U: 2 P-cores x 2 hyperthreads + 8 E-cores
+#ifndef MAX_THREADS
+#define MAX_THREADS 12
+#endif
+
+// Tile size used for the parallel block multiplication (best serial size in Exercice 3)
+#define BLOCK_SIZE 32
+
+typedef enum { KERNEL_IKJ, KERNEL_BLOCK, KERNEL_GEMM } KernelId;
+
+typedef struct {
+    const char *name;
+    KernelId id;
+    double time[MAX_THREADS + 1];
+} ParallelKernel;
+
+// Function to calculate GFLOPS
+double calculate_gflops(int n, double time_sec) {
+    double operations = 2.0 * n * n * n;
+    double gflops = (operations / time_sec) / 1e9;
+    return gflops;
+}
+
+typedef struct {
+    KernelId id;
+    const Matrix *A, *B;
+    Matrix *C;
+} KernelRun;
+
+// Function to run one kernel (benchmark callback)
+void run_kernel(void *ctx) {
+    KernelRun *r = ctx;
+    switch (r->id) {
+        case KERNEL_IKJ:
+            matrix_multiply_ikj_parallel(r->A, r->B, r->C);
+            break;
+        case KERNEL_BLOCK:
+            matrix_multiply_block_parallel(r->A, r->B, r->C, BLOCK_SIZE);
+            break;
+        case KERNEL_GEMM:
+            gemm_packed(r->A, r->B, r->C, NULL);
+            break;
+    }
+}
+
+// Function to clear C before each run, since the kernels accumulate into it
+void reset_c(void *ctx) {
+    zero_matrix(((KernelRun*)ctx)->C);
+}
+
+int main(int argc, char *argv[]) {
+    int n = N;
+    int max_threads = MAX_THREADS;
+    AffinityMode mode = AFFINITY_COMPACT;
+
+    // Parse command-line arguments: [n] [--threads=T] [--affinity=none|compact|scatter]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            max_threads = atoi(argv[i] + 10);
+            if (max_threads <= 0 || max_threads > MAX_THREADS) {
+                fprintf(stderr, "Thread count must be in 1..%d\n", MAX_THREADS);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--affinity=", 11) == 0) {
+            int m = affinity_parse_mode(argv[i] + 11);
+            if (m < 0) {
+                fprintf(stderr, "Unknown affinity mode: %s\n", argv[i] + 11);
+                return EXIT_FAILURE;
+            }
+            mode = (AffinityMode)m;
+        } else {
+            n = atoi(argv[i]);
+            if (n <= 0) {
+                fprintf(stderr, "Invalid matrix size\n");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    CpuTopology topo;
+    affinity_detect(&topo, mode);
+
+    // The warmup runs absorb page faults and the start of each new thread team
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+    cfg.reset = reset_c;
+    cfg.counters = 0;
+
+    printf("=================================================================\n");
+    printf("        MULTITHREADED MATRIX MULTIPLICATION - STRONG SCALING     \n");
+    printf("=================================================================\n");
+    printf("Matrix size:         %d x %d\n", n, n);
+    printf("Threads:             1..%d\n", max_threads);
+    printf("Affinity:            %s\n", affinity_mode_name(mode));
+    printf("Timing:              median of %d runs after %d warmup per thread count\n", cfg.reps, cfg.warmup);
+    affinity_print(&topo);
+    printf("=================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    Matrix A = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix B = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C_ref = allocate_matrix(n, n, MATRIX_PAD);
+    initialize_matrix(&A);
+    initialize_matrix(&B);
+
+    // Serial ikj as reference for every parallel result
+    zero_matrix(&C_ref);
+    matrix_multiply_ikj(&A, &B, &C_ref);
+
+    ParallelKernel kernels[] = {
+        {"ikj (parallel rows)", KERNEL_IKJ, {0}},
+        {"block (parallel tiles)", KERNEL_BLOCK, {0}},
+        {"packed GEMM", KERNEL_GEMM, {0}}
+    };
+    int num_kernels = sizeof(kernels) / sizeof(kernels[0]);
+    int all_passed = 1;
+
+    for (int t = 1; t <= max_threads; t++) {
+        omp_set_num_threads(t);
+        affinity_pin_threads(&topo, mode);
+
+        for (int k = 0; k < num_kernels; k++) {
+            KernelRun run = {kernels[k].id, &A, &B, &C};
+            BenchResult result;
+            bench_run(kernels[k].name, "", run_kernel, &run, &cfg, 2.0 * n * n * n, 0.0, &result);
+            kernels[k].time[t] = result.median;
+            if (!verify_matrices(&C, &C_ref)) {
+                printf("✗ %s with %d threads does not match the serial result\n",
+                       kernels[k].name, t);
+                all_passed = 0;
+            }
+        }
+        printf("Threads %2d done\n", t);
+    }
+    printf("\nVerification: %s\n\n", all_passed ? "✓ PASSED (all thread counts)" : "✗ FAILED");
+
+    for (int k = 0; k < num_kernels; k++) {
+        printf("=================================================================\n");
+        printf("  %s\n", kernels[k].name);
+        printf("=================================================================\n");
+        printf("%8s %7s %12s %10s %10s %11s\n",
+               "Threads", "E-cores", "Time (s)", "GFLOPS", "Speedup", "Efficiency");
+        printf("-----------------------------------------------------------------\n");
+        for (int t = 1; t <= max_threads; t++) {
+            int ecores = 0;
+            if (mode != AFFINITY_NONE) {
+                for (int i = 0; i < t; i++) {
+                    ecores += affinity_is_ecore(topo.order[i % topo.order_len]);
+                }
+            }
+            double speedup = kernels[k].time[1] / kernels[k].time[t];
+            printf("%8d %7d %12.4f %10.2f %9.2fx %10.1f%%\n",
+                   t, ecores, kernels[k].time[t], calculate_gflops(n, kernels[k].time[t]),
+                   speedup, 100.0 * speedup / t);
+        }
+        printf("=================================================================\n\n");
+    }
+
+    free_matrix(&A);
+    free_matrix(&B);
+    free_matrix(&C);
+    free_matrix(&C_ref);
+
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
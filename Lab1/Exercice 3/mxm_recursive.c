@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm_recursive.h"
+#include "ws_sched.h"
+#include "bench.h"
+
+// Fixed tile used by the blocked baselines (best serial size in Exercice 3)
+#define BLOCK_SIZE 32
+
+typedef struct {
+    int m;
+    int n;
+    int k;
+    const char *label;
+} Shape;
+
+// Function to calculate GFLOPS for an (m x k) * (k x n) product
+double calculate_gflops(int m, int n, int k, double time_sec) {
+    double operations = 2.0 * m * n * k;
+    return (operations / time_sec) / 1e9;
+}
+
+// Fixed-tile blocking with an OpenMP static split of the tile rows
+void matrix_multiply_block_static(const Matrix *A, const Matrix *B, Matrix *C, int block_size) {
+    const int m = C->rows, n = C->cols, p = A->cols;
+
+    zero_matrix(C);
+
+    #pragma omp parallel for schedule(static)
+    for (int i0 = 0; i0 < m; i0 += block_size) {
+        int ib = (i0 + block_size < m) ? block_size : m - i0;
+        for (int j0 = 0; j0 < n; j0 += block_size) {
+            int jb = (j0 + block_size < n) ? block_size : n - j0;
+            Matrix c_tile = matrix_view(C, i0, j0, ib, jb);
+            for (int k0 = 0; k0 < p; k0 += block_size) {
+                int kb = (k0 + block_size < p) ? block_size : p - k0;
+                Matrix a_tile = matrix_view(A, i0, k0, ib, kb);
+                Matrix b_tile = matrix_view(B, k0, j0, kb, jb);
+                matrix_multiply_ijk(&a_tile, &b_tile, &c_tile);
+            }
+        }
+    }
+}
+
+// Function to compare the three strategies on one shape
+int run_shape(const Shape *s, WsScheduler *sched, int threads) {
+    Matrix A = allocate_matrix(s->m, s->k, MATRIX_PAD);
+    Matrix B = allocate_matrix(s->k, s->n, MATRIX_PAD);
+    Matrix C = allocate_matrix(s->m, s->n, MATRIX_PAD);
+    Matrix C_ref = allocate_matrix(s->m, s->n, MATRIX_PAD);
+    initialize_matrix(&A);
+    initialize_matrix(&B);
+
+    zero_matrix(&C_ref);
+    matrix_multiply_ikj(&A, &B, &C_ref);
+
+    double start, t_block, t_static, t_rec;
+    int ok = 1;
+
+    start = bench_now();
+    matrix_multiply_block(&A, &B, &C, BLOCK_SIZE);
+    t_block = bench_now() - start;
+    ok &= verify_matrices(&C, &C_ref);
+
+    omp_set_num_threads(threads);
+    start = bench_now();
+    matrix_multiply_block_static(&A, &B, &C, BLOCK_SIZE);
+    t_static = bench_now() - start;
+    ok &= verify_matrices(&C, &C_ref);
+
+    long executed, steals;
+    ws_reset_stats(sched);
+    zero_matrix(&C);
+    start = bench_now();
+    gemm_recursive(sched, &A, &B, &C, 0);
+    t_rec = bench_now() - start;
+    ws_stats(sched, &executed, &steals);
+    ok &= verify_matrices(&C, &C_ref);
+
+    printf("%-14s %5d %5d %5d | %8.2f %8.2f %8.2f | %6.2fx %6.2fx | %7ld %6ld %s\n",
+           s->label, s->m, s->n, s->k,
+           calculate_gflops(s->m, s->n, s->k, t_block),
+           calculate_gflops(s->m, s->n, s->k, t_static),
+           calculate_gflops(s->m, s->n, s->k, t_rec),
+           t_block / t_rec, t_static / t_rec, executed, steals,
+           ok ? "✓" : "✗");
+
+    free_matrix(&A);
+    free_matrix(&B);
+    free_matrix(&C);
+    free_matrix(&C_ref);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int threads = omp_get_num_procs();
+    int n = 1024;
+
+    // Parse command-line arguments: [n] [--threads=T]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+            if (threads <= 0) {
+                fprintf(stderr, "Invalid thread count\n");
+                return EXIT_FAILURE;
+            }
+        } else {
+            n = atoi(argv[i]);
+            if (n < 16) {
+                fprintf(stderr, "Invalid matrix size (minimum 16)\n");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Square, tall, wide, short-K and long-K shapes with the same order of work
+    Shape shapes[] = {
+        {n,     n,     n,     "square"},
+        {4 * n, n / 4, n,     "tall C"},
+        {n / 4, 4 * n, n,     "wide C"},
+        {2 * n, 2 * n, n / 4, "short K"},
+        {n / 2, n / 2, 4 * n, "long K"},
+        {n + 7, n - 5, n + 3, "odd sizes"}
+    };
+    int num_shapes = sizeof(shapes) / sizeof(shapes[0]);
+
+    printf("=================================================================================================\n");
+    printf("       RECURSIVE (CACHE-OBLIVIOUS) GEMM ON A WORK-STEALING SCHEDULER                             \n");
+    printf("=================================================================================================\n");
+    printf("Threads:           %d (one Chase-Lev deque per worker)\n", threads);
+    printf("Leaf size:         %d KB (A + B + C blocks)\n", GEMM_RECURSIVE_LEAF_BYTES / 1024);
+    printf("Baselines:         fixed %dx%d tiles (serial) and OpenMP static split of tile rows\n",
+           BLOCK_SIZE, BLOCK_SIZE);
+    printf("=================================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+    WsScheduler *sched = ws_create(threads);
+
+    printf("%-14s %5s %5s %5s | %8s %8s %8s | %7s %7s | %7s %6s\n",
+           "Shape", "M", "N", "K", "block", "static", "ws-rec", "vs blk", "vs stat", "tasks", "steals");
+    printf("%-14s %17s | %26s |\n", "", "", "GFLOPS");
+    printf("-------------------------------------------------------------------------------------------------\n");
+
+    int all_ok = 1;
+    for (int i = 0; i < num_shapes; i++) {
+        all_ok &= run_shape(&shapes[i], sched, threads);
+    }
+    printf("=================================================================================================\n");
+    printf("Verification: %s\n", all_ok ? "✓ PASSED (all shapes, vs serial ikj)" : "✗ FAILED");
+
+    ws_destroy(sched);
+    return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "strassen.h"
+#include "bench.h"
+
+// Matrix size (default): Strassen only pays off for large N
+#ifndef N
+#define N 2048
+#endif
+
+// Crossovers tried when none are given on the command line
+static const int default_crossovers[] = {128, 256, 512, 1024};
+
+// Function to calculate GFLOPS (classic 2*m*n*k count, so Strassen shows as "effective")
+double calculate_gflops(int m, int n, int k, double time_sec) {
+    return (2.0 * m * n * k / time_sec) / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int n = N;
+    int crossovers[16];
+    int num_crossovers = 0;
+
+    // Parse command-line arguments: [n] [crossover ...]
+    if (argc > 1) {
+        n = atoi(argv[1]);
+        if (n <= 0) {
+            fprintf(stderr, "Invalid matrix size\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 2; i < argc && num_crossovers < 16; i++) {
+        crossovers[num_crossovers] = atoi(argv[i]);
+        if (crossovers[num_crossovers] <= 0) {
+            fprintf(stderr, "Invalid crossover: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        num_crossovers++;
+    }
+    if (num_crossovers == 0) {
+        num_crossovers = sizeof(default_crossovers) / sizeof(default_crossovers[0]);
+        memcpy(crossovers, default_crossovers, sizeof(default_crossovers));
+    }
+
+    printf("=================================================================\n");
+    printf("         STRASSEN-WINOGRAD FAST MULTIPLICATION                   \n");
+    printf("=================================================================\n");
+    printf("Matrix size:         %d x %d%s\n", n, n, (n & 1) ? " (odd: dynamic peeling)" : "");
+    printf("Leaf kernel:         packed GEMM (%s)\n", gemm_kernel_name());
+    printf("=================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    Matrix A = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix B = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C = allocate_matrix(n, n, MATRIX_PAD);
+    Matrix C_ref = allocate_matrix(n, n, MATRIX_PAD);
+    initialize_matrix(&A);
+    initialize_matrix(&B);
+
+    printf("Computing reference with matrix_multiply_standard...\n");
+    double start = bench_now();
+    matrix_multiply_standard(&A, &B, &C_ref);
+    double t_standard = bench_now() - start;
+
+    zero_matrix(&C);
+    start = bench_now();
+    gemm_packed(&A, &B, &C, NULL);
+    double t_classic = bench_now() - start;
+    double classic_err = matrix_max_abs_error(&C, &C_ref);
+    printf("Classic packed GEMM: %.4f s, %.2f GFLOPS, max error %.3e\n\n",
+           t_classic, calculate_gflops(n, n, n, t_classic), classic_err);
+
+    printf("%10s %8s %10s %12s %10s %10s %11s %11s %7s\n",
+           "Crossover", "Levels", "Work (MB)", "Time (s)", "Eff.GFLOPS",
+           "vs GEMM", "Max abs err", "Max rel err", "Verify");
+    printf("------------------------------------------------------------------------------------------------\n");
+
+    int all_passed = 1;
+    for (int i = 0; i < num_crossovers; i++) {
+        int crossover = crossovers[i];
+        int levels = 0;
+        for (int s = n; s > crossover && s >= 2; s /= 2) levels++;
+
+        // One workspace for the whole recursion, allocated before timing
+        size_t ws_doubles = strassen_workspace_size(n, n, n, crossover);
+        double *ws = strassen_allocate_workspace(n, n, n, crossover);
+
+        start = bench_now();
+        strassen_multiply(&A, &B, &C, crossover, ws);
+        double t = bench_now() - start;
+
+        int ok = verify_matrices(&C, &C_ref);
+        all_passed &= ok;
+        printf("%10d %8d %10.1f %12.4f %10.2f %9.2fx %11.3e %11.3e %7s\n",
+               crossover, levels, ws_doubles * sizeof(double) / (1024.0 * 1024.0), t,
+               calculate_gflops(n, n, n, t), t_classic / t,
+               matrix_max_abs_error(&C, &C_ref), matrix_max_rel_error(&C, &C_ref),
+               ok ? "✓" : "✗");
+        free(ws);
+    }
+    printf("================================================================================================\n");
+    printf("Speedup of the classic GEMM over matrix_multiply_standard: %.2fx\n", t_standard / t_classic);
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (verify_matrices, all crossovers)" : "✗ FAILED");
+
+    free_matrix(&A);
+    free_matrix(&B);
+    free_matrix(&C);
+    free_matrix(&C_ref);
+
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
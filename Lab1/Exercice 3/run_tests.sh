@@ -3,6 +3,10 @@
 # Output file
 RESULTS_FILE="test_results.txt"
 
+# Shared matrix module (contiguous 64-byte aligned layout + kernels)
+COMMON_DIR="../../common"
+COMMON_SRC="$COMMON_DIR/matrix.c $COMMON_DIR/arena.c $COMMON_DIR/mxm_kernels.c $COMMON_DIR/gemm.c $COMMON_DIR/affinity.c $COMMON_DIR/ws_sched.c $COMMON_DIR/gemm_recursive.c $COMMON_DIR/tune_profile.c $COMMON_DIR/autotune.c $COMMON_DIR/strassen.c $COMMON_DIR/bench.c $COMMON_DIR/perf_counters.c $COMMON_DIR/cache_info.c $COMMON_DIR/roofline.c $COMMON_DIR/gemm_batch.c $COMMON_DIR/gemm_mixed.c $COMMON_DIR/gemm_ooc.c"
+
 # Function to output to both terminal and file
 output() {
     echo "$1" | tee -a "$RESULTS_FILE"
@@ -33,7 +37,7 @@ output "========================================================================
 output "                          COMPILATION"
 output "========================================================================"
 output "Compiling mxm_bloc.c with optimization level -O2..."
-gcc -O2 -o mxm_block mxm_bloc.c -lm 2>&1 | tee -a "$RESULTS_FILE"
+gcc -O2 -I$COMMON_DIR -o mxm_block mxm_bloc.c $COMMON_SRC -lm 2>&1 | tee -a "$RESULTS_FILE"
 
 if [ $? -ne 0 ]; then
     output "✗ Compilation failed!"
@@ -43,6 +47,101 @@ fi
 output "✓ Compilation successful!"
 output ""
 
+output "Compiling mxm_parallel.c with OpenMP..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_parallel mxm_parallel.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_parallel.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_recursive.c (work-stealing recursive GEMM)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_recursive mxm_recursive.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_recursive.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_autotune.c (block size / loop order autotuner)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_autotune mxm_autotune.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_autotune.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_strassen.c (Strassen-Winograd for large N)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_strassen mxm_strassen.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_strassen.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_batch.c (batched small GEMM)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_batch mxm_batch.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_batch.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_mixed.c (fp32 / bf16 GEMM)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_mixed mxm_mixed.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_mixed.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_ooc.c (out-of-core GEMM on mapped files)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_ooc mxm_ooc.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_ooc.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+output "Compiling mxm_alloc.c (pool and arena allocation cost)..."
+gcc -O2 -fopenmp -I$COMMON_DIR -o mxm_alloc mxm_alloc.c $COMMON_SRC -lm -lpthread 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of mxm_alloc.c failed!"
+    exit 1
+fi
+
+output "✓ Compilation successful!"
+output ""
+
+# Tune first so every later run loads this machine's profile
+output "========================================================================"
+output "                AUTOTUNING (profile saved per CPU model)"
+output "========================================================================"
+./mxm_autotune 256 512 1024 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
 # Test different matrix sizes
 MATRIX_SIZES=(256 512 1024)
 
@@ -66,6 +165,48 @@ do
     output ""
 done
 
+output "========================================================================"
+output "              STRONG SCALING (1..12 threads, compact affinity)"
+output "========================================================================"
+./mxm_parallel 1024 --affinity=compact 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "     RECURSIVE WORK-STEALING GEMM vs FIXED TILES (square/non-square)"
+output "========================================================================"
+./mxm_recursive 1024 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "          STRASSEN-WINOGRAD (N = 2048, crossover sweep)"
+output "========================================================================"
+./mxm_strassen 2048 256 512 1024 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "          BATCHED SMALL GEMM (N = 4..64, thousands of products)"
+output "========================================================================"
+./mxm_batch 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "       MIXED PRECISION (fp64 / fp32 / bf16 storage, N = 1024)"
+output "========================================================================"
+./mxm_mixed 1024 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "   OUT-OF-CORE GEMM (N = 4096 on disk, 64 MB of tiles, serial/prefetch)"
+output "========================================================================"
+./mxm_ooc 4096 --budget=64 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "        ALLOCATION COST (malloc per call vs pool vs arena)"
+output "========================================================================"
+./mxm_alloc 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
 output "========================================================================"
 output "                         TESTING COMPLETE"
 output "========================================================================"
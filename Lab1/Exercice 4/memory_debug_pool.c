@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+// memory_debug.c on the pool allocator: built with -DMEM_DEBUG, the leaks
+// Valgrind found are reported at exit with the line that allocated them.
+//
+//   gcc -DMEM_DEBUG -I../../common memory_debug_pool.c ../../common/arena.c
+//       ../../common/matrix.c -lpthread
+//
+//   ./a.out                 original bugs: two leaks reported with file:line
+//   ./a.out --fixed         both blocks freed: nothing reported
+//   ./a.out --arena         both arrays in an arena released in one call
+//   ./a.out --double-free   the second pool_free is caught and exits (MEM_DEBUG
+//                           only: a release build does not check pool_free)
+
+#define SIZE 5
+
+int* allocate_array(int size) {
+    return (int*)pool_alloc(size * sizeof(int));
+}
+
+void initialize_array(int *arr, int size) {
+    if (!arr) return;
+    for (int i = 0; i < size; i++) {
+        arr[i] = i * 10;
+    }
+}
+
+void print_array(int *arr, int size) {
+    if (!arr) return;
+    printf("Array elements: ");
+    for (int i = 0; i < size; i++) {
+        printf("%d ", arr[i]);
+    }
+    printf("\n");
+}
+
+int* duplicate_array(int *arr, int size) {
+    if (!arr) return NULL;
+    int *copy = (int*)pool_alloc(size * sizeof(int));
+    memcpy(copy, arr, size * sizeof(int));
+    return copy;
+}
+
+int main(int argc, char *argv[]) {
+    const char *mode = argc > 1 ? argv[1] : "";
+
+    if (strcmp(mode, "--arena") == 0) {
+        // Nothing to pair: the arena owns both arrays
+        Arena arena;
+        arena_init(&arena, 0);
+        int *array = (int*)arena_alloc(&arena, SIZE * sizeof(int));
+        initialize_array(array, SIZE);
+        print_array(array, SIZE);
+        int *array_copy = (int*)arena_alloc(&arena, SIZE * sizeof(int));
+        memcpy(array_copy, array, SIZE * sizeof(int));
+        print_array(array_copy, SIZE);
+        arena_destroy(&arena);
+        return 0;
+    }
+
+    int *array = allocate_array(SIZE);
+    initialize_array(array, SIZE);
+
+    print_array(array, SIZE);
+    int *array_copy = duplicate_array(array, SIZE);
+    print_array(array_copy, SIZE);
+
+    if (strcmp(mode, "--fixed") == 0) {
+        pool_free(array);
+        pool_free(array_copy);
+    } else if (strcmp(mode, "--double-free") == 0) {
+        pool_free(array);
+        pool_free(array_copy);
+        pool_free(array);
+    }
+    return 0; // Without a flag both arrays leak, as in memory_debug.c
+}
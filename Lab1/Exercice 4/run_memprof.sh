@@ -0,0 +1,89 @@
+#!/bin/bash
+
+RESULTS_FILE="memprof_results.txt"
+
+COMMON_DIR="../../common"
+EX3_DIR="../../Lab2/Exercice3"
+
+# Function to output to both terminal and file
+output() {
+    echo "$1" | tee -a "$RESULTS_FILE"
+}
+
+# Function to time a command (seconds, wall clock)
+elapsed() {
+    local start end
+    start=$(date +%s%N)
+    "$@" > /dev/null 2>&1
+    end=$(date +%s%N)
+    awk -v ns=$((end - start)) 'BEGIN { printf "%.3f", ns / 1e9 }'
+}
+
+# Clear previous results
+> "$RESULTS_FILE"
+
+output "========================================================================"
+output "         Exercise 4: Leak Detection without Valgrind"
+output "              memprof (LD_PRELOAD heap profiler)"
+output "========================================================================"
+output ""
+output "Date: $(date)"
+output "System: $(uname -a)"
+output ""
+
+output "========================================================================"
+output "                          COMPILATION"
+output "========================================================================"
+
+output "Compiling libmemprof.so..."
+gcc -O2 -shared -fPIC -o libmemprof.so $COMMON_DIR/memprof.c -ldl 2>&1 | tee -a "$RESULTS_FILE"
+
+if [ $? -ne 0 ]; then
+    output "✗ Compilation of memprof.c failed!"
+    exit 1
+fi
+
+# -rdynamic puts the program's functions in the report
+output "Compiling memory_debug.c and memory_debug_fixed.c (-g -rdynamic)..."
+gcc -g -rdynamic -o memory_debug memory_debug.c 2>&1 | tee -a "$RESULTS_FILE"
+gcc -g -rdynamic -o memory_debug_fixed memory_debug_fixed.c 2>&1 | tee -a "$RESULTS_FILE"
+
+output "Compiling Lab2/Exercice3/exercice3.c (N = 100M, 2.4 GB of arrays)..."
+gcc -O2 -rdynamic -o exercice3 $EX3_DIR/exercice3.c 2>&1 | tee -a "$RESULTS_FILE"
+
+output "✓ Compilation successful!"
+output ""
+
+output "========================================================================"
+output "                 memory_debug (leaks on purpose)"
+output "========================================================================"
+MEMPROF_TOP=0 LD_PRELOAD=./libmemprof.so ./memory_debug 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "                 memory_debug_fixed"
+output "========================================================================"
+MEMPROF_TOP=0 LD_PRELOAD=./libmemprof.so ./memory_debug_fixed 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+
+output "========================================================================"
+output "           Lab2/Exercice3 at full size (profile and overhead)"
+output "========================================================================"
+MEMPROF_TOP=3 LD_PRELOAD=./libmemprof.so ./exercice3 2>&1 | tee -a "$RESULTS_FILE"
+output ""
+printf "%-12s %12s %12s\n" "Run" "Plain (s)" "memprof (s)" | tee -a "$RESULTS_FILE"
+for run in 1 2 3; do
+    plain=$(elapsed ./exercice3)
+    profiled=$(elapsed env LD_PRELOAD=./libmemprof.so ./exercice3)
+    printf "%-12s %12s %12s\n" "$run" "$plain" "$profiled" | tee -a "$RESULTS_FILE"
+done
+if command -v valgrind &> /dev/null; then
+    output "Valgrind (memcheck) on the same run: $(elapsed valgrind --leak-check=full ./exercice3) s"
+fi
+output ""
+
+output "========================================================================"
+output "                         TESTING COMPLETE"
+output "========================================================================"
+output ""
+output "Results saved to: $RESULTS_FILE"
@@ -218,6 +218,9 @@ im = ax5.imshow(pivot.values, aspect='auto', cmap='YlOrRd', interpolation='neare
 # Add text annotations
 for i in range(len(pivot.index)):
     for j in range(len(pivot.columns)):
+        # Grid points a pruned sweep (hpl_sweep.py --keep) did not run stay blank
+        if np.isnan(pivot.values[i, j]):
+            continue
         text = ax5.text(j, i, f'{pivot.values[i, j]:.1f}',
                        ha="center", va="center", color="black", fontsize=9)
 
@@ -0,0 +1,508 @@
+#!/usr/bin/env python3
+"""
+HPL parameter sweep: every (N, NB, P x Q, DEPTH, PFACT, RFACT, NBMIN) combination,
+several at a time on disjoint cores, resumable, and pruned as N grows.
+
+- Runs go level by level over N. Within a level, independent runs start as soon
+  as enough physical cores (pinned with sched_setaffinity) and memory are free.
+- Every finished run is appended to the checkpoint CSV (flushed and fsync'd), so
+  a killed sweep resumes where it stopped. PASSED / FAILED / TIMEOUT runs are not
+  repeated; ERROR runs (crash, OOM, empty log) are retried.
+- Before a level starts, configurations are pruned using the largest smaller N
+  at which they ran with at least 8 panels. A configuration is dropped if its
+  Gflops there were under --keep x the best at that N (default 0.5), if it
+  failed the residual check, or if its time scaled by (N / N_prev)^3 exceeds
+  --max-time. --keep=0 (without --max-time) runs the full grid.
+- Ctrl-C (or an error in the sweep) stops the runs in flight: SIGTERM to their
+  process groups, then SIGKILL after a grace period.
+
+Backends:
+  hpl_native (default)  one process, OpenMP threads; P = Q = 1, PFACT = RFACT = right
+  xhpl (--xhpl=PATH)    one HPL.dat per run in its own directory, mpirun -np P*Q
+
+Concurrent runs share the last-level cache and memory bandwidth. Sweep with
+--jobs > 1 to find the region that matters, then confirm the winners with --jobs=1.
+
+Usage:
+  python3 hpl_sweep.py --ns=1000,5000,10000 --nbs=32,64,128,256 --depths=0,1
+  python3 hpl_sweep.py --xhpl=/path/to/xhpl --grids=1x1,1x2,2x1 --pfacts=0,1,2 --rfacts=0,1,2
+  python3 hpl_sweep.py ... --results=hpl_results.csv    (best per (N, NB), for analyze_hpl_results.py)
+"""
+
+import argparse
+import csv
+import os
+import re
+import signal
+import subprocess
+import sys
+import time
+
+PARAM_FIELDS = ["N", "NB", "P", "Q", "DEPTH", "PFACT", "RFACT", "NBMIN"]
+CHECKPOINT_FIELDS = PARAM_FIELDS + ["Time(s)", "GFLOPS", "Status", "Log"]
+DONE = ("PASSED", "FAILED", "TIMEOUT")
+
+# A smaller-N run predicts a configuration only if it had this many panels:
+# with fewer, panel factorization dominates and large NB always looks slow
+MIN_PANELS = 8
+
+# Result line of both xhpl and hpl_native: T/V N NB [P Q] Time Gflops
+RESULT_LINE = re.compile(r"^W[RC]\S*\s+(\d+)\s+(\d+)\s+(?:\d+\s+\d+\s+)?([\d.]+)\s+([\d.eE+-]+)")
+
+HPL_DAT = """HPLinpack benchmark input file
+Innovative Computing Laboratory, University of Tennessee
+HPL.out      output file name (if any)
+6            device out (6=stdout,7=stderr,file)
+1            # of problems sizes (N)
+{N}          Ns
+1            # of NBs
+{NB}         NBs
+0            PMAP process mapping (0=Row-,1=Column-major)
+1            # of process grids (P x Q)
+{P}          Ps
+{Q}          Qs
+16.0         threshold
+1            # of panel fact
+{PFACT}      PFACTs (0=left, 1=Crout, 2=Right)
+1            # of recursive stopping criterium
+{NBMIN}      NBMINs (>= 1)
+1            # of panels in recursion
+2            NDIVs
+1            # of recursive panel fact.
+{RFACT}      RFACTs (0=left, 1=Crout, 2=Right)
+1            # of broadcast
+0            BCASTs (0=1rg,1=1rM,2=2rg,3=2rM,4=Lng,5=LnM)
+1            # of lookahead depth
+{DEPTH}      DEPTHs (>=0)
+2            SWAP (0=bin-exch,1=long,2=mix)
+64           swapping threshold
+0            L1 in (0=transposed,1=no-transposed) form
+0            U  in (0=transposed,1=no-transposed) form
+1            Equilibration (0=no,1=yes)
+8            memory alignment in double (> 0)
+"""
+
+
+def int_list(text):
+    return [int(v) for v in text.split(",") if v]
+
+
+def grid_list(text):
+    grids = []
+    for g in text.split(","):
+        p, q = g.lower().split("x")
+        grids.append((int(p), int(q)))
+    return grids
+
+
+# ===== Machine =====
+
+def physical_cores():
+    """One logical CPU per physical core we may run on (SMT siblings dropped)."""
+    allowed = sorted(os.sched_getaffinity(0))
+    seen, cores = set(), []
+    for cpu in allowed:
+        path = "/sys/devices/system/cpu/cpu%d/topology/core_cpus_list" % cpu
+        if not os.path.exists(path):
+            path = "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list" % cpu
+        try:
+            with open(path) as f:
+                siblings = f.read().strip()
+        except OSError:
+            siblings = str(cpu)
+        if siblings not in seen:
+            seen.add(siblings)
+            cores.append(cpu)
+    return cores
+
+
+def available_memory():
+    """MemAvailable in bytes (0 if unknown)."""
+    try:
+        with open("/proc/meminfo") as f:
+            for line in f:
+                if line.startswith("MemAvailable:"):
+                    return int(line.split()[1]) * 1024
+    except OSError:
+        pass
+    return 0
+
+
+# ===== Configurations =====
+
+def key_of(cfg):
+    return tuple(int(cfg[f]) for f in PARAM_FIELDS)
+
+
+def shape_of(cfg):
+    """Everything but N: the configuration followed from level to level."""
+    return key_of(cfg)[1:]
+
+
+def run_name(cfg, defaults):
+    """run_N<N>_NB<NB>, plus only the parameters that differ from the HPL.dat defaults."""
+    name = "run_N%d_NB%d" % (cfg["N"], cfg["NB"])
+    if (cfg["P"], cfg["Q"]) != (1, 1):
+        name += "_%dx%d" % (cfg["P"], cfg["Q"])
+    for field, tag in (("DEPTH", "D"), ("PFACT", "PF"), ("RFACT", "RF"), ("NBMIN", "NBMIN")):
+        if cfg[field] != defaults[field]:
+            name += "_%s%d" % (tag, cfg[field])
+    return name
+
+
+def bytes_needed(cfg):
+    """A plus HPL's workspace, with some slack for the runtime."""
+    n = cfg["N"]
+    return int(8 * n * (n + 1) * 1.05 + 8 * n * cfg["NB"] + 64 * 2**20 * cfg["P"] * cfg["Q"])
+
+
+# ===== Checkpoint =====
+
+def load_checkpoint(path):
+    """Last row per configuration."""
+    results = {}
+    if not os.path.exists(path):
+        return results
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            try:
+                cfg = {k: int(row[k]) for k in PARAM_FIELDS}
+            except (KeyError, ValueError):
+                continue    # a line cut short by a crash
+            cfg.update({k: row[k] for k in ("Time(s)", "GFLOPS", "Status", "Log")})
+            results[key_of(cfg)] = cfg
+    return results
+
+
+def append_checkpoint(path, row):
+    new = not os.path.exists(path) or os.path.getsize(path) == 0
+    with open(path, "a", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=CHECKPOINT_FIELDS)
+        if new:
+            writer.writeheader()
+        writer.writerow({k: row[k] for k in CHECKPOINT_FIELDS})
+        f.flush()
+        os.fsync(f.fileno())
+
+
+def write_results(path, results):
+    """Best run per (N, NB) in the N,NB,Time(s),GFLOPS,Status format of hpl_results.csv."""
+    best = {}
+    for r in results.values():
+        k = (r["N"], r["NB"])
+        score = float(r["GFLOPS"]) if r["Status"] == "PASSED" else -1.0
+        if k not in best or score > best[k][0]:
+            best[k] = (score, r)
+    with open(path, "w") as f:
+        f.write("N,NB,Time(s),GFLOPS,Status\n")
+        for k in sorted(best):
+            r = best[k][1]
+            f.write("%d,%d,%s,%s,%s\n" % (r["N"], r["NB"], r["Time(s)"], r["GFLOPS"], r["Status"]))
+
+
+# ===== Pruning =====
+
+def prune(level, configs, results, args):
+    """Split a level's configurations into (kept, [(cfg, reason)])."""
+    previous = {}
+    for r in results.values():
+        if r["N"] < level and r["Status"] in DONE and (r["N"] >= MIN_PANELS * r["NB"] or r["Status"] != "PASSED"):
+            s = shape_of(r)
+            if s not in previous or r["N"] > previous[s]["N"]:
+                previous[s] = r
+
+    # Best Gflops per smaller N, among this level's configurations
+    shapes = set(shape_of(c) for c in configs)
+    best = {}
+    for r in results.values():
+        if r["N"] < level and r["Status"] == "PASSED" and shape_of(r) in shapes:
+            best[r["N"]] = max(best.get(r["N"], 0.0), float(r["GFLOPS"]))
+
+    kept, dropped = [], []
+    for c in configs:
+        prev = previous.get(shape_of(c))
+        if prev is None:
+            kept.append(c)
+        elif prev["Status"] != "PASSED":
+            dropped.append((c, "%s at N=%d" % (prev["Status"], prev["N"])))
+        elif float(prev["GFLOPS"]) < args.keep * best[prev["N"]]:
+            dropped.append((c, "%.1f Gflops at N=%d, best %.1f" % (float(prev["GFLOPS"]), prev["N"], best[prev["N"]])))
+        elif args.max_time and float(prev["Time(s)"]) * (level / prev["N"]) ** 3 > args.max_time:
+            dropped.append((c, "predicted %.0f s" % (float(prev["Time(s)"]) * (level / prev["N"]) ** 3)))
+        else:
+            kept.append(c)
+
+    # Never prune below --min-keep: bring back the best of the dropped
+    if len(kept) < args.min_keep:
+        def prev_gflops(item):
+            prev = previous[shape_of(item[0])]
+            return float(prev["GFLOPS"]) if prev["Status"] == "PASSED" else -1.0
+        dropped.sort(key=prev_gflops, reverse=True)
+        while dropped and len(kept) < args.min_keep and prev_gflops(dropped[0]) > 0:
+            kept.append(dropped.pop(0)[0])
+    return kept, dropped
+
+
+# ===== Runs =====
+
+class Run:
+    def __init__(self, cfg, cores, name, log_path, proc, log_file):
+        self.cfg = cfg
+        self.cores = cores
+        self.name = name
+        self.log_path = log_path
+        self.proc = proc
+        self.log_file = log_file
+        self.start = time.time()
+
+
+def command_for(cfg, args, workdir):
+    """Command line, working directory and environment of one run."""
+    env = dict(os.environ)
+    threads = str(args.threads)
+    for var in ("OMP_NUM_THREADS", "OPENBLAS_NUM_THREADS", "MKL_NUM_THREADS", "BLIS_NUM_THREADS"):
+        env[var] = threads
+
+    if args.xhpl:
+        os.makedirs(workdir, exist_ok=True)
+        with open(os.path.join(workdir, "HPL.dat"), "w") as f:
+            f.write(HPL_DAT.format(**cfg))
+        np = cfg["P"] * cfg["Q"]
+        cmd = [part.replace("{np}", str(np)) for part in args.mpirun.split()] + [args.xhpl]
+        return cmd, workdir, env
+
+    cmd = [args.native, str(cfg["N"]), "--nb=%d" % cfg["NB"], "--depth=%d" % cfg["DEPTH"],
+           "--nbmin=%d" % cfg["NBMIN"], "--compare=/dev/null"]
+    return cmd, None, env
+
+
+def start_run(cfg, cores, args, defaults):
+    name = run_name(cfg, defaults)
+    log_path = os.path.join(args.output_dir, name + ".log")
+    cmd, cwd, env = command_for(cfg, args, os.path.join(args.output_dir, name))
+    log_file = open(log_path, "w")
+    log_file.write("# cores %s: %s\n" % (",".join(map(str, cores)), " ".join(cmd)))
+    log_file.flush()
+    proc = subprocess.Popen(cmd, cwd=cwd, env=env, stdout=log_file, stderr=subprocess.STDOUT,
+                            start_new_session=True, preexec_fn=lambda: os.sched_setaffinity(0, cores))
+    return Run(cfg, cores, name, log_path, proc, log_file)
+
+
+def finish_run(run, timed_out):
+    """Checkpoint row of a finished run, from its log."""
+    run.log_file.close()
+    row = dict(run.cfg)
+    row.update({"Time(s)": "ERROR", "GFLOPS": "ERROR", "Log": run.log_path})
+    with open(run.log_path, errors="replace") as f:
+        text = f.read()
+    for line in text.splitlines():
+        m = RESULT_LINE.match(line)
+        if m:
+            row["Time(s)"], row["GFLOPS"] = m.group(3), m.group(4)
+    if timed_out:
+        row["Status"] = "TIMEOUT"
+    elif "PASSED" in text:
+        row["Status"] = "PASSED"
+    elif "FAILED" in text:
+        row["Status"] = "FAILED"
+    else:
+        row["Status"] = "ERROR"
+        with open(run.log_path, "a") as f:
+            f.write("# exit status %d, no result line\n" % run.proc.returncode)
+    if row["Time(s)"] == "ERROR" and row["Status"] != "TIMEOUT":
+        row["Status"] = "ERROR"
+    return row
+
+
+def signal_group(run, sig):
+    try:
+        os.killpg(run.proc.pid, sig)
+    except ProcessLookupError:
+        pass
+
+
+def stop_all(running, grace=5.0):
+    """Stop the runs in flight: their own sessions do not get the terminal's Ctrl-C."""
+    for run in running:
+        signal_group(run, signal.SIGTERM)
+    deadline = time.time() + grace
+    for run in running:
+        try:
+            run.proc.wait(timeout=max(0.0, deadline - time.time()))
+        except subprocess.TimeoutExpired:
+            signal_group(run, signal.SIGKILL)
+            run.proc.wait()
+        run.log_file.close()
+    del running[:]
+
+
+def run_level(level, configs, args, defaults, cores, results):
+    """Run a level's configurations, as many at a time as cores and memory allow."""
+    pending = sorted(configs, key=lambda c: -bytes_needed(c))    # biggest first, while memory is free
+    free = list(cores)
+    running = []
+    budget = args.mem_fraction * available_memory()
+
+    try:
+        while pending or running:
+            # Start whatever fits
+            used = sum(bytes_needed(r.cfg) for r in running)
+            for cfg in list(pending):
+                if len(running) >= args.jobs:
+                    break
+                need = cfg["P"] * cfg["Q"] * args.threads
+                if need > len(cores):
+                    pending.remove(cfg)
+                    print("  skip  %-40s needs %d cores, %d available" % (run_name(cfg, defaults), need, len(cores)))
+                    continue
+                if budget and bytes_needed(cfg) > budget:
+                    pending.remove(cfg)
+                    print("  skip  %-40s needs %.1f GB, %.1f GB available" %
+                          (run_name(cfg, defaults), bytes_needed(cfg) / 1e9, budget / 1e9))
+                    continue
+                if need > len(free) or (budget and running and used + bytes_needed(cfg) > budget):
+                    continue
+                mine, free = free[:need], free[need:]
+                running.append(start_run(cfg, mine, args, defaults))
+                used += bytes_needed(cfg)
+                pending.remove(cfg)
+                print("  start %-40s cores %s" % (running[-1].name, ",".join(map(str, mine))))
+
+            time.sleep(0.2)
+            for run in list(running):
+                timed_out = args.timeout and time.time() - run.start > args.timeout
+                if timed_out:
+                    signal_group(run, signal.SIGKILL)
+                    run.proc.wait()
+                elif run.proc.poll() is None:
+                    continue
+                row = finish_run(run, timed_out)
+                append_checkpoint(args.checkpoint, row)
+                results[key_of(row)] = row
+                running.remove(run)
+                free = sorted(free + run.cores)
+                print("  done  %-40s %8s s %12s Gflops  %s" % (run.name, row["Time(s)"], row["GFLOPS"], row["Status"]))
+    except BaseException:
+        # Interrupted or failed: leave no run behind (the unfinished ones are retried on resume)
+        stop_all(running)
+        raise
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parallel, resumable HPL parameter sweep")
+    parser.add_argument("--ns", type=int_list, default=[1000, 5000, 10000])
+    parser.add_argument("--nbs", type=int_list, default=[32, 64, 128, 256])
+    parser.add_argument("--grids", type=grid_list, default=[(1, 1)], help="PxQ list, e.g. 1x1,1x2,2x1")
+    parser.add_argument("--depths", type=int_list, default=None, help="lookahead depths (default: 0 for xhpl, 1 native)")
+    parser.add_argument("--pfacts", type=int_list, default=None, help="0=left, 1=Crout, 2=right (default from HPL.dat: 2)")
+    parser.add_argument("--rfacts", type=int_list, default=None, help="0=left, 1=Crout, 2=right (default from HPL.dat: 1)")
+    parser.add_argument("--nbmins", type=int_list, default=None, help="recursion stop (default from HPL.dat: 4)")
+    parser.add_argument("--xhpl", help="run this xhpl through mpirun instead of hpl_native")
+    parser.add_argument("--mpirun", default="mpirun -np {np}", help="launcher; {np} becomes P*Q")
+    parser.add_argument("--native", default="./hpl_native")
+    parser.add_argument("--threads", type=int, default=1, help="cores per process (OpenMP / BLAS threads)")
+    parser.add_argument("--jobs", type=int, default=0, help="concurrent runs (default: as many as cores allow)")
+    parser.add_argument("--mem-fraction", type=float, default=0.8, help="share of MemAvailable the runs may use")
+    parser.add_argument("--keep", type=float, default=0.5, help="prune below this share of the best Gflops (0: off)")
+    parser.add_argument("--min-keep", type=int, default=3, help="never keep fewer configurations per level")
+    parser.add_argument("--max-time", type=float, default=0.0, help="prune runs predicted to take longer (s)")
+    parser.add_argument("--timeout", type=float, default=0.0, help="kill runs after this many seconds")
+    parser.add_argument("--checkpoint", default="hpl_sweep.csv")
+    parser.add_argument("--output-dir", default="hpl_outputs")
+    parser.add_argument("--results", help="also write the best run per (N, NB) in hpl_results.csv format")
+    parser.add_argument("--restart", action="store_true", help="ignore the checkpoint and run everything")
+    args = parser.parse_args()
+
+    # Defaults as in HPL.dat; hpl_native only has the right-looking recursive panel
+    native = not args.xhpl
+    defaults = {"DEPTH": 1 if native else 0, "PFACT": 2, "RFACT": 2 if native else 1, "NBMIN": 8 if native else 4}
+    depths = args.depths or [defaults["DEPTH"]]
+    pfacts = args.pfacts or [defaults["PFACT"]]
+    rfacts = args.rfacts or [defaults["RFACT"]]
+    nbmins = args.nbmins or [defaults["NBMIN"]]
+
+    if native and not os.access(args.native, os.X_OK):
+        sys.exit("%s not found; build it with the command on the first line of hpl_native.c" % args.native)
+    if args.xhpl:
+        args.xhpl = os.path.abspath(args.xhpl)
+        if not os.access(args.xhpl, os.X_OK):
+            sys.exit("%s is not executable" % args.xhpl)
+
+    configs, unsupported = [], 0
+    for n in sorted(set(args.ns)):
+        for nb in args.nbs:
+            for p, q in args.grids:
+                for depth in depths:
+                    for pfact in pfacts:
+                        for rfact in rfacts:
+                            for nbmin in nbmins:
+                                cfg = {"N": n, "NB": nb, "P": p, "Q": q, "DEPTH": depth,
+                                       "PFACT": pfact, "RFACT": rfact, "NBMIN": nbmin}
+                                if native and ((p, q) != (1, 1) or pfact != 2 or rfact != 2 or depth > 1):
+                                    unsupported += 1
+                                    continue
+                                configs.append(cfg)
+    if not configs:
+        sys.exit("no configuration to run (hpl_native: P = Q = 1, PFACT = RFACT = 2, DEPTH 0 or 1)")
+
+    cores = physical_cores()
+    widest = max(c["P"] * c["Q"] for c in configs) * args.threads
+    if not args.jobs:
+        args.jobs = max(1, len(cores) // widest)
+    os.makedirs(args.output_dir, exist_ok=True)
+    if args.restart and os.path.exists(args.checkpoint):
+        os.remove(args.checkpoint)
+    results = load_checkpoint(args.checkpoint)
+
+    print("=" * 80)
+    print("HPL PARAMETER SWEEP")
+    print("=" * 80)
+    print("Backend:             %s" % (args.xhpl + " via " + args.mpirun if args.xhpl else args.native))
+    print("Configurations:      %d (%d not supported by hpl_native)" % (len(configs), unsupported))
+    print("Cores:               %d physical, %d thread%s per process, up to %d runs at once" %
+          (len(cores), args.threads, "s" if args.threads > 1 else "", args.jobs))
+    print("Memory:              %.1f GB for the runs" % (args.mem_fraction * available_memory() / 1e9))
+    pruning = []
+    if args.keep:
+        pruning.append("below %.0f%% of the best at the previous N" % (100 * args.keep))
+    if args.max_time:
+        pruning.append("over %.0f s predicted" % args.max_time)
+    print("Pruning:             %s" % (", ".join(pruning) if pruning else "off (every grid point runs)"))
+    print("Checkpoint:          %s (%d finished runs)" % (args.checkpoint, sum(r["Status"] in DONE for r in results.values())))
+    print("=" * 80)
+
+    try:
+        for level in sorted(set(c["N"] for c in configs)):
+            level_configs = [c for c in configs if c["N"] == level]
+            kept, dropped = prune(level, level_configs, results, args) if args.keep or args.max_time \
+                else (level_configs, [])
+            todo = [c for c in kept if results.get(key_of(c), {}).get("Status") not in DONE]
+            print("\nN = %d: %d configurations, %d pruned, %d already done" %
+                  (level, len(level_configs), len(dropped), len(kept) - len(todo)))
+            for cfg, reason in dropped:
+                print("  prune %-40s %s" % (run_name(cfg, defaults), reason))
+            run_level(level, todo, args, defaults, cores, results)
+    except KeyboardInterrupt:
+        print("\nInterrupted; runs in flight stopped, finished runs are in %s, rerun to resume" % args.checkpoint)
+        sys.exit(130)
+
+    # Best configuration per N
+    print("\n" + "=" * 80)
+    print("%-8s %-40s %10s %12s" % ("N", "Best configuration", "Time (s)", "Gflops"))
+    print("-" * 80)
+    for level in sorted(set(c["N"] for c in configs)):
+        passed = [r for r in results.values() if r["N"] == level and r["Status"] == "PASSED"]
+        if passed:
+            r = max(passed, key=lambda r: float(r["GFLOPS"]))
+            print("%-8d %-40s %10s %12s" % (level, run_name(r, defaults), r["Time(s)"], r["GFLOPS"]))
+        else:
+            print("%-8d %-40s" % (level, "no passing run"))
+    print("=" * 80)
+
+    if args.results:
+        write_results(args.results, results)
+        print("Results: %s (best per N, NB), all runs in %s" % (args.results, args.checkpoint))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,120 +1,41 @@
 #!/bin/bash
 
-# HPL Benchmark Automation Script - FIXED VERSION
-# This script runs 36 experiments: 4 matrix sizes × 9 block sizes
+# HPL Benchmark Automation Script
+# Runs the 4 matrix sizes × 9 block sizes through hpl_sweep.py: independent runs
+# go in parallel on disjoint cores, finished runs are checkpointed in
+# hpl_sweep.csv (rerun this script to resume after a crash). Pruning is turned
+# off with --keep=0 so all 36 runs go to hpl_results.csv, the full grid
+# analyze_hpl_results.py expects.
+# Extra arguments go to hpl_sweep.py and come after it, e.g. --keep=0.5 to skip
+# block sizes far behind the best at a smaller N (fewer rows), --jobs=1 for
+# uncontended timings, --grids=1x1,1x2 --depths=0,1 --pfacts=0,1,2 --rfacts=0,1,2
 
 HPL_DIR="/home/lenovo/ex5/hpl-2.3/bin/Linux"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 RESULTS_FILE="hpl_results.csv"
 OUTPUT_DIR="hpl_outputs"
 
 # Matrix sizes to test
-N_VALUES=(1000 5000 10000 20000)
+N_VALUES="1000,5000,10000,20000"
 
 # Block sizes to test
-NB_VALUES=(1 2 4 8 16 32 64 128 256)
+NB_VALUES="1,2,4,8,16,32,64,128,256"
 
-cd $HPL_DIR
-
-# Create output directory for logs
-mkdir -p $OUTPUT_DIR
-
-# Create CSV header
-echo "N,NB,Time(s),GFLOPS,Status" > $RESULTS_FILE
+cd $HPL_DIR || exit 1
 
 echo "======================================"
 echo "Starting HPL Benchmark Experiments"
-echo "Total runs: 36 (4 N × 9 NB)"
+echo "Sizes: $N_VALUES, block sizes: $NB_VALUES"
 echo "======================================"
 echo ""
 
-run_number=1
-
-for N in "${N_VALUES[@]}"; do
-    for NB in "${NB_VALUES[@]}"; do
-        echo "Run $run_number/36: N=$N, NB=$NB"
-        
-        # Modify HPL.dat
-        cat > HPL.dat << EOF
-HPLinpack benchmark input file
-Innovative Computing Laboratory, University of Tennessee
-HPL.out      output file name (if any)
-6            device out (6=stdout,7=stderr,file)
-1            # of problems sizes (N)
-$N           Ns
-1            # of NBs
-$NB          NBs
-0            PMAP process mapping (0=Row-,1=Column-major)
-1            # of process grids (P x Q)
-1            Ps
-1            Qs
-16.0         threshold
-1            # of panel fact
-2            PFACTs (0=left, 1=Crout, 2=Right)
-1            # of recursive stopping criterium
-4            NBMINs (>= 1)
-1            # of panels in recursion
-2            NDIVs
-1            # of recursive panel fact.
-1            RFACTs (0=left, 1=Crout, 2=Right)
-1            # of broadcast
-0            BCASTs (0=1rg,1=1rM,2=2rg,3=2rM,4=Lng,5=LnM)
-1            # of lookahead depth
-0            DEPTHs (>=0)
-2            SWAP (0=bin-exch,1=long,2=mix)
-64           swapping threshold
-0            L1 in (0=transposed,1=no-transposed) form
-0            U  in (0=transposed,1=no-transposed) form
-1            Equilibration (0=no,1=yes)
-8            memory alignment in double (> 0)
-EOF
-        
-        # Run HPL and save full output
-        OUTPUT_FILE="$OUTPUT_DIR/run_N${N}_NB${NB}.log"
-        mpirun -np 1 ./xhpl > "$OUTPUT_FILE" 2>&1
-        
-        # Extract results - Look for the line starting with WR or containing the performance data
-        # The output format is: WR11C2R4  N  NB  P  Q  Time  Gflops
-        RESULT_LINE=$(grep -E "^WR|^WC" "$OUTPUT_FILE" | tail -1)
-        
-        if [ -n "$RESULT_LINE" ]; then
-            # Extract time and GFLOPS using awk
-            TIME=$(echo "$RESULT_LINE" | awk '{print $6}')
-            GFLOPS=$(echo "$RESULT_LINE" | awk '{print $7}')
-        else
-            TIME="ERROR"
-            GFLOPS="ERROR"
-        fi
-        
-        # Check for PASSED/FAILED
-        if grep -q "PASSED" "$OUTPUT_FILE"; then
-            STATUS="PASSED"
-        elif grep -q "FAILED" "$OUTPUT_FILE"; then
-            STATUS="FAILED"
-        else
-            STATUS="UNKNOWN"
-        fi
-        
-        # Save to CSV
-        echo "$N,$NB,$TIME,$GFLOPS,$STATUS" >> $RESULTS_FILE
-        
-        echo "  Time: $TIME s, Performance: $GFLOPS GFLOPS, Status: $STATUS"
-        echo ""
-        
-        run_number=$((run_number + 1))
-    done
-done
-
-echo "======================================"
-echo "All experiments completed!"
-echo "Results saved to: $RESULTS_FILE"
-echo "Individual logs saved to: $OUTPUT_DIR/"
-echo "======================================"
+python3 "$SCRIPT_DIR/hpl_sweep.py" --xhpl=./xhpl --ns=$N_VALUES --nbs=$NB_VALUES \
+    --output-dir=$OUTPUT_DIR --results=$RESULTS_FILE --keep=0 "$@" || exit $?
 
-# Display summary
 echo ""
 echo "Summary of Results:"
 echo "-------------------"
 column -t -s, $RESULTS_FILE
 
 echo ""
-echo "You can now run: python3 analyze_hpl_results.py"
\ No newline at end of file
+echo "You can now run: python3 analyze_hpl_results.py"
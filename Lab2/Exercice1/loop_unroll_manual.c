@@ -1,161 +1,177 @@
+// Build: gcc -O2 -I../../common loop_unroll_manual.c ../../common/bench.c ../../common/perf_counters.c -lm
+// Usage: ./a.out [n]   (default N; any n works, leftovers are summed one by one)
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+
+#include "bench.h"
 
 #define N 1000000
-#define ITERATIONS 100  // Multiple iterations for better timing accuracy
-
-int main() {
-    double *a = malloc(N * sizeof(double));
-    volatile double sum = 0.0;
-    double start, end;
-    int i, iter;
-    
-    // Initialize array
-    for (i = 0; i < N; i++)
-        a[i] = 1.0;
-    
-    // Choose your unroll factor here by uncommenting one section:
-    
-    // ========== U = 1 (Baseline) ==========
-   
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i++) {
-            sum += a[i];
-        }
-    }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=1: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-  
-    
-    // ========== U = 2 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 2) {
-            sum += a[i] + a[i+1];
-        }
-    }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=2: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 3 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 3) {
-            sum += a[i] + a[i+1] + a[i+2];
-        }
-    }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=3: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 4 ==========
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 4) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3];
-        }
-    }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=4: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    
-    // ========== U = 5 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 5) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + a[i+4];
-        }
+
+// One kernel per (unroll factor U, accumulator count A). Each iteration reads
+// U elements; element j goes to the partial sum of accumulator j % A, and each
+// partial is added to its accumulator once. A = 1 is the original
+//     sum += a[i] + a[i+1] + ... + a[i+U-1];
+// so the loop-carried chain is one add per U elements per accumulator.
+#define DEFINE_UNROLL_KERNEL(U, A)                              \
+    double sum_u##U##_a##A(const double *a, long n) {           \
+        double acc[A] = {0.0};                                  \
+        long i = 0;                                             \
+        for (; i + (U) <= n; i += (U)) {                        \
+            double t[A];                                        \
+            _Pragma("GCC unroll 8")                             \
+            for (int k = 0; k < (A); k++)                       \
+                t[k] = a[i + k];                                \
+            _Pragma("GCC unroll 32")                            \
+            for (int j = (A); j < (U); j++)                     \
+                t[j % (A)] += a[i + j];                         \
+            _Pragma("GCC unroll 8")                             \
+            for (int k = 0; k < (A); k++)                       \
+                acc[k] += t[k];                                 \
+        }                                                       \
+        for (; i < n; i++)                                      \
+            acc[0] += a[i];                                     \
+        double sum = 0.0;                                       \
+        for (int k = 0; k < (A); k++)                           \
+            sum += acc[k];                                      \
+        return sum;                                             \
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=5: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 6 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 6) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + a[i+4] + a[i+5];
-        }
+
+// Every unroll factor of the original sections, with 1, 2, 4 and 8 accumulators (A <= U)
+#define UNROLL_KERNELS(X)                              \
+    X(1, 1)                                            \
+    X(2, 1)  X(2, 2)                                   \
+    X(3, 1)  X(3, 2)                                   \
+    X(4, 1)  X(4, 2)  X(4, 4)                          \
+    X(5, 1)  X(5, 2)  X(5, 4)                          \
+    X(6, 1)  X(6, 2)  X(6, 4)                          \
+    X(7, 1)  X(7, 2)  X(7, 4)                          \
+    X(8, 1)  X(8, 2)  X(8, 4)  X(8, 8)                 \
+    X(16, 1) X(16, 2) X(16, 4) X(16, 8)                \
+    X(32, 1) X(32, 2) X(32, 4) X(32, 8)
+
+UNROLL_KERNELS(DEFINE_UNROLL_KERNEL)
+
+typedef struct {
+    int unroll;
+    int accumulators;
+    double (*sum)(const double *a, long n);
+} UnrollKernel;
+
+#define KERNEL_ENTRY(U, A) {U, A, sum_u##U##_a##A},
+
+static const UnrollKernel kernels[] = {
+    UNROLL_KERNELS(KERNEL_ENTRY)
+};
+
+static const int unroll_factors[] = {1, 2, 3, 4, 5, 6, 7, 8, 16, 32};
+static const int accumulator_counts[] = {1, 2, 4, 8};
+
+#define NUM_KERNELS (int)(sizeof(kernels) / sizeof(kernels[0]))
+#define NUM_UNROLL (int)(sizeof(unroll_factors) / sizeof(unroll_factors[0]))
+#define NUM_ACC (int)(sizeof(accumulator_counts) / sizeof(accumulator_counts[0]))
+
+typedef struct {
+    const UnrollKernel *k;
+    const double *a;
+    long n;
+    double sum;
+} UnrollRun;
+
+// Function to run one kernel (benchmark callback)
+void run_kernel(void *ctx) {
+    UnrollRun *r = ctx;
+    r->sum = r->k->sum(r->a, r->n);
+}
+
+// Function to find the kernel of one table cell (NULL when A > U)
+const UnrollKernel *find_kernel(int u, int acc) {
+    for (int i = 0; i < NUM_KERNELS; i++) {
+        if (kernels[i].unroll == u && kernels[i].accumulators == acc)
+            return &kernels[i];
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=6: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 7 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 7) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + a[i+4] + a[i+5] + a[i+6];
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    long n = N;
+    if (argc > 1) {
+        n = atol(argv[1]);
+        if (n <= 0) {
+            fprintf(stderr, "Invalid size\n");
+            return EXIT_FAILURE;
         }
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=7: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 8 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 8) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + 
-                   a[i+4] + a[i+5] + a[i+6] + a[i+7];
-        }
+
+    double *a = malloc(n * sizeof(double));
+    if (!a) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=8: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 16 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 16) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + 
-                   a[i+4] + a[i+5] + a[i+6] + a[i+7] +
-                   a[i+8] + a[i+9] + a[i+10] + a[i+11] + 
-                   a[i+12] + a[i+13] + a[i+14] + a[i+15];
+
+    // Initialize array
+    for (long i = 0; i < n; i++)
+        a[i] = 1.0;
+
+    // Median of BENCH_REPS runs after BENCH_WARMUP warmup runs (the warmup also
+    // keeps the first kernel from paying for page faults)
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    double gbps[NUM_UNROLL][NUM_ACC];
+    double per_cycle[NUM_UNROLL][NUM_ACC];
+    int all_passed = 1;
+
+    for (int u = 0; u < NUM_UNROLL; u++) {
+        for (int c = 0; c < NUM_ACC; c++) {
+            const UnrollKernel *k = find_kernel(unroll_factors[u], accumulator_counts[c]);
+            gbps[u][c] = per_cycle[u][c] = -1.0;
+            if (!k)
+                continue;
+
+            UnrollRun run = {k, a, n, 0.0};
+            bench_run("unroll", "", run_kernel, &run, &cfg, n, n * sizeof(double), &result);
+            gbps[u][c] = bench_gbps(&result);
+            per_cycle[u][c] = result.cycles > 0 ? n / result.cycles : -1.0;
+
+            // Every element is 1.0: the sum must be exactly n
+            if (run.sum != (double)n) {
+                printf("U=%d A=%d: Sum = %f, expected %ld\n", k->unroll, k->accumulators, run.sum, n);
+                all_passed = 0;
+            }
         }
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=16: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
-    // ========== U = 32 ==========
-    /*
-    start = (double)clock() / CLOCKS_PER_SEC;
-    for (iter = 0; iter < ITERATIONS; iter++) {
-        sum = 0.0;
-        for (i = 0; i < N; i += 32) {
-            sum += a[i] + a[i+1] + a[i+2] + a[i+3] + 
-                   a[i+4] + a[i+5] + a[i+6] + a[i+7] +
-                   a[i+8] + a[i+9] + a[i+10] + a[i+11] + 
-                   a[i+12] + a[i+13] + a[i+14] + a[i+15] +
-                   a[i+16] + a[i+17] + a[i+18] + a[i+19] + 
-                   a[i+20] + a[i+21] + a[i+22] + a[i+23] +
-                   a[i+24] + a[i+25] + a[i+26] + a[i+27] + 
-                   a[i+28] + a[i+29] + a[i+30] + a[i+31];
+
+    printf("=================================================================================\n");
+    printf("              LOOP UNROLLING: UNROLL FACTOR x ACCUMULATOR COUNT                  \n");
+    printf("=================================================================================\n");
+    printf("N:                   %ld (%.1f MB)\n", n, n * sizeof(double) / (1024.0 * 1024.0));
+    printf("Kernels:             %d, median of %d runs each\n", NUM_KERNELS, cfg.reps);
+    printf("=================================================================================\n\n");
+
+    for (int table = 0; table < 2; table++) {
+        printf("%s\n", table == 0 ? "Throughput (GB/s)" : "Elements per cycle (TSC)");
+        printf("%6s", "U \\ A");
+        for (int c = 0; c < NUM_ACC; c++)
+            printf(" %8d", accumulator_counts[c]);
+        printf("\n");
+        for (int u = 0; u < NUM_UNROLL; u++) {
+            printf("%6d", unroll_factors[u]);
+            for (int c = 0; c < NUM_ACC; c++) {
+                double v = table == 0 ? gbps[u][c] : per_cycle[u][c];
+                if (v < 0.0)
+                    printf(" %8s", "-");
+                else
+                    printf(" %8.2f", v);
+            }
+            printf("\n");
         }
+        printf("\n");
     }
-    end = (double)clock() / CLOCKS_PER_SEC;
-    printf("U=32: Sum = %f, Time = %f ms\n", sum, (end - start) * 1000 / ITERATIONS);
-    */
-    
+    printf("=================================================================================\n");
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (every kernel sums to N)" : "✗ FAILED");
+
     free(a);
-    return 0;
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+// Build: gcc -O2 -fopenmp -I../../common reduction_bench.c ../../common/reduce.c ../../common/tune_profile.c ../../common/bench.c ../../common/perf_counters.c -lm -lpthread -o reduction_bench
+// Usage: ./reduction_bench [n] [--threads=T]   (default: N = 1M as in loop_unroll_manual.c, T = all CPUs)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "reduce.h"
+#include "bench.h"
+
+#define N 1000000
+
+// Unroll factors of loop_unroll_manual.c
+static const int unroll_factors[] = {1, 2, 3, 4, 5, 6, 7, 8, 16, 32};
+
+typedef struct {
+    const double *a;
+    long n;
+    int unroll;          // > 0: single-accumulator loop unrolled U times
+    ReduceMode mode;     // otherwise: library reduction in this mode
+    double sum;
+} ReduceRun;
+
+// Function to sum like loop_unroll_manual.c: U elements per iteration, added
+// to one accumulator (the leftover elements are added one by one)
+static inline double sum_unrolled(const double *a, long n, int u) {
+    double sum = 0.0;
+    long i = 0;
+    for (; i + u <= n; i += u) {
+        double t = a[i];
+        #pragma GCC unroll 32
+        for (int j = 1; j < u; j++)
+            t += a[i + j];
+        sum += t;
+    }
+    for (; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+// Function to run one reduction (benchmark callback)
+void run_reduce(void *ctx) {
+    ReduceRun *r = ctx;
+    switch (r->unroll) {
+    case 0:  r->sum = reduce_sum(r->a, r->n, r->mode); break;
+    case 1:  r->sum = sum_unrolled(r->a, r->n, 1); break;
+    case 2:  r->sum = sum_unrolled(r->a, r->n, 2); break;
+    case 3:  r->sum = sum_unrolled(r->a, r->n, 3); break;
+    case 4:  r->sum = sum_unrolled(r->a, r->n, 4); break;
+    case 5:  r->sum = sum_unrolled(r->a, r->n, 5); break;
+    case 6:  r->sum = sum_unrolled(r->a, r->n, 6); break;
+    case 7:  r->sum = sum_unrolled(r->a, r->n, 7); break;
+    case 8:  r->sum = sum_unrolled(r->a, r->n, 8); break;
+    case 16: r->sum = sum_unrolled(r->a, r->n, 16); break;
+    default: r->sum = sum_unrolled(r->a, r->n, 32); break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long n = N;
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_num_procs();
+#endif
+
+    // Parse command-line arguments: [n] [--threads=T]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            max_threads = atoi(argv[i] + 10);
+            if (max_threads <= 0) {
+                fprintf(stderr, "Invalid thread count\n");
+                return EXIT_FAILURE;
+            }
+        } else {
+            n = atol(argv[i]);
+            if (n <= 0) {
+                fprintf(stderr, "Invalid size\n");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+#ifndef _OPENMP
+    max_threads = 1;
+#endif
+
+    double *a = malloc(n * sizeof(double));
+    if (!a) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
+    }
+
+    // Random values instead of the lab's 1.0 so that the order of the
+    // additions shows in the low bits; __float128 gives the reference
+    srand(42); // Fixed seed for reproducibility
+    __float128 exact = 0;
+    for (long i = 0; i < n; i++) {
+        a[i] = (double)rand() / RAND_MAX;
+        exact += a[i];
+    }
+    double reference = (double)exact;
+
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    printf("=================================================================================\n");
+    printf("        REDUCTION: SINGLE ACCUMULATOR vs MULTI-ACCUMULATOR / THREADED            \n");
+    printf("=================================================================================\n");
+    printf("N:                   %ld (uniform [0,1), seed 42)\n", n);
+    printf("Kernel:              %s, %d accumulators, blocks of %d\n",
+           reduce_kernel_name(), REDUCE_ACCUMULATORS, REDUCE_BLOCK);
+    printf("Fast mode chains:    %d (ilp_bench --save profile, else the default)\n", reduce_fast_chains());
+    printf("Threads:             1..%d\n", max_threads);
+    printf("=================================================================================\n\n");
+
+    printf("%-20s %8s %12s %10s %9s %12s %8s\n", "Variant", "Threads", "Time (ms)", "GFLOPS",
+           "Speedup", "Rel error", "Same bits");
+    printf("---------------------------------------------------------------------------------\n");
+
+    double t_base = 0.0;
+    for (size_t u = 0; u < sizeof(unroll_factors) / sizeof(unroll_factors[0]); u++) {
+        ReduceRun run = {a, n, unroll_factors[u], REDUCE_FAST, 0.0};
+        bench_run("unroll", "", run_reduce, &run, &cfg, n, 8.0 * n, &result);
+        if (u == 0) t_base = result.median;
+
+        char name[32];
+        snprintf(name, sizeof(name), "U=%d", unroll_factors[u]);
+        printf("%-20s %8d %12.4f %10.2f %8.2fx %12.3e %8s\n", name, 1, result.median * 1000.0,
+               bench_gflops(&result), t_base / result.median,
+               fabs(run.sum - reference) / reference, "");
+    }
+
+    // A mode is reproducible when every thread count gives the bits of T = 1
+    int reproducible_ok = 1;
+    for (int mode = 0; mode < REDUCE_NUM_MODES; mode++) {
+        double first = 0.0;
+        for (int t = 1; t <= max_threads; t++) {
+#ifdef _OPENMP
+            omp_set_num_threads(t);
+#endif
+            ReduceRun run = {a, n, 0, (ReduceMode)mode, 0.0};
+            bench_run(reduce_mode_name(mode), "", run_reduce, &run, &cfg, n, 8.0 * n, &result);
+            if (t == 1) first = run.sum;
+
+            int same = memcmp(&run.sum, &first, sizeof(double)) == 0;
+            if (mode != REDUCE_FAST) reproducible_ok &= same;
+            printf("%-20s %8d %12.4f %10.2f %8.2fx %12.3e %8s\n", reduce_mode_name(mode), t,
+                   result.median * 1000.0, bench_gflops(&result), t_base / result.median,
+                   fabs(run.sum - reference) / reference, same ? "yes" : "no");
+        }
+    }
+    printf("=================================================================================\n");
+    printf("Reproducibility: %s\n", reproducible_ok ?
+           "✓ PASSED (reproducible and compensated give the same bits for every T)" : "✗ FAILED");
+
+    free(a);
+    return reproducible_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+// Build: gcc -O2 -I../../common ilp_bench.c ../../common/ilp.c ../../common/tune_profile.c ../../common/bench.c ../../common/perf_counters.c -lm -lpthread -o ilp_bench
+// Usage: ./ilp_bench [--iters=N] [--save]
+//   --save  store latency, throughput and saturating chain count per op and
+//           width in the machine profile (REDUCE_FAST picks its chains from it)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ilp.h"
+#include "tune_profile.h"
+
+// Function to store every measured op / width in the machine profile
+int save_profile(IlpResult results[ILP_NUM_OPS][ILP_NUM_WIDTHS])
+{
+    char path[768];
+    TuneProfile profile;
+    tune_profile_path(path, sizeof(path));
+    if (!tune_profile_load(&profile)) {
+        memset(&profile, 0, sizeof(profile));
+        tune_cpu_name(profile.cpu, sizeof(profile.cpu));
+    }
+
+    for (int op = 0; op < ILP_NUM_OPS; op++) {
+        for (int w = 0; w < ILP_NUM_WIDTHS; w++) {
+            const IlpResult *r = &results[op][w];
+            if (r->chains == 0)
+                continue;
+            TuneIlpEntry e;
+            memset(&e, 0, sizeof(e));
+            snprintf(e.op, sizeof(e.op), "%s", ilp_op_name(op));
+            snprintf(e.width, sizeof(e.width), "%s", ilp_width_name(w));
+            e.latency = r->latency;
+            e.throughput = r->throughput;
+            e.chains = r->chains;
+            tune_profile_set_ilp(&profile, &e);
+        }
+    }
+    if (!tune_profile_save(&profile))
+        return 0;
+
+    printf("ILP results saved to %s (used by REDUCE_FAST)\n", path);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    long iterations = ILP_DEFAULT_ITERATIONS;
+    int save = 0;
+
+    // Parse command-line arguments: [--iters=N] [--save]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--iters=", 8) == 0) {
+            iterations = atol(argv[i] + 8);
+            if (iterations <= 0) {
+                fprintf(stderr, "Invalid iteration count\n");
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--save") == 0) {
+            save = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--iters=N] [--save]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char cpu[128];
+    tune_cpu_name(cpu, sizeof(cpu));
+
+    printf("=================================================================================\n");
+    printf("              FP LATENCY / THROUGHPUT vs INDEPENDENT CHAINS                      \n");
+    printf("=================================================================================\n");
+    printf("CPU:                 %s\n", cpu);
+    printf("Chains:              1..%d, %ld dependent steps each, best of %d runs\n",
+           ILP_MAX_CHAINS, iterations, ILP_REPS);
+    printf("Unit:                TSC cycles\n");
+    printf("Registers:           %d chains + 2 constants fill the 16 vector registers (no spills)\n",
+           ILP_MAX_CHAINS);
+    printf("sqrt:                constant %.6f input via (x AND 0) OR c: latency includes 2 logic ops\n",
+           ILP_SQRT_INPUT);
+    printf("=================================================================================\n\n");
+
+    IlpResult results[ILP_NUM_OPS][ILP_NUM_WIDTHS];
+    for (int w = 0; w < ILP_NUM_WIDTHS; w++) {
+        for (int op = 0; op < ILP_NUM_OPS; op++)
+            ilp_measure(op, w, iterations, &results[op][w]);
+
+        printf("Instructions per cycle, %s\n", ilp_width_name(w));
+        printf("%6s", "Chains");
+        for (int op = 0; op < ILP_NUM_OPS; op++)
+            printf(" %8s", ilp_op_name(op));
+        printf("\n");
+        for (int c = 1; c <= ILP_MAX_CHAINS; c++) {
+            printf("%6d", c);
+            for (int op = 0; op < ILP_NUM_OPS; op++) {
+                if (!ilp_supported(op, w))
+                    printf(" %8s", "-");
+                else
+                    printf(" %8.2f", ilp_throughput_at(&results[op][w], c));
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+
+    printf("%-6s %-7s %12s %14s %12s %8s\n", "Op", "Width", "Latency", "Instr/cycle", "FLOP/cycle", "Chains");
+    printf("---------------------------------------------------------------------------------\n");
+    for (int op = 0; op < ILP_NUM_OPS; op++) {
+        for (int w = 0; w < ILP_NUM_WIDTHS; w++) {
+            const IlpResult *r = &results[op][w];
+            if (!ilp_supported(op, w)) {
+                printf("%-6s %-7s %12s\n", ilp_op_name(op), ilp_width_name(w), "not supported");
+                continue;
+            }
+            printf("%-6s %-7s %12.2f %14.2f %12.2f %8d\n", ilp_op_name(op), ilp_width_name(w),
+                   r->latency, r->throughput, r->throughput * ilp_flops_per_instruction(op, w),
+                   r->chains);
+        }
+    }
+    printf("=================================================================================\n");
+
+    // exercice3.c runs two scalar FMA chains (x and y)
+    const IlpResult *fma = &results[ILP_FMA][ILP_SCALAR];
+    if (fma->throughput > 0.0) {
+        printf("exercice3.c (2 scalar FMA chains): %.0f%% of the scalar FMA peak, %d chains reach it\n",
+               100.0 * ilp_throughput_at(fma, 2) / fma->throughput, fma->chains);
+    }
+
+    if (save && !save_profile(results))
+        return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+// Build: gcc -O2 -I../../common exercice3_fused.c ../../common/pipeline.c ../../common/cache_info.c ../../common/bench.c ../../common/perf_counters.c -lm -lpthread -o exercice3_fused
+// Usage: ./exercice3_fused [n ...]   (default: 5M 10M 100M, the sizes profiled with callgrind)
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pipeline.h"
+#include "bench.h"
+
+// Sizes compared when none are given on the command line
+static const long default_sizes[] = {5000000, 10000000, 100000000};
+
+typedef struct
+{
+    long n;
+    double sum;
+} Workload;
+
+// The four stages of exercice3.c, with N as a parameter
+void add_noise(double *a, long n)
+{
+    a[0] = 1.0;
+    for (long i = 1; i < n; i++) {
+        a[i] = a[i - 1] * 1.0000001;
+    }
+}
+
+void init_b(double *b, long n)
+{
+    for (long i = 0; i < n; i++) {
+        b[i] = i * 0.5;
+    }
+}
+
+void compute_addition(double *a, double *b, double *c, long n)
+{
+    for (long i = 0; i < n; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+double reduction(double *c, long n)
+{
+    double sum = 0.0;
+    for (long i = 0; i < n; i++) {
+        sum += c[i];
+    }
+    return sum;
+}
+
+// Function to run the original program: three full arrays, four passes
+// (benchmark callback; allocation and page faults are part of the cost)
+void run_unfused(void *ctx)
+{
+    Workload *w = ctx;
+    double *a = malloc(w->n * sizeof(double));
+    double *b = malloc(w->n * sizeof(double));
+    double *c = malloc(w->n * sizeof(double));
+    if (!a || !b || !c)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    add_noise(a, w->n);
+    init_b(b, w->n);
+    compute_addition(a, b, c, w->n);
+    w->sum = reduction(c, w->n);
+
+    free(a);
+    free(b);
+    free(c);
+}
+
+// Function to run the same stages fused over L2-sized chunks; c only ever
+// exists as one chunk because nothing but its sum is consumed
+void run_fused(void *ctx)
+{
+    Workload *w = ctx;
+    Pipeline p;
+    NoiseStage noise = {0, 1.0, 1.0000001, 0.0};
+    RampStage ramp = {1, 0.5};
+    AddStage add = {0, 1, 2};
+    SumStage sum = {2, 0.0};
+
+    pipeline_init(&p, w->n, 3, 0);
+    pipeline_add_stage(&p, "add_noise", pipeline_stage_noise, &noise);
+    pipeline_add_stage(&p, "init_b", pipeline_stage_ramp, &ramp);
+    pipeline_add_stage(&p, "compute_addition", pipeline_stage_add, &add);
+    pipeline_add_stage(&p, "reduction", pipeline_stage_sum, &sum);
+    pipeline_run(&p);
+    pipeline_free(&p);
+
+    w->sum = sum.sum;
+}
+
+int main(int argc, char *argv[])
+{
+    long sizes[16];
+    int num_sizes = 0;
+
+    // Parse command-line arguments: [n ...]
+    for (int i = 1; i < argc && num_sizes < 16; i++)
+    {
+        sizes[num_sizes] = atol(argv[i]);
+        if (sizes[num_sizes] <= 0)
+        {
+            fprintf(stderr, "Invalid size: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        num_sizes++;
+    }
+    if (num_sizes == 0)
+    {
+        num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+        for (int i = 0; i < num_sizes; i++)
+            sizes[i] = default_sizes[i];
+    }
+
+    BenchConfig cfg;
+    BenchResult unfused, fused;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    long chunk = pipeline_chunk_for_cache(3);
+
+    printf("=================================================================================\n");
+    printf("              FUSED STREAMING PIPELINE vs FOUR FULL PASSES                       \n");
+    printf("=================================================================================\n");
+    printf("Stages:              add_noise -> init_b -> compute_addition -> reduction\n");
+    printf("Chunk:               %ld elements x 3 buffers = %.0f KB (half of L2)\n",
+           chunk, 3.0 * chunk * sizeof(double) / 1024.0);
+    printf("Timing:              median of %d runs, allocation included\n", cfg.reps);
+    printf("=================================================================================\n\n");
+
+    printf("%12s | %12s %10s | %12s %10s | %8s %10s %6s\n", "N", "Unfused MB", "Time (s)",
+           "Fused KB", "Time (s)", "Speedup", "Footprint", "Sum");
+    printf("---------------------------------------------------------------------------------\n");
+
+    int all_passed = 1;
+    for (int s = 0; s < num_sizes; s++)
+    {
+        long n = sizes[s];
+        Workload w_unfused = {n, 0.0}, w_fused = {n, 0.0};
+
+        bench_run("unfused", "", run_unfused, &w_unfused, &cfg, 0, 0, &unfused);
+        bench_run("fused", "", run_fused, &w_fused, &cfg, 0, 0, &fused);
+
+        // Same products and additions in the same order: the sums must be identical
+        int ok = w_unfused.sum == w_fused.sum;
+        all_passed &= ok;
+
+        double unfused_bytes = 3.0 * n * sizeof(double);
+        long fused_chunk = chunk < n ? chunk : n;
+        double fused_bytes = 3.0 * fused_chunk * sizeof(double);
+        printf("%12ld | %12.1f %10.4f | %12.1f %10.4f | %7.2fx %9.0fx %6s\n", n,
+               unfused_bytes / (1024.0 * 1024.0), unfused.median, fused_bytes / 1024.0, fused.median,
+               unfused.median / fused.median, unfused_bytes / fused_bytes, ok ? "✓" : "✗");
+    }
+    printf("=================================================================================\n");
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (fused sum == unfused sum, bit for bit)" : "✗ FAILED");
+
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,236 @@
+// Build: gcc -O2 -I../../common exercice3_pages.c ../../common/mem_policy.c ../../common/bench.c ../../common/perf_counters.c -lm -lpthread -o exercice3_pages
+// Usage: ./exercice3_pages [n] [--pages=default|4k|thp|hugetlb] [--numa=default|local|interleave]
+//        (default: N = 100M, the 2.4 GB run, under every page policy; --pages= runs one)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem_policy.h"
+#include "bench.h"
+
+#define DEFAULT_N 100000000L
+
+// Fresh mappings per policy; every phase reports its median
+#define REPEATS 3
+
+enum { PHASE_NOISE, PHASE_INIT_B, PHASE_ADD, PHASE_REDUCE, PHASE_INIT_B_WARM, NUM_PHASES };
+
+static const char *phase_names[NUM_PHASES] = {
+    "add_noise", "init_b", "compute_addition", "reduction", "init_b (warm)"
+};
+
+typedef struct
+{
+    double seconds[REPEATS];
+    long faults[REPEATS];
+    double dtlb[REPEATS];    // -1: not counted
+} PhaseRuns;
+
+// The four stages of exercice3.c, with N as a parameter
+void add_noise(double *a, long n)
+{
+    a[0] = 1.0;
+    for (long i = 1; i < n; i++) {
+        a[i] = a[i - 1] * 1.0000001;
+    }
+}
+
+void init_b(double *b, long n)
+{
+    for (long i = 0; i < n; i++) {
+        b[i] = i * 0.5;
+    }
+}
+
+void compute_addition(double *a, double *b, double *c, long n)
+{
+    for (long i = 0; i < n; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+double reduction(double *c, long n)
+{
+    double sum = 0.0;
+    for (long i = 0; i < n; i++) {
+        sum += c[i];
+    }
+    return sum;
+}
+
+double median3(const double *v)
+{
+    double a = v[0], b = v[1], c = v[2];
+    if (a > b) { double t = a; a = b; b = t; }
+    if (b > c) { double t = b; b = c; c = t; }
+    return a > b ? a : b;
+}
+
+// Function to time one phase and count its page faults and dTLB misses
+void measure(PhaseRuns *p, int rep, PerfCounters *pc, int phase, double **arr, long n, double *sum)
+{
+    MemFaults f0, f1;
+    PerfSample s;
+
+    perf_counters_reset(pc);
+    mem_faults_read(&f0);
+    perf_counters_enable(pc);
+    double t0 = bench_now();
+    switch (phase) {
+    case PHASE_NOISE:       add_noise(arr[0], n); break;
+    case PHASE_INIT_B:
+    case PHASE_INIT_B_WARM: init_b(arr[1], n); break;
+    case PHASE_ADD:         compute_addition(arr[0], arr[1], arr[2], n); break;
+    case PHASE_REDUCE:      *sum = reduction(arr[2], n); break;
+    }
+    p->seconds[rep] = bench_now() - t0;
+    perf_counters_disable(pc);
+    mem_faults_read(&f1);
+    perf_counters_read(pc, &s);
+
+    p->faults[rep] = f1.minor - f0.minor + f1.major - f0.major;
+    p->dtlb[rep] = perf_sample_has(&s, PERF_DTLB_MISSES) ? (double)s.value[PERF_DTLB_MISSES] : -1.0;
+}
+
+int main(int argc, char *argv[])
+{
+    long n = DEFAULT_N;
+    MemPolicy policy;
+    int one_policy = 0;
+
+    mem_policy_default(&policy);
+
+    // Parse command-line arguments: [n] [--pages=P] [--numa=P]
+    for (int i = 1; i < argc; i++)
+    {
+        int used = mem_policy_parse_arg(&policy, argv[i]);
+        if (used < 0)
+            return EXIT_FAILURE;
+        if (used > 0)
+        {
+            one_policy |= strncmp(argv[i], "--pages=", 8) == 0;
+            continue;
+        }
+        n = atol(argv[i]);
+        if (n <= 1)
+        {
+            fprintf(stderr, "Invalid size: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    PagePolicy pages[PAGES_NUM_POLICIES];
+    int num_pages = 0;
+    if (one_policy)
+        pages[num_pages++] = policy.pages;
+    else
+        for (int p = 0; p < PAGES_NUM_POLICIES; p++)
+            pages[num_pages++] = (PagePolicy)p;
+
+    PerfCounters pc;
+    int counters = perf_counters_open(&pc);
+    size_t bytes = n * sizeof(double);
+
+    printf("=================================================================================\n");
+    printf("        PAGE SIZE AND NUMA PLACEMENT OF THE EXERCICE 3 ARRAYS                    \n");
+    printf("=================================================================================\n");
+    printf("Arrays:              a, b, c of N = %ld doubles (3 x %.0f MB)\n", n, bytes / 1e6);
+    printf("NUMA:                %s (%d memory node%s)\n", numa_policy_name(policy.numa),
+           mem_numa_nodes(), mem_numa_nodes() > 1 ? "s" : "");
+    printf("dTLB misses:         %s\n", counters > 0 ? "perf_event_open" : pc.reason);
+    printf("Timing:              median of %d fresh mappings per policy\n", REPEATS);
+    printf("=================================================================================\n\n");
+
+    printf("%-8s %-14s %-17s %10s %10s %9s %11s\n", "Pages", "Backing", "Phase", "Time (ms)",
+           "Faults", "ns/elem", "dTLB/kelem");
+    printf("---------------------------------------------------------------------------------\n");
+
+    double first_sum = 0.0;
+    int all_passed = 1;
+    double init_ms[PAGES_NUM_POLICIES] = {0.0};
+    long init_faults[PAGES_NUM_POLICIES] = {0};
+
+    for (int k = 0; k < num_pages; k++)
+    {
+        MemPolicy p = {pages[k], policy.numa};
+        PhaseRuns runs[NUM_PHASES];
+        char backing[32] = "";
+        int numa_applied = 1;
+        double sum = 0.0;
+
+        for (int rep = 0; rep < REPEATS; rep++)
+        {
+            MemRegion r[3];
+            double *arr[3];
+            for (int i = 0; i < 3; i++)
+            {
+                if (!mem_region_alloc(&r[i], bytes, &p))
+                {
+                    fprintf(stderr, "Memory allocation failed\n");
+                    return EXIT_FAILURE;
+                }
+                arr[i] = r[i].data;
+                numa_applied &= policy.numa == NUMA_DEFAULT || r[i].numa_applied;
+            }
+
+            for (int ph = 0; ph < NUM_PHASES; ph++)
+                measure(&runs[ph], rep, &pc, ph, arr, n, &sum);
+
+            if (rep == 0)
+                mem_region_backing(&r[1], backing, sizeof(backing));
+            for (int i = 0; i < 3; i++)
+                mem_region_free(&r[i]);
+        }
+
+        if (k == 0)
+            first_sum = sum;
+        int ok = sum == first_sum;
+        all_passed &= ok;
+
+        for (int ph = 0; ph < NUM_PHASES; ph++)
+        {
+            double faults[REPEATS];
+            for (int rep = 0; rep < REPEATS; rep++)
+                faults[rep] = runs[ph].faults[rep];
+            double ms = median3(runs[ph].seconds) * 1e3;
+            double dtlb = median3(runs[ph].dtlb);
+            char dtlb_text[16];
+            if (dtlb < 0)
+                snprintf(dtlb_text, sizeof(dtlb_text), "n/a");
+            else
+                snprintf(dtlb_text, sizeof(dtlb_text), "%.3f", dtlb / n * 1e3);
+
+            printf("%-8s %-14s %-17s %10.1f %10.0f %9.3f %11s\n", ph == 0 ? page_policy_name(pages[k]) : "",
+                   ph == 0 ? backing : "", phase_names[ph], ms, median3(faults), ms * 1e6 / n, dtlb_text);
+            if (ph == PHASE_INIT_B)
+            {
+                init_ms[pages[k]] = ms;
+                init_faults[pages[k]] = (long)median3(faults);
+            }
+        }
+        if (!numa_applied)
+            printf("%-8s (mbind refused the %s policy)\n", "", numa_policy_name(policy.numa));
+        printf("%-8s sum=%f %s\n", "", sum, ok ? "✓" : "✗ differs");
+        printf("---------------------------------------------------------------------------------\n");
+    }
+
+    // First touch of b (init_b) against 4 KB pages
+    if (!one_policy && init_ms[PAGES_4K] > 0.0)
+    {
+        printf("\ninit_b first touch vs 4k:\n");
+        for (int k = 0; k < num_pages; k++)
+        {
+            if (pages[k] == PAGES_4K)
+                continue;
+            printf("  %-8s %8.1f ms vs %8.1f ms (%.2fx), %ld vs %ld faults\n", page_policy_name(pages[k]),
+                   init_ms[pages[k]], init_ms[PAGES_4K], init_ms[PAGES_4K] / init_ms[pages[k]],
+                   init_faults[pages[k]], init_faults[PAGES_4K]);
+        }
+    }
+
+    printf("=================================================================================\n");
+    printf("Results: %s\n", all_passed ? "✓ same sum under every policy" : "✗ sums differ");
+
+    perf_counters_close(&pc);
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
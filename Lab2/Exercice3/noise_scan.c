@@ -0,0 +1,136 @@
+// Build: gcc -O2 -fopenmp -I../../common noise_scan.c ../../common/scan.c ../../common/bench.c ../../common/perf_counters.c -lm -lpthread -o noise_scan
+// Usage: ./noise_scan [n] [--threads=T]   (default: N = 100M, T = all CPUs)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "scan.h"
+#include "bench.h"
+
+#define N 100000000
+
+typedef struct
+{
+    double *a;
+    long n;
+    int variant;
+} ScanRun;
+
+enum { VARIANT_SERIAL, VARIANT_BLOCKED, VARIANT_POW };
+
+static const char *variant_names[] = {"serial (add_noise)", "blocked 2-pass scan", "closed form pow"};
+
+// Function to run one variant of the recurrence (benchmark callback)
+void run_scan(void *ctx)
+{
+    ScanRun *r = ctx;
+    switch (r->variant)
+    {
+    case VARIANT_SERIAL:
+        scan_mul_serial(r->a, r->n, 1.0, 1.0000001);
+        break;
+    case VARIANT_BLOCKED:
+        scan_mul_blocked(r->a, r->n, 1.0, 1.0000001);
+        break;
+    default:
+        scan_mul_pow(r->a, r->n, 1.0, 1.0000001);
+        break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long n = N;
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_num_procs();
+#endif
+
+    // Parse command-line arguments: [n] [--threads=T]
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--threads=", 10) == 0)
+        {
+            max_threads = atoi(argv[i] + 10);
+            if (max_threads <= 0)
+            {
+                fprintf(stderr, "Invalid thread count\n");
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            n = atol(argv[i]);
+            if (n <= 0)
+            {
+                fprintf(stderr, "Invalid size\n");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+#ifndef _OPENMP
+    max_threads = 1;
+#endif
+
+    double *ref = malloc(n * sizeof(double));
+    double *a = malloc(n * sizeof(double));
+    if (!ref || !a)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    memset(a, 0, n * sizeof(double));
+
+    BenchConfig cfg;
+    BenchResult result;
+    bench_default_config(&cfg);
+    cfg.counters = 0;
+
+    printf("=================================================================================\n");
+    printf("           PARALLEL MULTIPLICATIVE SCAN: a[i] = a[i-1] * 1.0000001               \n");
+    printf("=================================================================================\n");
+    printf("N:                   %ld (%.1f MB per array)\n", n, n * sizeof(double) / (1024.0 * 1024.0));
+    printf("Threads:             1..%d\n", max_threads);
+    printf("In-block kernel:     %s, %d lanes\n", scan_kernel_name(), SCAN_SIMD_WIDTH);
+    printf("Error bound:         %.3e relative (2N+4 unit roundoffs)\n", scan_error_bound(n));
+    printf("=================================================================================\n\n");
+
+    ScanRun serial = {ref, n, VARIANT_SERIAL};
+    bench_run("serial", "", run_scan, &serial, &cfg, n, 8.0 * n, &result);
+    double t_serial = result.median;
+
+    printf("%-22s %8s %12s %10s %9s %12s %7s\n", "Variant", "Threads", "Time (s)", "GB/s",
+           "Speedup", "Max rel dev", "Bound");
+    printf("---------------------------------------------------------------------------------\n");
+    printf("%-22s %8d %12.4f %10.2f %8.2fx %12s %7s\n", variant_names[VARIANT_SERIAL], 1,
+           t_serial, bench_gbps(&result), 1.0, "reference", "");
+
+    int all_passed = 1;
+    for (int variant = VARIANT_BLOCKED; variant <= VARIANT_POW; variant++)
+    {
+        for (int t = 1; t <= max_threads; t++)
+        {
+#ifdef _OPENMP
+            omp_set_num_threads(t);
+#endif
+            ScanRun run = {a, n, variant};
+            bench_run(variant_names[variant], "", run_scan, &run, &cfg, n, 8.0 * n, &result);
+
+            double dev = scan_max_rel_error(a, ref, n);
+            int ok = dev <= scan_error_bound(n);
+            all_passed &= ok;
+            printf("%-22s %8d %12.4f %10.2f %8.2fx %12.3e %7s\n", variant_names[variant], t,
+                   result.median, bench_gbps(&result), t_serial / result.median, dev, ok ? "✓" : "✗");
+        }
+    }
+    printf("=================================================================================\n");
+    printf("Verification: %s\n", all_passed ? "✓ PASSED (every variant within the error bound)" : "✗ FAILED");
+
+    free(ref);
+    free(a);
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
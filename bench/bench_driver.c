@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "bench_kernels.h"
+#include "roofline.h"
+
+// Function to print usage
+void print_usage(const char *prog) {
+    printf("Usage: %s [--list] [--filter=GLOB[,GLOB...]] [--size=N]\n", prog);
+    printf("          [--warmup=W] [--reps=R] [--csv=FILE] [--json=FILE] [--roofline[=FILE]]\n");
+    printf("  --filter  kernels to run, e.g. 'mxm.*' or 'stride.*,unroll.u4' (default: all)\n");
+    printf("  --roofline  measure peak FMA and L1/L2/LLC/DRAM triad bandwidth, place every\n");
+    printf("            kernel under its ceiling (CSV for plot_roofline.py, default roofline.csv)\n");
+    printf("  BENCH_COUNTERS=0 disables the hardware counters (IPC, misses per kflop)\n");
+    printf("  --size    problem size for every selected kernel (default: per kernel)\n");
+    printf("            n for matrix kernels, element count for vector kernels\n");
+}
+
+// Function to report where each kernel sits under the machine's roofline
+void report_roofline(const MachineRoof *roof, const BenchResult *results,
+                     const double *footprints, int count, const char *path) {
+    FILE *csv = fopen(path, "w");
+    if (!csv) {
+        perror(path);
+        return;
+    }
+    fprintf(csv, "kind,name,level,intensity,gflops,gbps,attainable,percent,measured_intensity\n");
+    fprintf(csv, "ceiling,peak,,,%.4f,,,,\n", roof->peak_gflops);
+    for (int l = 0; l < ROOF_NUM_LEVELS; l++) {
+        fprintf(csv, "ceiling,%s,%s,,,%.4f,,,\n", roofline_level_name(l),
+                roofline_level_name(l), roof->bandwidth[l]);
+    }
+
+    printf("\n%-24s %6s %10s %10s %10s %10s %8s %12s\n", "Kernel", "Level",
+           "AI (F/B)", "Roof", "Attainable", "Achieved", "% roof", "AI from LLC");
+    printf("--------------------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        if (r->flops <= 0 || r->bytes <= 0) {
+            printf("%-24s %6s %10s (no flop or traffic model)\n", r->name, "-", "-");
+            continue;
+        }
+        RoofLevel level = roofline_level_for_bytes(&roof->caches, footprints[i]);
+        double intensity = r->flops / r->bytes;
+        double attainable = roofline_attainable(roof, level, intensity);
+        double achieved = bench_gflops(r);
+        const char *bound = attainable < roof->peak_gflops ? "memory" : "compute";
+
+        // Intensity seen by DRAM, if LLC misses were counted
+        char measured[16] = "-";
+        double measured_ai = -1.0;
+        if (perf_sample_has(&r->counters, PERF_LLC_MISSES) && r->counters.value[PERF_LLC_MISSES] > 0) {
+            measured_ai = r->flops / (r->counters.value[PERF_LLC_MISSES] * (double)roof->caches.line);
+            snprintf(measured, sizeof(measured), "%.2f", measured_ai);
+        }
+
+        printf("%-24s %6s %10.3f %10s %10.2f %10.2f %7.1f%% %12s\n", r->name,
+               roofline_level_name(level), intensity, bound, attainable, achieved,
+               100.0 * achieved / attainable, measured);
+        fprintf(csv, "kernel,%s,%s,%.6f,%.4f,%.4f,%.4f,%.2f,", r->name, roofline_level_name(level),
+                intensity, achieved, bench_gbps(r), attainable, 100.0 * achieved / attainable);
+        if (measured_ai > 0) fprintf(csv, "%.6f", measured_ai);
+        fprintf(csv, "\n");
+    }
+    fclose(csv);
+    printf("Roofline data written to %s (plot with plot_roofline.py)\n", path);
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL;
+    const char *csv_path = NULL;
+    const char *json_path = NULL;
+    const char *roofline_path = NULL;
+    int size = 0;
+    int list = 0;
+    BenchConfig cfg;
+    bench_default_config(&cfg);
+
+    // Parse command-line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--list") == 0) {
+            list = 1;
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--size=", 7) == 0) {
+            size = atoi(argv[i] + 7);
+            if (size <= 0) {
+                fprintf(stderr, "Invalid size\n");
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            cfg.warmup = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--reps=", 7) == 0) {
+            cfg.reps = atoi(argv[i] + 7);
+            if (cfg.reps <= 0 || cfg.reps > BENCH_MAX_REPS) {
+                fprintf(stderr, "Invalid repetition count (1..%d)\n", BENCH_MAX_REPS);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            csv_path = argv[i] + 6;
+        } else if (strncmp(argv[i], "--json=", 7) == 0) {
+            json_path = argv[i] + 7;
+        } else if (strcmp(argv[i], "--roofline") == 0) {
+            roofline_path = "roofline.csv";
+        } else if (strncmp(argv[i], "--roofline=", 11) == 0) {
+            roofline_path = argv[i] + 11;
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    bench_register_all();
+
+    if (list) {
+        for (int i = 0; i < bench_kernel_count(); i++) {
+            const BenchKernel *k = bench_kernel_at(i);
+            if (bench_kernel_matches(k, filter)) {
+                printf("%-22s size=%-9d %s\n", k->name, k->default_size, k->description);
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    printf("==========================================================================================================================\n");
+    printf("                                              KERNEL BENCHMARK HARNESS\n");
+    printf("==========================================================================================================================\n");
+    printf("Selection:    %s\n", filter ? filter : "all kernels");
+    printf("Repetitions:  %d timed after %d warmup (CLOCK_MONOTONIC wall time)\n", cfg.reps, cfg.warmup);
+    printf("Cycles:       %s\n", bench_cycles_available() ? "TSC (reference cycles)" : "not available");
+    const char *reason = "";
+    int num_counters = cfg.counters ? bench_counters_available(&reason) : 0;
+    if (num_counters > 0) {
+        printf("Counters:     %d of %d hardware events (perf_event_open)\n", num_counters, PERF_NUM_EVENTS);
+    } else {
+        printf("Counters:     unavailable (%s)\n", cfg.counters ? reason : "BENCH_COUNTERS=0");
+    }
+    printf("==========================================================================================================================\n\n");
+
+    srand(42); // Fixed seed for reproducibility
+
+    BenchResult *results = malloc(bench_kernel_count() * sizeof(BenchResult));
+    double *footprints = malloc(bench_kernel_count() * sizeof(double));
+    if (!results || !footprints) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return EXIT_FAILURE;
+        }
+        bench_write_csv_header(csv);
+    }
+
+    int count = 0;
+    bench_print_header(stdout);
+    for (int i = 0; i < bench_kernel_count(); i++) {
+        const BenchKernel *k = bench_kernel_at(i);
+        if (!bench_kernel_matches(k, filter)) continue;
+        bench_run_kernel(k, size, &cfg, &results[count]);
+        int used = size > 0 ? size : k->default_size;
+        footprints[count] = k->footprint ? k->footprint(used, k->arg) : results[count].bytes;
+        bench_print_result(stdout, &results[count]);
+        fflush(stdout);
+        if (csv) {
+            bench_write_csv(csv, &results[count]);
+            fflush(csv);
+        }
+        count++;
+    }
+    printf("==========================================================================================================================\n");
+
+    if (count == 0) {
+        fprintf(stderr, "No kernel matches '%s' (see --list)\n", filter);
+    }
+    if (csv) {
+        fclose(csv);
+        printf("CSV written to %s\n", csv_path);
+    }
+    if (json_path) {
+        FILE *json = fopen(json_path, "w");
+        if (!json) {
+            perror(json_path);
+            return EXIT_FAILURE;
+        }
+        bench_write_json(json, results, count);
+        fclose(json);
+        printf("JSON written to %s\n", json_path);
+    }
+
+    if (roofline_path && count > 0) {
+        MachineRoof roof;
+        printf("\nMeasuring machine ceilings...\n");
+        roofline_measure(&roof);
+        roofline_print(&roof);
+        report_roofline(&roof, results, footprints, count, roofline_path);
+    }
+
+    free(results);
+    free(footprints);
+    return count > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
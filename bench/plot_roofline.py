@@ -0,0 +1,62 @@
+import csv
+import sys
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+# Usage: python3 plot_roofline.py [roofline.csv] [roofline.png]
+path = sys.argv[1] if len(sys.argv) > 1 else "roofline.csv"
+out = sys.argv[2] if len(sys.argv) > 2 else "roofline.png"
+
+# Read ceilings and kernels written by bench_driver --roofline
+peak = None
+bandwidths = {}
+kernels = []
+with open(path) as f:
+    for row in csv.DictReader(f):
+        if row["kind"] == "ceiling" and row["name"] == "peak":
+            peak = float(row["gflops"])
+        elif row["kind"] == "ceiling":
+            bandwidths[row["name"]] = float(row["gbps"])
+        else:
+            kernels.append(row)
+
+if peak is None or not bandwidths:
+    sys.exit("no ceilings in " + path)
+
+intensities = [float(k["intensity"]) for k in kernels] or [1.0]
+x = np.logspace(np.log10(min(intensities + [0.01]) / 2), np.log10(max(intensities + [100.0]) * 2), 200)
+
+fig, ax = plt.subplots(figsize=(11, 7))
+colors = {"L1": "tab:green", "L2": "tab:olive", "LLC": "tab:orange", "DRAM": "tab:red"}
+
+# One slanted roof per memory level, all capped by the FMA peak
+for level, bw in bandwidths.items():
+    ax.plot(x, np.minimum(peak, bw * x), color=colors.get(level, "gray"), linewidth=2,
+            label="%s %.1f GB/s" % (level, bw))
+ax.axhline(peak, color="black", linestyle="--", linewidth=1.5, label="FMA peak %.1f GFLOPS" % peak)
+
+# Kernels: colored by the level their data lives in, annotated with % of attainable
+for k in kernels:
+    ai = float(k["intensity"])
+    gflops = float(k["gflops"])
+    ax.scatter(ai, gflops, s=70, color=colors.get(k["level"], "gray"), edgecolor="black", zorder=5)
+    ax.annotate("%s (%.0f%%)" % (k["name"], float(k["percent"])), (ai, gflops),
+                textcoords="offset points", xytext=(6, 4), fontsize=8)
+    if k["measured_intensity"]:
+        mai = float(k["measured_intensity"])
+        ax.scatter(mai, gflops, s=40, marker="x", color="black", zorder=5)
+        ax.plot([ai, mai], [gflops, gflops], color="gray", linestyle=":", linewidth=1)
+
+ax.set_xscale("log")
+ax.set_yscale("log")
+ax.set_xlabel("Arithmetic intensity (flop/byte)", fontsize=12, fontweight='bold')
+ax.set_ylabel("Performance (GFLOPS)", fontsize=12, fontweight='bold')
+ax.set_title("Roofline: attainable vs achieved (x = intensity from LLC misses)",
+             fontsize=13, fontweight='bold')
+ax.grid(True, which="both", alpha=0.3)
+ax.legend(fontsize=9, loc="lower right")
+
+plt.tight_layout()
+plt.savefig(out, dpi=150)
+print("Saved", out)
@@ -0,0 +1,14 @@
+#!/bin/bash
+# Build the benchmark driver and run a kernel selection.
+# Usage: ./run_bench.sh [driver options], e.g. ./run_bench.sh --filter='mxm.*' --size=1024
+
+COMMON_DIR="../common"
+COMMON_SRC="$COMMON_DIR/matrix.c $COMMON_DIR/arena.c $COMMON_DIR/mxm_kernels.c $COMMON_DIR/gemm.c $COMMON_DIR/ws_sched.c $COMMON_DIR/gemm_recursive.c $COMMON_DIR/tune_profile.c $COMMON_DIR/strassen.c $COMMON_DIR/bench.c $COMMON_DIR/perf_counters.c $COMMON_DIR/cache_info.c $COMMON_DIR/roofline.c $COMMON_DIR/pipeline.c $COMMON_DIR/scan.c $COMMON_DIR/reduce.c $COMMON_DIR/packed_b.c $COMMON_DIR/bench_kernels.c"
+
+gcc -O2 -fopenmp -I$COMMON_DIR -o bench_driver bench_driver.c $COMMON_SRC -lm -lpthread
+if [ $? -ne 0 ]; then
+    echo "✗ Compilation failed!"
+    exit 1
+fi
+
+./bench_driver --csv=bench_results.csv --json=bench_results.json "$@"
@@ -0,0 +1,162 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "affinity.h"
+
+static int ecore_flags[AFFINITY_MAX_CPUS];
+
+// Function to parse a Linux cpulist ("0-3,8,10-11") into flags
+static int parse_cpulist(const char *path, int *flags) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    char buf[1024];
+    int count = 0;
+    if (fgets(buf, sizeof(buf), f)) {
+        char *tok = strtok(buf, ",\n");
+        while (tok) {
+            int lo, hi;
+            if (sscanf(tok, "%d-%d", &lo, &hi) != 2) {
+                lo = hi = atoi(tok);
+            }
+            for (int c = lo; c <= hi && c < AFFINITY_MAX_CPUS; c++) {
+                if (c >= 0 && !flags[c]) {
+                    flags[c] = 1;
+                    count++;
+                }
+            }
+            tok = strtok(NULL, ",\n");
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+// Function to return the first hyperthread sibling of a CPU
+static int first_sibling(int cpu) {
+    char path[128];
+    int flags[AFFINITY_MAX_CPUS] = {0};
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+    if (!parse_cpulist(path, flags)) return cpu;
+    for (int c = 0; c < AFFINITY_MAX_CPUS; c++) {
+        if (flags[c]) return c;
+    }
+    return cpu;
+}
+
+// Function to parse an affinity mode name
+int affinity_parse_mode(const char *name) {
+    if (strcmp(name, "none") == 0) return AFFINITY_NONE;
+    if (strcmp(name, "compact") == 0) return AFFINITY_COMPACT;
+    if (strcmp(name, "scatter") == 0) return AFFINITY_SCATTER;
+    return -1;
+}
+
+// Function to return the name of an affinity mode
+const char* affinity_mode_name(AffinityMode mode) {
+    switch (mode) {
+        case AFFINITY_COMPACT: return "compact";
+        case AFFINITY_SCATTER: return "scatter";
+        default:               return "none";
+    }
+}
+
+// Function to detect the P-core / E-core topology
+void affinity_detect(CpuTopology *topo, AffinityMode mode) {
+    int online[AFFINITY_MAX_CPUS] = {0};
+    int pcore[AFFINITY_MAX_CPUS] = {0};
+
+    memset(topo, 0, sizeof(*topo));
+    memset(ecore_flags, 0, sizeof(ecore_flags));
+
+    topo->num_cpus = parse_cpulist("/sys/devices/system/cpu/online", online);
+    if (topo->num_cpus == 0) {
+        // No sysfs (e.g. some containers): assume CPUs 0..n-1 are usable
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        if (n < 1) n = 1;
+        if (n > AFFINITY_MAX_CPUS) n = AFFINITY_MAX_CPUS;
+        for (int c = 0; c < n; c++) online[c] = 1;
+        topo->num_cpus = (int)n;
+    }
+
+    topo->num_pcore_cpus = parse_cpulist("/sys/devices/cpu_core/cpus", pcore);
+    topo->num_ecore_cpus = parse_cpulist("/sys/devices/cpu_atom/cpus", ecore_flags);
+    topo->is_hybrid = topo->num_pcore_cpus > 0 && topo->num_ecore_cpus > 0;
+
+    // Non-hybrid machine: every online CPU counts as a P-core
+    if (!topo->is_hybrid) {
+        memset(ecore_flags, 0, sizeof(ecore_flags));
+        memcpy(pcore, online, sizeof(pcore));
+        topo->num_pcore_cpus = topo->num_cpus;
+        topo->num_ecore_cpus = 0;
+    }
+
+    int n = 0;
+    if (mode == AFFINITY_SCATTER) {
+        // Pass 1: one CPU per physical P-core, pass 2: E-cores, pass 3: P-core siblings
+        for (int c = 0; c < AFFINITY_MAX_CPUS; c++)
+            if (online[c] && pcore[c] && first_sibling(c) == c) topo->order[n++] = c;
+        for (int c = 0; c < AFFINITY_MAX_CPUS; c++)
+            if (online[c] && ecore_flags[c]) topo->order[n++] = c;
+        for (int c = 0; c < AFFINITY_MAX_CPUS; c++)
+            if (online[c] && pcore[c] && first_sibling(c) != c) topo->order[n++] = c;
+    } else {
+        // Compact (and none): P-cores in id order, then E-cores
+        for (int c = 0; c < AFFINITY_MAX_CPUS; c++)
+            if (online[c] && pcore[c]) topo->order[n++] = c;
+        for (int c = 0; c < AFFINITY_MAX_CPUS; c++)
+            if (online[c] && ecore_flags[c]) topo->order[n++] = c;
+    }
+    topo->order_len = n;
+}
+
+// Function to print the detected topology
+void affinity_print(const CpuTopology *topo) {
+    printf("Logical CPUs:        %d", topo->num_cpus);
+    if (topo->is_hybrid) {
+        printf(" (%d on P-cores, %d on E-cores)\n", topo->num_pcore_cpus, topo->num_ecore_cpus);
+    } else {
+        printf(" (no hybrid topology reported)\n");
+    }
+    printf("Placement order:    ");
+    for (int i = 0; i < topo->order_len; i++) {
+        printf(" %d%s", topo->order[i], affinity_is_ecore(topo->order[i]) ? "e" : "");
+    }
+    printf("\n");
+}
+
+// Function to pin each OpenMP thread to one CPU
+void affinity_pin_threads(const CpuTopology *topo, AffinityMode mode) {
+    if (mode == AFFINITY_NONE || topo->order_len == 0) return;
+
+#ifdef _OPENMP
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num();
+#else
+    {
+        int t = 0;
+#endif
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(topo->order[t % topo->order_len], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            perror("sched_setaffinity");
+        }
+    }
+}
+
+// Function to check whether a CPU is an efficiency core
+int affinity_is_ecore(int cpu) {
+    if (cpu < 0 || cpu >= AFFINITY_MAX_CPUS) return 0;
+    return ecore_flags[cpu];
+}
@@ -0,0 +1,43 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+// Maximum number of logical CPUs tracked
+#define AFFINITY_MAX_CPUS 256
+
+// Thread placement policies for --affinity
+typedef enum {
+    AFFINITY_NONE = 0,  // leave placement to the OS
+    AFFINITY_COMPACT,   // fill P-cores (both hyperthreads) first, then E-cores
+    AFFINITY_SCATTER    // one thread per physical core first (P then E), then siblings
+} AffinityMode;
+
+// Hybrid topology as exposed by Linux (/sys/devices/cpu_core, /sys/devices/cpu_atom)
+typedef struct {
+    int num_cpus;                     // online logical CPUs
+    int num_pcore_cpus;               // logical CPUs on performance cores
+    int num_ecore_cpus;               // logical CPUs on efficiency cores
+    int is_hybrid;                    // 1 if both core types were found
+    int order[AFFINITY_MAX_CPUS];     // CPU ids in placement order
+    int order_len;
+} CpuTopology;
+
+// Parse "none", "compact" or "scatter"; returns -1 on unknown names
+int affinity_parse_mode(const char *name);
+
+// Name of a placement policy
+const char* affinity_mode_name(AffinityMode mode);
+
+// Detect the topology and build the placement order for a policy
+void affinity_detect(CpuTopology *topo, AffinityMode mode);
+
+// Print a one-paragraph topology summary
+void affinity_print(const CpuTopology *topo);
+
+// Pin every thread of the OpenMP team: thread t -> topo->order[t % order_len].
+// libgomp keeps its pool, so later parallel regions of the same size stay pinned.
+void affinity_pin_threads(const CpuTopology *topo, AffinityMode mode);
+
+// Is this CPU id an efficiency core?
+int affinity_is_ecore(int cpu);
+
+#endif
@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "arena.h"
+
+// Header in front of every arena chunk and pool block (one cache line, so
+// the payload keeps the 64-byte alignment)
+#define MEM_HEADER MATRIX_ALIGNMENT
+
+struct ArenaChunk {
+    ArenaChunk *prev;
+    size_t size;             // payload bytes
+    size_t used;
+};
+
+typedef struct PoolBlock {
+    int size_class;          // -1: exact size, never cached
+    size_t bytes;            // requested size
+    struct PoolBlock *next;  // free list (or live list under MEM_DEBUG)
+    struct PoolBlock *prev;
+    const char *file;
+    int line;
+} PoolBlock;
+
+_Static_assert(sizeof(struct ArenaChunk) <= MEM_HEADER, "arena header too large");
+_Static_assert(sizeof(PoolBlock) <= MEM_HEADER, "pool header too large");
+
+static pthread_mutex_t mem_lock = PTHREAD_MUTEX_INITIALIZER;
+static PoolBlock *free_lists[POOL_MAX_CLASS + 1];
+static size_t cached_bytes = 0;
+static int pool_enabled = 1;
+
+static MemStats stats;
+static atomic_long arena_allocs;
+static long live_blocks = 0;
+static long live_chunks = 0;
+static size_t live_chunk_bytes = 0;
+
+#ifdef MEM_DEBUG
+static PoolBlock *live_list = NULL;
+static int report_registered = 0;
+
+// Pool blocks the allocator still owns, keyed by address, so pool_free can
+// classify a pointer in O(1) without reading a header that may be freed
+// memory. Blocks given back to the system are removed.
+enum { BLOCK_UNKNOWN, BLOCK_LIVE, BLOCK_CACHED };
+
+typedef struct {
+    const PoolBlock *block;  // NULL: empty slot
+    int state;
+} TrackedBlock;
+
+static TrackedBlock *tracked = NULL;
+static size_t tracked_cap = 0;      // power of two
+static size_t tracked_count = 0;
+
+static size_t track_slot(const PoolBlock *b) {
+    return (size_t)(((uintptr_t)b >> 6) * 0x9E3779B97F4A7C15ULL) & (tracked_cap - 1);
+}
+
+// Function to find the slot of b, or the empty slot where it would go
+static size_t track_find(const PoolBlock *b) {
+    size_t i = track_slot(b);
+    while (tracked[i].block && tracked[i].block != b) i = (i + 1) & (tracked_cap - 1);
+    return i;
+}
+
+static int track_state(const PoolBlock *b) {
+    if (!tracked_cap) return BLOCK_UNKNOWN;
+    size_t i = track_find(b);
+    return tracked[i].block ? tracked[i].state : BLOCK_UNKNOWN;
+}
+
+// Function to record the state of b (caller holds mem_lock); the table is
+// kept at most half full so probes stay short
+static void track_set(const PoolBlock *b, int state) {
+    if (2 * (tracked_count + 1) > tracked_cap) {
+        TrackedBlock *old = tracked;
+        size_t old_cap = tracked_cap;
+        tracked_cap = old_cap ? 2 * old_cap : 1024;
+        tracked = calloc(tracked_cap, sizeof(TrackedBlock));
+        if (!tracked) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < old_cap; i++) {
+            if (old[i].block) tracked[track_find(old[i].block)] = old[i];
+        }
+        free(old);
+    }
+    size_t i = track_find(b);
+    if (!tracked[i].block) tracked_count++;
+    tracked[i].block = b;
+    tracked[i].state = state;
+}
+
+// Function to forget b (linear probing: shift the rest of its run back)
+static void track_remove(const PoolBlock *b) {
+    if (!tracked_cap) return;
+    size_t i = track_find(b);
+    if (!tracked[i].block) return;
+    tracked_count--;
+    for (size_t j = (i + 1) & (tracked_cap - 1); tracked[j].block; j = (j + 1) & (tracked_cap - 1)) {
+        size_t home = track_slot(tracked[j].block);
+        // Move j into the hole at i unless its home lies cyclically in (i, j]
+        if ((j > i && (home <= i || home > j)) || (j < i && home <= i && home > j)) {
+            tracked[i] = tracked[j];
+            i = j;
+        }
+    }
+    tracked[i].block = NULL;
+}
+
+static void report_at_exit(void) {
+    if (mem_report_leaks() > 0) {
+        fprintf(stderr, "mem: leaks found (see above)\n");
+    }
+}
+#endif
+
+// Function to allocate from the system (caller holds mem_lock)
+static void* system_alloc(size_t bytes) {
+    void *p = NULL;
+    if (posix_memalign(&p, MATRIX_ALIGNMENT, bytes) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    stats.system_allocs++;
+#ifdef MEM_DEBUG
+    if (!report_registered) {
+        atexit(report_at_exit);
+        report_registered = 1;
+    }
+#endif
+    return p;
+}
+
+static void system_free(void *p) {
+    free(p);
+    stats.system_frees++;
+}
+
+static void add_live(size_t bytes) {
+    stats.bytes_live += bytes;
+    if (stats.bytes_live > stats.bytes_peak) stats.bytes_peak = stats.bytes_live;
+}
+
+// ===== Arena =====
+
+void arena_init(Arena *a, size_t chunk_size) {
+    a->head = NULL;
+    a->chunk_size = chunk_size ? chunk_size : ARENA_CHUNK;
+}
+
+void* arena_alloc(Arena *a, size_t bytes) {
+    atomic_fetch_add_explicit(&arena_allocs, 1, memory_order_relaxed);
+    bytes = (bytes + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    if (bytes == 0) bytes = MATRIX_ALIGNMENT;
+
+    ArenaChunk *c = a->head;
+    if (!c || c->size - c->used < bytes) {
+        // The tail of the current chunk is left unused
+        size_t size = bytes > a->chunk_size ? bytes : a->chunk_size;
+        pthread_mutex_lock(&mem_lock);
+        c = system_alloc(MEM_HEADER + size);
+        live_chunks++;
+        live_chunk_bytes += size;
+        add_live(size);
+        pthread_mutex_unlock(&mem_lock);
+        c->prev = a->head;
+        c->size = size;
+        c->used = 0;
+        a->head = c;
+    }
+    void *p = (char*)c + MEM_HEADER + c->used;
+    c->used += bytes;
+    return p;
+}
+
+ArenaMark arena_mark(const Arena *a) {
+    ArenaMark m = {a->head, a->head ? a->head->used : 0};
+    return m;
+}
+
+// Function to pop chunks down to the mark; keep_first leaves the oldest chunk
+// (emptied) in place, so a run released back to its start does not go back
+// to the system for its next allocation
+static void release_to(Arena *a, ArenaMark mark, int keep_first) {
+    pthread_mutex_lock(&mem_lock);
+    while (a->head && a->head != mark.chunk) {
+        ArenaChunk *c = a->head;
+        if (keep_first && !c->prev) {
+            mark.used = 0;
+            break;
+        }
+        a->head = c->prev;
+        live_chunks--;
+        live_chunk_bytes -= c->size;
+        stats.bytes_live -= c->size;
+        system_free(c);
+    }
+    pthread_mutex_unlock(&mem_lock);
+    if (a->head) a->head->used = mark.used;
+}
+
+void arena_release(Arena *a, ArenaMark mark) {
+    release_to(a, mark, 1);
+}
+
+void arena_destroy(Arena *a) {
+    ArenaMark start = {NULL, 0};
+    release_to(a, start, 0);
+}
+
+Matrix arena_matrix(Arena *a, int rows, int cols, int padding) {
+    Matrix m;
+    m.rows = rows;
+    m.cols = cols;
+    m.ld = matrix_leading_dim(cols, padding);
+    m.owner = 0;
+    m.data = arena_alloc(a, (size_t)rows * m.ld * sizeof(double));
+    return m;
+}
+
+// ===== Pool =====
+
+// Function to find the smallest class holding 'bytes' (-1 past the largest)
+static int size_class(size_t bytes) {
+    int c = POOL_MIN_CLASS;
+    while (c <= POOL_MAX_CLASS && ((size_t)1 << c) < bytes) c++;
+    return c <= POOL_MAX_CLASS ? c : -1;
+}
+
+#ifdef MEM_DEBUG
+void* pool_alloc_at(size_t bytes, const char *file, int line) {
+#else
+void* pool_alloc(size_t bytes) {
+#endif
+    pthread_mutex_lock(&mem_lock);
+    stats.pool_allocs++;
+    int c = pool_enabled ? size_class(bytes) : -1;
+
+    PoolBlock *b = NULL;
+    if (c >= 0 && free_lists[c]) {
+        b = free_lists[c];
+        free_lists[c] = b->next;
+        cached_bytes -= (size_t)1 << c;
+        stats.pool_hits++;
+    } else {
+        size_t payload = c >= 0 ? (size_t)1 << c : (bytes ? bytes : 1);
+        b = system_alloc(MEM_HEADER + payload);
+    }
+    b->size_class = c;
+    b->bytes = bytes;
+    b->next = b->prev = NULL;
+    b->file = NULL;
+    b->line = 0;
+#ifdef MEM_DEBUG
+    b->file = file;
+    b->line = line;
+    b->next = live_list;
+    if (live_list) live_list->prev = b;
+    live_list = b;
+    track_set(b, BLOCK_LIVE);
+#endif
+    live_blocks++;
+    add_live(bytes);
+    pthread_mutex_unlock(&mem_lock);
+    return (char*)b + MEM_HEADER;
+}
+
+#ifdef MEM_DEBUG
+// Function to check that b is a live pool block before its header is touched
+// (caller holds mem_lock)
+static void check_live(const PoolBlock *b, const void *p) {
+    int state = track_state(b);
+    if (state == BLOCK_LIVE) return;
+    if (state == BLOCK_CACHED) {
+        // Cached by the pool, so its header is still ours to read
+        fprintf(stderr, "pool_free: double free of %p (%zu bytes", p, b->bytes);
+        if (b->file) fprintf(stderr, ", allocated at %s:%d", b->file, b->line);
+        fprintf(stderr, ")\n");
+    } else {
+        fprintf(stderr, "pool_free: %p is not a live pool block (already freed, or not from pool_alloc)\n", p);
+    }
+    pthread_mutex_unlock(&mem_lock);    // the exit-time leak report takes it
+    exit(EXIT_FAILURE);
+}
+#endif
+
+void pool_free(void *p) {
+    if (!p) return;
+    PoolBlock *b = (PoolBlock*)((char*)p - MEM_HEADER);
+
+    pthread_mutex_lock(&mem_lock);
+#ifdef MEM_DEBUG
+    check_live(b, p);
+    if (b->prev) b->prev->next = b->next;
+    else live_list = b->next;
+    if (b->next) b->next->prev = b->prev;
+#endif
+    live_blocks--;
+    stats.bytes_live -= b->bytes;
+
+    int c = b->size_class;
+    if (c >= 0 && pool_enabled && cached_bytes + ((size_t)1 << c) <= POOL_MAX_CACHED) {
+        b->next = free_lists[c];
+        free_lists[c] = b;
+        cached_bytes += (size_t)1 << c;
+#ifdef MEM_DEBUG
+        track_set(b, BLOCK_CACHED);
+#endif
+    } else {
+#ifdef MEM_DEBUG
+        track_remove(b);
+#endif
+        system_free(b);
+    }
+    pthread_mutex_unlock(&mem_lock);
+}
+
+void pool_trim(void) {
+    pthread_mutex_lock(&mem_lock);
+    for (int c = 0; c <= POOL_MAX_CLASS; c++) {
+        while (free_lists[c]) {
+            PoolBlock *b = free_lists[c];
+            free_lists[c] = b->next;
+#ifdef MEM_DEBUG
+            track_remove(b);
+#endif
+            system_free(b);
+        }
+    }
+    cached_bytes = 0;
+    pthread_mutex_unlock(&mem_lock);
+}
+
+void pool_set_enabled(int enable) {
+    if (!enable) pool_trim();
+    pthread_mutex_lock(&mem_lock);
+    pool_enabled = enable;
+    pthread_mutex_unlock(&mem_lock);
+}
+
+// ===== Statistics =====
+
+void mem_stats(MemStats *s) {
+    pthread_mutex_lock(&mem_lock);
+    *s = stats;
+    s->arena_allocs = atomic_load(&arena_allocs);
+    pthread_mutex_unlock(&mem_lock);
+}
+
+void mem_stats_reset(void) {
+    pthread_mutex_lock(&mem_lock);
+    size_t live = stats.bytes_live;
+    memset(&stats, 0, sizeof(stats));
+    stats.bytes_live = stats.bytes_peak = live;
+    atomic_store(&arena_allocs, 0);
+    pthread_mutex_unlock(&mem_lock);
+}
+
+int mem_report_leaks(void) {
+    pthread_mutex_lock(&mem_lock);
+    int count = 0;
+#ifdef MEM_DEBUG
+    for (PoolBlock *b = live_list; b; b = b->next) {
+        fprintf(stderr, "Leak: %zu bytes allocated at %s:%d\n", b->bytes, b->file, b->line);
+        count++;
+    }
+#else
+    if (live_blocks > 0) {
+        fprintf(stderr, "Leak: %ld pool blocks still live (build with -DMEM_DEBUG for their origin)\n",
+                live_blocks);
+        count += (int)live_blocks;
+    }
+#endif
+    if (live_chunks > 0) {
+        fprintf(stderr, "Leak: %ld arena chunks (%zu bytes) never released\n", live_chunks,
+                live_chunk_bytes);
+        count += (int)live_chunks;
+    }
+    pthread_mutex_unlock(&mem_lock);
+    return count;
+}
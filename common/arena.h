@@ -0,0 +1,101 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+// Allocation subsystem for the kernels and the tools:
+//
+//   Arena  bump allocation out of large chunks; everything allocated after a
+//          mark goes away with one arena_release (a whole benchmark run, a
+//          recursion level, ...), so nothing has to be paired by hand.
+//   Pool   size classes (powers of two) with free lists for temporaries that
+//          come and go with every call, such as GEMM packing buffers: after
+//          the first call they are recycled instead of going to malloc.
+//
+// Every block is MATRIX_ALIGNMENT (64-byte) aligned. Both exit on failure,
+// like allocate_matrix. Counters are always kept (mem_stats); building with
+// -DMEM_DEBUG also records where each pool block came from, checks every
+// pool_free against the live blocks and prints the blocks still live (and the
+// arena chunks never released) at exit, so a leak or a double free shows up
+// without Valgrind. Without MEM_DEBUG a bad pool_free is not detected.
+
+// ===== Arena =====
+
+// Default chunk size; a larger request gets a chunk of its own
+#define ARENA_CHUNK (1UL << 20)
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct {
+    ArenaChunk *head;        // newest chunk (chunks are linked newest first)
+    size_t chunk_size;
+} Arena;
+
+// Position to come back to with arena_release
+typedef struct {
+    ArenaChunk *chunk;
+    size_t used;
+} ArenaMark;
+
+void arena_init(Arena *a, size_t chunk_size);   // 0: ARENA_CHUNK
+void* arena_alloc(Arena *a, size_t bytes);
+ArenaMark arena_mark(const Arena *a);
+
+// Free everything allocated since the mark (the first chunk is kept for reuse)
+void arena_release(Arena *a, ArenaMark mark);
+
+// Free everything (the arena can be used again)
+void arena_destroy(Arena *a);
+
+// rows x cols matrix in the arena: a view as far as free_matrix is concerned
+// (owner == 0), released with the arena
+Matrix arena_matrix(Arena *a, int rows, int cols, int padding);
+
+// ===== Pool =====
+
+// Size classes 2^6 (64 B) .. 2^30 (1 GB); larger requests bypass the free lists
+#define POOL_MIN_CLASS 6
+#define POOL_MAX_CLASS 30
+
+// Bytes kept on the free lists; blocks freed past this go back to the system
+#define POOL_MAX_CACHED (512UL << 20)
+
+#ifdef MEM_DEBUG
+void* pool_alloc_at(size_t bytes, const char *file, int line);
+#define pool_alloc(bytes) pool_alloc_at((bytes), __FILE__, __LINE__)
+#else
+void* pool_alloc(size_t bytes);
+#endif
+
+// Return a block to its free list (NULL is ignored; under MEM_DEBUG a double
+// free or a foreign pointer exits)
+void pool_free(void *p);
+
+// Give every cached block back to the system
+void pool_trim(void);
+
+// 0: every pool_alloc / pool_free goes to the system (for comparisons)
+void pool_set_enabled(int enable);
+
+// ===== Statistics =====
+
+typedef struct {
+    long system_allocs;      // posix_memalign calls: pool misses, bypasses, arena chunks
+    long system_frees;
+    long pool_allocs;        // pool_alloc calls
+    long pool_hits;          // ... served from a free list
+    long arena_allocs;       // arena_alloc calls
+    size_t bytes_live;       // pool + arena bytes handed out and not released
+    size_t bytes_peak;
+} MemStats;
+
+void mem_stats(MemStats *s);
+void mem_stats_reset(void);  // zero the counters (live bytes are kept)
+
+// Print the live pool blocks (with their origin under MEM_DEBUG) and the
+// live arena chunks; returns how many there are
+int mem_report_leaks(void);
+
+#endif
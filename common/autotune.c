@@ -0,0 +1,191 @@
+#include <stdio.h>
+
+#include "autotune.h"
+#include "bench.h"
+
+// Candidate tile sizes, smallest first (the search walks upwards)
+static const int tile_m_candidates[] = {16, 32, 64, 128, 256};
+static const int tile_k_candidates[] = {16, 32, 64, 128, 256, 512};
+static const int tile_n_candidates[] = {64, 128, 256, 512, 1024, 2048};
+static const int unroll_candidates[] = {1, 2, 4, 8};
+
+// MC is kept a multiple of GEMM_MR and NC a multiple of GEMM_NR
+static const int gemm_mc_candidates[] = {24, 48, 72, 96, 120, 144, 192, 240, 288};
+static const int gemm_kc_candidates[] = {128, 192, 256, 320, 384, 512};
+static const int gemm_nc_candidates[] = {256, 512, 1024, 2048, 4080};
+
+#define COUNT(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+// Function to convert a time into GFLOPS for C += A * B
+static double gflops_of(const Matrix *A, const Matrix *C, double time_sec) {
+    return 2.0 * C->rows * C->cols * A->cols / time_sec / 1e9;
+}
+
+// Function to time the tiled kernel
+double autotune_time_tiled(const Matrix *A, const Matrix *B, Matrix *C, const TileConfig *t) {
+    double best = 1e30;
+    for (int r = 0; r < AUTOTUNE_REPS; r++) {
+        zero_matrix(C);
+        double start = bench_now();
+        matrix_multiply_tiled(A, B, C, t);
+        double elapsed = bench_now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return gflops_of(A, C, best);
+}
+
+// Function to time the packed GEMM engine
+double autotune_time_gemm(const Matrix *A, const Matrix *B, Matrix *C, const GemmParams *p) {
+    double best = 1e30;
+    for (int r = 0; r < AUTOTUNE_REPS; r++) {
+        zero_matrix(C);
+        double start = bench_now();
+        gemm_packed(A, B, C, p);
+        double elapsed = bench_now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return gflops_of(A, C, best);
+}
+
+// Function to walk one tile dimension upwards, keeping the best value.
+// Values past the matrix extent are pruned, and the walk stops after
+// AUTOTUNE_PATIENCE candidates in a row without improvement.
+static double descend_tiled(const Matrix *A, const Matrix *B, Matrix *C, TileConfig *cfg,
+                            int *field, const int *candidates, int count, int extent,
+                            double best_gflops, TuneStats *stats) {
+    int best_value = *field;
+    int misses = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (candidates[i] == best_value) continue;
+        if ((candidates[i] > extent && candidates[i] / 2 >= extent) || misses >= AUTOTUNE_PATIENCE) {
+            stats->pruned += count - i;
+            break;
+        }
+        *field = candidates[i];
+        double g = autotune_time_tiled(A, B, C, cfg);
+        stats->evaluations++;
+        if (g > best_gflops) {
+            best_gflops = g;
+            best_value = candidates[i];
+            misses = 0;
+        } else {
+            misses++;
+        }
+    }
+    *field = best_value;
+    return best_gflops;
+}
+
+// Tiled kernel search: orders, then unroll, then tile shape
+double autotune_tiled(const Matrix *A, const Matrix *B, Matrix *C,
+                      TileConfig *best, TuneStats *stats) {
+    double start = bench_now();
+    TileConfig cfg;
+    double order_gflops[NUM_LOOP_ORDERS];
+    double best_gflops = 0.0;
+
+    tile_default_config(&cfg);
+
+    // Stage 1: every loop order on the default tile shape
+    for (int o = 0; o < NUM_LOOP_ORDERS; o++) {
+        cfg.order = o;
+        order_gflops[o] = autotune_time_tiled(A, B, C, &cfg);
+        stats->evaluations++;
+        if (order_gflops[o] > best_gflops) {
+            best_gflops = order_gflops[o];
+            *best = cfg;
+        }
+    }
+
+    // Stage 2: unroll factors, only for orders within the cutoff of the best
+    // (and only ikj/kij have an unroll-and-jam variant)
+    for (int o = 0; o < NUM_LOOP_ORDERS; o++) {
+        if (order_gflops[o] < AUTOTUNE_ORDER_CUTOFF * best_gflops || (o != 1 && o != 4)) {
+            stats->pruned += COUNT(unroll_candidates) - 1;
+            continue;
+        }
+        cfg.order = o;
+        double prev = order_gflops[o];
+        for (int u = 1; u < COUNT(unroll_candidates); u++) {
+            cfg.unroll = unroll_candidates[u];
+            double g = autotune_time_tiled(A, B, C, &cfg);
+            stats->evaluations++;
+            if (g > best_gflops) {
+                best_gflops = g;
+                *best = cfg;
+            }
+            // Unrolling further rarely helps once it started to hurt
+            if (g < prev) {
+                stats->pruned += COUNT(unroll_candidates) - 1 - u;
+                break;
+            }
+            prev = g;
+        }
+        cfg.unroll = 1;
+    }
+
+    // Stage 3: coordinate descent over the tile shape (kc, then nc, then mc)
+    cfg = *best;
+    best_gflops = descend_tiled(A, B, C, &cfg, &cfg.kc, tile_k_candidates,
+                                COUNT(tile_k_candidates), A->cols, best_gflops, stats);
+    best_gflops = descend_tiled(A, B, C, &cfg, &cfg.nc, tile_n_candidates,
+                                COUNT(tile_n_candidates), C->cols, best_gflops, stats);
+    best_gflops = descend_tiled(A, B, C, &cfg, &cfg.mc, tile_m_candidates,
+                                COUNT(tile_m_candidates), C->rows, best_gflops, stats);
+    *best = cfg;
+
+    stats->seconds += bench_now() - start;
+    return best_gflops;
+}
+
+// Function to walk one GEMM blocking parameter (same rules as descend_tiled)
+static double descend_gemm(const Matrix *A, const Matrix *B, Matrix *C, GemmParams *p,
+                           int *field, const int *candidates, int count, int extent,
+                           double best_gflops, TuneStats *stats) {
+    int best_value = *field;
+    int misses = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (candidates[i] == best_value) continue;
+        if ((candidates[i] > extent && candidates[i] / 2 >= extent) || misses >= AUTOTUNE_PATIENCE) {
+            stats->pruned += count - i;
+            break;
+        }
+        *field = candidates[i];
+        double g = autotune_time_gemm(A, B, C, p);
+        stats->evaluations++;
+        if (g > best_gflops) {
+            best_gflops = g;
+            best_value = candidates[i];
+            misses = 0;
+        } else {
+            misses++;
+        }
+    }
+    *field = best_value;
+    return best_gflops;
+}
+
+// Packed GEMM search: coordinate descent from the compile-time defaults
+double autotune_gemm(const Matrix *A, const Matrix *B, Matrix *C,
+                     GemmParams *best, TuneStats *stats) {
+    double start = bench_now();
+    GemmParams p;
+
+    gemm_default_params(&p);
+    double best_gflops = autotune_time_gemm(A, B, C, &p);
+    stats->evaluations++;
+
+    // kc sets the L1 footprint of the micro-panels, so it goes first
+    best_gflops = descend_gemm(A, B, C, &p, &p.kc, gemm_kc_candidates,
+                               COUNT(gemm_kc_candidates), A->cols, best_gflops, stats);
+    best_gflops = descend_gemm(A, B, C, &p, &p.mc, gemm_mc_candidates,
+                               COUNT(gemm_mc_candidates), C->rows, best_gflops, stats);
+    best_gflops = descend_gemm(A, B, C, &p, &p.nc, gemm_nc_candidates,
+                               COUNT(gemm_nc_candidates), C->cols, best_gflops, stats);
+    *best = p;
+
+    stats->seconds += bench_now() - start;
+    return best_gflops;
+}
@@ -0,0 +1,40 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+
+// Timed runs per candidate (the fastest one counts)
+#ifndef AUTOTUNE_REPS
+#define AUTOTUNE_REPS 2
+#endif
+
+// Loop orders slower than this fraction of the best one are dropped
+// before unroll factors and tile sizes are searched
+#define AUTOTUNE_ORDER_CUTOFF 0.6
+
+// A tile dimension stops growing after this many candidates in a row
+// fail to beat the best so far
+#define AUTOTUNE_PATIENCE 2
+
+typedef struct {
+    int evaluations;    // configurations actually timed
+    int pruned;         // candidates skipped by the pruning rules
+    double seconds;     // wall time spent searching
+} TuneStats;
+
+// Search loop order, unroll factor and (mc, kc, nc) tile shape for the
+// tiled kernel on C += A * B. Returns the GFLOPS of the winner.
+double autotune_tiled(const Matrix *A, const Matrix *B, Matrix *C,
+                      TileConfig *best, TuneStats *stats);
+
+// Search MC/KC/NC for the packed GEMM engine. Returns the GFLOPS of the winner.
+double autotune_gemm(const Matrix *A, const Matrix *B, Matrix *C,
+                     GemmParams *best, TuneStats *stats);
+
+// Time one configuration (best of AUTOTUNE_REPS), in GFLOPS
+double autotune_time_tiled(const Matrix *A, const Matrix *B, Matrix *C, const TileConfig *t);
+double autotune_time_gemm(const Matrix *A, const Matrix *B, Matrix *C, const GemmParams *p);
+
+#endif
@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fnmatch.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+#include "bench.h"
+
+// Function to read the monotonic wall clock
+double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to read the time-stamp counter
+uint64_t bench_cycles(void) {
+#if BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Function to tell whether bench_cycles() counts anything
+int bench_cycles_available(void) {
+    return BENCH_HAVE_TSC;
+}
+
+// Function to read a positive integer from the environment
+static int env_int(const char *name, int fallback, int min) {
+    const char *v = getenv(name);
+    if (!v || !*v) return fallback;
+    int x = atoi(v);
+    return x >= min ? x : fallback;
+}
+
+// Function to fill the default configuration
+void bench_default_config(BenchConfig *cfg) {
+    cfg->warmup = env_int("BENCH_WARMUP", BENCH_DEFAULT_WARMUP, 0);
+    cfg->reps = env_int("BENCH_REPS", BENCH_DEFAULT_REPS, 1);
+    if (cfg->reps > BENCH_MAX_REPS) cfg->reps = BENCH_MAX_REPS;
+    cfg->reset = NULL;
+    cfg->counters = env_int("BENCH_COUNTERS", 1, 0);
+}
+
+// Counters are opened once per process, on first use
+static PerfCounters counters;
+static int counters_opened = 0;
+
+// Function to open the hardware counters if that has not been tried yet
+static PerfCounters *bench_counters(void) {
+    if (!counters_opened) {
+        perf_counters_open(&counters);
+        counters_opened = 1;
+    }
+    return counters.num_open > 0 ? &counters : NULL;
+}
+
+int bench_counters_available(const char **reason) {
+    bench_counters();
+    if (reason) *reason = counters.reason;
+    return counters.num_open;
+}
+
+// Comparison function for qsort
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Function to compute the median of a sorted array
+static double median_of(const double *sorted, int n) {
+    return (n % 2) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+// Function to benchmark one kernel
+void bench_run(const char *name, const char *params, bench_func fn, void *ctx,
+               const BenchConfig *cfg, double flops, double bytes, BenchResult *r) {
+    double times[BENCH_MAX_REPS];
+    double cycles[BENCH_MAX_REPS];
+    int reps = cfg->reps < 1 ? 1 : (cfg->reps > BENCH_MAX_REPS ? BENCH_MAX_REPS : cfg->reps);
+    PerfCounters *pc = cfg->counters ? bench_counters() : NULL;
+
+    for (int i = 0; i < cfg->warmup; i++) {
+        if (cfg->reset) cfg->reset(ctx);
+        fn(ctx);
+    }
+    if (pc) perf_counters_reset(pc);
+    for (int i = 0; i < reps; i++) {
+        if (cfg->reset) cfg->reset(ctx);
+        if (pc) perf_counters_enable(pc);
+        uint64_t c0 = bench_cycles();
+        double t0 = bench_now();
+        fn(ctx);
+        double t1 = bench_now();
+        uint64_t c1 = bench_cycles();
+        if (pc) perf_counters_disable(pc);
+        times[i] = t1 - t0;
+        cycles[i] = (double)(c1 - c0);
+    }
+
+    memset(r, 0, sizeof(*r));
+    if (pc) {
+        perf_counters_read(pc, &r->counters);
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) r->counters.value[e] /= reps;
+    }
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->params, sizeof(r->params), "%s", params ? params : "");
+    r->reps = reps;
+    r->flops = flops;
+    r->bytes = bytes;
+
+    double sum = 0.0;
+    for (int i = 0; i < reps; i++) sum += times[i];
+    r->mean = sum / reps;
+    double var = 0.0;
+    for (int i = 0; i < reps; i++) var += (times[i] - r->mean) * (times[i] - r->mean);
+    r->stddev = reps > 1 ? sqrt(var / (reps - 1)) : 0.0;
+
+    qsort(times, reps, sizeof(double), compare_doubles);
+    qsort(cycles, reps, sizeof(double), compare_doubles);
+    r->min = times[0];
+    r->max = times[reps - 1];
+    r->median = median_of(times, reps);
+    r->cycles = bench_cycles_available() ? median_of(cycles, reps) : 0.0;
+}
+
+// Function to compute GFLOPS from the median time
+double bench_gflops(const BenchResult *r) {
+    return (r->flops > 0 && r->median > 0) ? r->flops / r->median / 1e9 : 0.0;
+}
+
+// Function to compute GB/s from the median time
+double bench_gbps(const BenchResult *r) {
+    return (r->bytes > 0 && r->median > 0) ? r->bytes / r->median / 1e9 : 0.0;
+}
+
+// Function to print the table header
+void bench_print_header(FILE *f) {
+    fprintf(f, "%-24s %-14s %4s %11s %11s %8s %8s %8s %5s %8s %8s %8s\n",
+           "Kernel", "Params", "Reps", "Median (s)", "Min (s)", "Stddev%", "GFLOPS", "GB/s",
+           "IPC", "L1D/kF", "LLC/kF", "LLC GB/s");
+    fprintf(f, "--------------------------------------------------------------------------------------------------------------------------\n");
+}
+
+// Function to format a derived metric, "-" when it could not be measured
+static void format_metric(char *buf, size_t size, double value, int decimals) {
+    if (value < 0) {
+        snprintf(buf, size, "-");
+    } else {
+        snprintf(buf, size, "%.*f", decimals, value);
+    }
+}
+
+// Function to print one result row
+void bench_print_result(FILE *f, const BenchResult *r) {
+    char gflops[16], gbps[16], ipc[16], l1d[16], llc[16], llc_bw[16];
+    format_metric(gflops, sizeof(gflops), r->flops > 0 ? bench_gflops(r) : -1.0, 2);
+    format_metric(gbps, sizeof(gbps), r->bytes > 0 ? bench_gbps(r) : -1.0, 2);
+    format_metric(ipc, sizeof(ipc), perf_ipc(&r->counters), 2);
+    format_metric(l1d, sizeof(l1d), perf_per_kflop(&r->counters, PERF_L1D_MISSES, r->flops), 2);
+    format_metric(llc, sizeof(llc), perf_per_kflop(&r->counters, PERF_LLC_MISSES, r->flops), 3);
+    format_metric(llc_bw, sizeof(llc_bw), perf_llc_bandwidth(&r->counters, r->median), 2);
+    fprintf(f, "%-24s %-14s %4d %11.6f %11.6f %7.2f%% %8s %8s %5s %8s %8s %8s\n",
+            r->name, r->params, r->reps, r->median, r->min,
+            r->median > 0 ? 100.0 * r->stddev / r->median : 0.0,
+            gflops, gbps, ipc, l1d, llc, llc_bw);
+}
+
+// Function to print the hardware-counter table header
+void bench_print_counters_header(FILE *f) {
+    fprintf(f, "%-18s %6s %10s %10s %10s %10s %10s\n",
+            "Variant", "IPC", "L1D/kflop", "LLC/kflop", "dTLB/kflop", "LLC GB/s", "FP GFLOP");
+    fprintf(f, "-----------------------------------------------------------------------------\n");
+}
+
+// Function to print one row of hardware-counter metrics
+void bench_print_counters(FILE *f, const char *label, const BenchResult *r) {
+    char ipc[16], l1d[16], llc[16], tlb[16], bw[16], fp[16];
+    double fp_ops = perf_fp_ops(&r->counters);
+    format_metric(ipc, sizeof(ipc), perf_ipc(&r->counters), 2);
+    format_metric(l1d, sizeof(l1d), perf_per_kflop(&r->counters, PERF_L1D_MISSES, r->flops), 2);
+    format_metric(llc, sizeof(llc), perf_per_kflop(&r->counters, PERF_LLC_MISSES, r->flops), 3);
+    format_metric(tlb, sizeof(tlb), perf_per_kflop(&r->counters, PERF_DTLB_MISSES, r->flops), 3);
+    format_metric(bw, sizeof(bw), perf_llc_bandwidth(&r->counters, r->median), 2);
+    format_metric(fp, sizeof(fp), fp_ops < 0 ? -1.0 : fp_ops / 1e9, 3);
+    fprintf(f, "%-18s %6s %10s %10s %10s %10s %10s\n", label, ipc, l1d, llc, tlb, bw, fp);
+}
+
+// Function to write the CSV header
+void bench_write_csv_header(FILE *f) {
+    fprintf(f, "kernel,params,reps,median_s,min_s,mean_s,max_s,stddev_s,cycles,gflops,gbps");
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) fprintf(f, ",hw_%s", perf_event_name(e));
+    fprintf(f, "\n");
+}
+
+// Function to write one CSV row
+void bench_write_csv(FILE *f, const BenchResult *r) {
+    fprintf(f, "%s,%s,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%.0f,%.4f,%.4f",
+            r->name, r->params, r->reps, r->median, r->min, r->mean, r->max,
+            r->stddev, r->cycles, bench_gflops(r), bench_gbps(r));
+    // Empty field when an event was not measured
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (perf_sample_has(&r->counters, e)) {
+            fprintf(f, ",%llu", (unsigned long long)r->counters.value[e]);
+        } else {
+            fprintf(f, ",");
+        }
+    }
+    fprintf(f, "\n");
+}
+
+// Function to write all results as a JSON array
+void bench_write_json(FILE *f, const BenchResult *results, int count) {
+    fprintf(f, "[\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        fprintf(f, "  {\"kernel\": \"%s\", \"params\": \"%s\", \"reps\": %d, "
+                   "\"median_s\": %.9f, \"min_s\": %.9f, \"mean_s\": %.9f, \"max_s\": %.9f, "
+                   "\"stddev_s\": %.9f, \"cycles\": %.0f, \"gflops\": %.4f, \"gbps\": %.4f, "
+                   "\"counters\": {",
+                r->name, r->params, r->reps, r->median, r->min, r->mean, r->max,
+                r->stddev, r->cycles, bench_gflops(r), bench_gbps(r));
+        // Unmeasured events are left out rather than reported as 0
+        int first = 1;
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (!perf_sample_has(&r->counters, e)) continue;
+            fprintf(f, "%s\"%s\": %llu", first ? "" : ", ", perf_event_name(e),
+                    (unsigned long long)r->counters.value[e]);
+            first = 0;
+        }
+        fprintf(f, "}}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(f, "]\n");
+}
+
+// ===== Kernel registry =====
+
+static BenchKernel registry[BENCH_MAX_KERNELS];
+static int registry_count = 0;
+
+// Function to add a kernel to the registry
+void bench_register(const BenchKernel *k) {
+    if (registry_count == BENCH_MAX_KERNELS) {
+        fprintf(stderr, "Benchmark registry full, dropping %s\n", k->name);
+        return;
+    }
+    registry[registry_count++] = *k;
+}
+
+int bench_kernel_count(void) {
+    return registry_count;
+}
+
+const BenchKernel *bench_kernel_at(int i) {
+    return (i >= 0 && i < registry_count) ? &registry[i] : NULL;
+}
+
+// Function to match a kernel name against comma-separated globs
+int bench_kernel_matches(const BenchKernel *k, const char *patterns) {
+    if (!patterns || !*patterns) return 1;
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", patterns);
+    char *save = NULL;
+    for (char *p = strtok_r(buf, ",", &save); p; p = strtok_r(NULL, ",", &save)) {
+        if (fnmatch(p, k->name, 0) == 0) return 1;
+    }
+    return 0;
+}
+
+// Function to benchmark one registered kernel
+void bench_run_kernel(const BenchKernel *k, int size, const BenchConfig *cfg, BenchResult *r) {
+    if (size <= 0) size = k->default_size;
+
+    BenchConfig local = *cfg;
+    local.reset = k->reset;
+    char params[64];
+    snprintf(params, sizeof(params), "size=%d", size);
+
+    void *ctx = k->setup(size, k->arg);
+    bench_run(k->name, params, k->run, ctx, &local,
+              k->flops ? k->flops(size, k->arg) : 0.0,
+              k->bytes ? k->bytes(size, k->arg) : 0.0, r);
+    k->teardown(ctx);
+}
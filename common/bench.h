@@ -0,0 +1,106 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "perf_counters.h"
+
+// Defaults, overridable at run time with BENCH_WARMUP / BENCH_REPS / BENCH_COUNTERS
+#define BENCH_DEFAULT_WARMUP 1
+#define BENCH_DEFAULT_REPS   5
+#define BENCH_MAX_REPS       1000
+
+typedef void (*bench_func)(void *ctx);
+
+typedef struct {
+    int warmup;          // untimed runs before measuring
+    int reps;            // timed runs
+    bench_func reset;    // optional, called (untimed) before every run, e.g. zero C
+    int counters;        // count hardware events over the timed runs (if available)
+} BenchConfig;
+
+typedef struct {
+    char name[64];
+    char params[64];     // free-form, e.g. "n=1024"
+    int reps;
+    double min;          // seconds
+    double median;
+    double mean;
+    double max;
+    double stddev;
+    double cycles;       // median TSC ticks per run (0 if no cycle counter)
+    double flops;        // floating-point operations per run (0 if not meaningful)
+    double bytes;        // bytes moved per run (0 if not meaningful)
+    PerfSample counters; // hardware events per run (counters.valid == 0 if none)
+} BenchResult;
+
+// Monotonic wall clock (clock_gettime(CLOCK_MONOTONIC)) in seconds
+double bench_now(void);
+
+// Time-stamp counter (reference cycles on x86; 0 elsewhere)
+uint64_t bench_cycles(void);
+int bench_cycles_available(void);
+
+// Config with the defaults above, then BENCH_WARMUP / BENCH_REPS from the environment
+// (BENCH_COUNTERS=0 turns the hardware counters off)
+void bench_default_config(BenchConfig *cfg);
+
+// Number of hardware counters the harness could open; *reason explains a 0
+int bench_counters_available(const char **reason);
+
+// Run fn warmup + reps times and fill r with statistics over the timed runs.
+// flops and bytes are per run and only used for the derived rates.
+void bench_run(const char *name, const char *params, bench_func fn, void *ctx,
+               const BenchConfig *cfg, double flops, double bytes, BenchResult *r);
+
+// Derived rates from the median time (0 when flops / bytes are 0)
+double bench_gflops(const BenchResult *r);
+double bench_gbps(const BenchResult *r);
+
+// Human-readable table
+void bench_print_header(FILE *f);
+void bench_print_result(FILE *f, const BenchResult *r);
+
+// Hardware-counter table: IPC, misses per kflop, LLC-miss bandwidth per label
+void bench_print_counters_header(FILE *f);
+void bench_print_counters(FILE *f, const char *label, const BenchResult *r);
+
+// Machine-readable output
+void bench_write_csv_header(FILE *f);
+void bench_write_csv(FILE *f, const BenchResult *r);
+void bench_write_json(FILE *f, const BenchResult *results, int count);
+
+// ===== Kernel registry =====
+// A kernel owns its inputs: setup() allocates them for a problem size (n for
+// matrices, element count for vectors) and returns the context that run(),
+// reset() and teardown() receive. arg is a per-kernel constant (loop order,
+// stride, unroll factor...) so one setup can serve a family of kernels.
+
+#define BENCH_MAX_KERNELS 128
+
+typedef struct {
+    const char *name;                 // "group.kernel", e.g. "mxm.ikj"
+    const char *description;
+    int default_size;
+    int arg;
+    void *(*setup)(int size, int arg);
+    bench_func run;
+    bench_func reset;                 // NULL if runs do not depend on each other
+    void (*teardown)(void *ctx);
+    double (*flops)(int size, int arg);   // NULL if not a floating-point kernel
+    double (*bytes)(int size, int arg);   // NULL if no meaningful byte count
+    double (*footprint)(int size, int arg);   // bytes resident during a run; NULL: bytes
+} BenchKernel;
+
+void bench_register(const BenchKernel *k);
+int bench_kernel_count(void);
+const BenchKernel *bench_kernel_at(int i);
+
+// Match against a comma-separated list of shell globs ("mxm.*,stride.s1")
+int bench_kernel_matches(const BenchKernel *k, const char *patterns);
+
+// Set up, benchmark and tear down one registered kernel (size <= 0: its default)
+void bench_run_kernel(const BenchKernel *k, int size, const BenchConfig *cfg, BenchResult *r);
+
+#endif
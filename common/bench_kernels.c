@@ -0,0 +1,479 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include "bench.h"
+#include "bench_kernels.h"
+#include "matrix.h"
+#include "mxm_kernels.h"
+#include "gemm.h"
+#include "gemm_recursive.h"
+#include "ws_sched.h"
+#include "strassen.h"
+#include "cache_info.h"
+#include "roofline.h"
+#include "pipeline.h"
+#include "scan.h"
+#include "reduce.h"
+#include "packed_b.h"
+
+// Matrix kernel selector: 0..NUM_LOOP_ORDERS-1 are the loop orders
+enum {
+    MXM_STANDARD = NUM_LOOP_ORDERS,
+    MXM_BLOCK,
+    MXM_TILED,
+    MXM_IKJ_PARALLEL,
+    MXM_BLOCK_PARALLEL,
+    MXM_GEMM,
+    MXM_RECURSIVE,
+    MXM_STRASSEN,
+    MXM_NOISE,
+    MXM_NOISE_PACKED
+};
+
+#define BENCH_BLOCK_SIZE 32
+
+typedef struct {
+    int kind;
+    Matrix A, B, C;
+    double *noise;           // MXM_NOISE, MXM_NOISE_PACKED
+    PackedB pb;              // MXM_NOISE_PACKED: B packed once at setup
+    TileConfig tile;         // MXM_TILED
+    WsScheduler *sched;      // MXM_RECURSIVE
+    double *workspace;       // MXM_STRASSEN
+} MxmBench;
+
+typedef struct {
+    int arg;
+    long n;
+    double *a, *b, *c;
+    volatile double sink;    // keeps results alive at -O2
+} VecBench;
+
+// ===== Matrix kernels =====
+
+static void *mxm_setup(int n, int kind) {
+    MxmBench *x = calloc(1, sizeof(MxmBench));
+    if (!x) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    x->kind = kind;
+    x->A = allocate_matrix(n, n, MATRIX_PAD);
+    x->B = allocate_matrix(n, n, MATRIX_PAD);
+    x->C = allocate_matrix(n, n, MATRIX_PAD);
+    initialize_matrix(&x->A);
+    initialize_matrix(&x->B);
+    zero_matrix(&x->C);
+
+    if (kind == MXM_TILED) {
+        tile_tuned_config(n, &x->tile);
+    } else if (kind == MXM_RECURSIVE) {
+        x->sched = ws_create(omp_get_max_threads());
+    } else if (kind == MXM_STRASSEN) {
+        x->workspace = strassen_allocate_workspace(n, n, n, STRASSEN_CROSSOVER);
+    } else if (kind == MXM_NOISE || kind == MXM_NOISE_PACKED) {
+        x->noise = malloc(n * sizeof(double));
+        if (!x->noise) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+        x->noise[0] = 1.0;
+        for (int i = 1; i < n; i++) x->noise[i] = x->noise[i - 1] * 1.0000001;
+        if (kind == MXM_NOISE_PACKED) packed_b_init(&x->pb, x->B.data, n, n, x->B.ld);
+    }
+    return x;
+}
+
+// Lab2/Exercice4 product: C = noise-biased A * B
+static void matmul_noise(const Matrix *A, const Matrix *B, Matrix *C, const double *noise) {
+    const int n = C->rows;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = noise[i];
+            for (int k = 0; k < n; k++) {
+                sum += MAT(A, i, k) * MAT(B, k, j);
+            }
+            MAT(C, i, j) = sum;
+        }
+    }
+}
+
+static void mxm_run(void *ctx) {
+    MxmBench *x = ctx;
+    switch (x->kind) {
+    case MXM_STANDARD:       matrix_multiply_standard(&x->A, &x->B, &x->C); break;
+    case MXM_BLOCK:          matrix_multiply_block(&x->A, &x->B, &x->C, BENCH_BLOCK_SIZE); break;
+    case MXM_TILED:          matrix_multiply_tiled(&x->A, &x->B, &x->C, &x->tile); break;
+    case MXM_IKJ_PARALLEL:   matrix_multiply_ikj_parallel(&x->A, &x->B, &x->C); break;
+    case MXM_BLOCK_PARALLEL: matrix_multiply_block_parallel(&x->A, &x->B, &x->C, BENCH_BLOCK_SIZE); break;
+    case MXM_GEMM:           gemm_packed(&x->A, &x->B, &x->C, NULL); break;
+    case MXM_RECURSIVE:      gemm_recursive(x->sched, &x->A, &x->B, &x->C, 0); break;
+    case MXM_STRASSEN:       strassen_multiply(&x->A, &x->B, &x->C, STRASSEN_CROSSOVER, x->workspace); break;
+    case MXM_NOISE:          matmul_noise(&x->A, &x->B, &x->C, x->noise); break;
+    case MXM_NOISE_PACKED:
+        packed_b_multiply(x->A.data, x->A.rows, x->A.ld, &x->pb, x->noise, x->C.data, x->C.ld);
+        break;
+    default:                 loop_order_func(x->kind)(&x->A, &x->B, &x->C); break;
+    }
+}
+
+// Accumulating kernels (C += AB) start every run from C = 0
+static void mxm_reset(void *ctx) {
+    zero_matrix(&((MxmBench*)ctx)->C);
+}
+
+static void mxm_teardown(void *ctx) {
+    MxmBench *x = ctx;
+    if (x->sched) ws_destroy(x->sched);
+    free(x->workspace);
+    free(x->noise);
+    packed_b_free(&x->pb);
+    free_matrix(&x->A);
+    free_matrix(&x->B);
+    free_matrix(&x->C);
+    free(x);
+}
+
+// Classic 2*n^3 count (Strassen is reported as effective GFLOPS)
+static double mxm_flops(int n, int arg) {
+    (void)arg;
+    return 2.0 * n * n * n;
+}
+
+// Modelled traffic between the matrices' home level and the cache above it
+// (roofline.h); Strassen has no model and reports no bandwidth
+static double mxm_bytes(int n, int kind) {
+    CacheInfo c;
+    TileConfig t;
+    GemmParams p;
+    cache_info_detect(&c);
+    switch (kind) {
+    case MXM_STANDARD:
+    case MXM_NOISE:          return roofline_traffic_loop_order(&c, 0, n);
+    case MXM_IKJ_PARALLEL:   return roofline_traffic_loop_order(&c, 1, n);
+    case MXM_BLOCK:
+    case MXM_BLOCK_PARALLEL: return roofline_traffic_blocked(&c, n, BENCH_BLOCK_SIZE);
+    case MXM_TILED:
+        tile_tuned_config(n, &t);
+        return roofline_traffic_packed(&c, n, t.mc, t.kc, t.nc);
+    case MXM_GEMM:
+        gemm_tuned_params(n, &p);
+        return roofline_traffic_packed(&c, n, p.mc, p.kc, p.nc);
+    case MXM_NOISE_PACKED:   return roofline_traffic_packed(&c, n, n, n, PACKED_B_NR);
+    case MXM_RECURSIVE:      return roofline_traffic_oblivious(&c, n);
+    case MXM_STRASSEN:       return 0.0;
+    default:                 return roofline_traffic_loop_order(&c, kind, n);
+    }
+}
+
+// Three n x n matrices
+static double mxm_footprint(int n, int kind) {
+    (void)kind;
+    return 3.0 * n * n * sizeof(double);
+}
+
+// ===== Vector kernels =====
+
+enum { VEC_STRIDE, VEC_UNROLL, VEC_ILP, VEC_LAB2 };
+
+static void *vec_setup_sized(long n, long len, int arg) {
+    VecBench *v = calloc(1, sizeof(VecBench));
+    if (!v) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    v->arg = arg;
+    v->n = n;
+    if (len > 0) {
+        v->a = malloc(len * sizeof(double));
+        v->b = malloc(len * sizeof(double));
+        v->c = malloc(len * sizeof(double));
+        if (!v->a || !v->b || !v->c) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+        for (long i = 0; i < len; i++) {
+            v->a[i] = 1.0;
+            v->b[i] = i * 0.5;
+            v->c[i] = 0.0;
+        }
+    }
+    return v;
+}
+
+static void vec_teardown(void *ctx) {
+    VecBench *v = ctx;
+    free(v->a);
+    free(v->b);
+    free(v->c);
+    free(v);
+}
+
+// Lab1/Exercice 1: sum n elements read with a stride of arg doubles
+static void *stride_setup(int n, int stride) {
+    return vec_setup_sized(n, (long)n * stride, stride);
+}
+
+static void stride_run(void *ctx) {
+    VecBench *v = ctx;
+    const long end = v->n * v->arg;
+    const int s = v->arg;
+    double sum = 0.0;
+    for (long i = 0; i < end; i += s)
+        sum += v->a[i];
+    v->sink = sum;
+}
+
+static double stride_bytes(int n, int stride) {
+    (void)stride;
+    return (double)n * sizeof(double);
+}
+
+// Lab2/Exercice1: the unroll factors that loop_unroll_manual.c keeps enabled and
+// the powers of two around them, written out like the original
+static void *unroll_setup(int n, int u) {
+    return vec_setup_sized(n - n % u, n, u);
+}
+
+static void unroll_run(void *ctx) {
+    VecBench *v = ctx;
+    const double *a = v->a;
+    const long n = v->n;
+    double sum = 0.0;
+    switch (v->arg) {
+    case 1:
+        for (long i = 0; i < n; i++)
+            sum += a[i];
+        break;
+    case 2:
+        for (long i = 0; i < n; i += 2)
+            sum += a[i] + a[i+1];
+        break;
+    case 4:
+        for (long i = 0; i < n; i += 4)
+            sum += a[i] + a[i+1] + a[i+2] + a[i+3];
+        break;
+    case 8:
+        for (long i = 0; i < n; i += 8)
+            sum += a[i] + a[i+1] + a[i+2] + a[i+3] +
+                   a[i+4] + a[i+5] + a[i+6] + a[i+7];
+        break;
+    }
+    v->sink = sum;
+}
+
+static double vec_sum_flops(int n, int arg) {
+    (void)arg;
+    return (double)n;
+}
+
+static double vec_read_bytes(int n, int arg) {
+    (void)arg;
+    return (double)n * sizeof(double);
+}
+
+// Reduction library (reduce.h); arg is the ReduceMode
+static void *reduce_setup(int n, int mode) {
+    return vec_setup_sized(n, n, mode);
+}
+
+static void reduce_run(void *ctx) {
+    VecBench *v = ctx;
+    v->sink = reduce_sum(v->a, v->n, (ReduceMode)v->arg);
+}
+
+// Lab2/Exercice2: two independent accumulation streams, with a*b in the loop
+// (exercice3.c, arg 0) or hoisted by hand (exercice3_manual.c, arg 1)
+static void *ilp_setup(int n, int variant) {
+    return vec_setup_sized(n, 0, variant);
+}
+
+static void ilp_run(void *ctx) {
+    VecBench *v = ctx;
+    volatile double va = 1.1, vb = 1.2;
+    const double a = va, b = vb;
+    double x = 0.0, y = 0.0;
+    if (v->arg == 0) {
+        for (long i = 0; i < v->n; i++) {
+            x = a * b + x;  /* stream 1 */
+            y = a * b + y;  /* independent stream 2 */
+        }
+    } else {
+        const double t = a * b;
+        for (long i = 0; i < v->n; i++) {
+            x += t;
+            y += t;
+        }
+    }
+    v->sink = x + y;
+}
+
+static double ilp_flops(int n, int arg) {
+    (void)arg;
+    return 4.0 * n;
+}
+
+// Lab2/Exercice3 stages; arg selects the stage
+enum { LAB2_ADD_NOISE, LAB2_INIT_B, LAB2_ADD, LAB2_REDUCTION, LAB2_NOISE_SCAN, LAB2_NOISE_POW };
+
+static void *lab2_setup(int n, int stage) {
+    return vec_setup_sized(n, n, stage);
+}
+
+static void lab2_run(void *ctx) {
+    VecBench *v = ctx;
+    double *a = v->a, *b = v->b, *c = v->c;
+    const long n = v->n;
+    switch (v->arg) {
+    case LAB2_ADD_NOISE:
+        a[0] = 1.0;
+        for (long i = 1; i < n; i++)
+            a[i] = a[i - 1] * 1.0000001;
+        break;
+    case LAB2_INIT_B:
+        for (long i = 0; i < n; i++)
+            b[i] = i * 0.5;
+        break;
+    case LAB2_ADD:
+        for (long i = 0; i < n; i++)
+            c[i] = a[i] + b[i];
+        break;
+    case LAB2_REDUCTION: {
+        double sum = 0.0;
+        for (long i = 0; i < n; i++)
+            sum += c[i];
+        v->sink = sum;
+        break;
+    }
+    case LAB2_NOISE_SCAN:
+        scan_mul_blocked(a, n, 1.0, 1.0000001);
+        break;
+    case LAB2_NOISE_POW:
+        scan_mul_pow(a, n, 1.0, 1.0000001);
+        break;
+    }
+}
+
+static double lab2_bytes(int n, int stage) {
+    // Reads + writes per element: noise r/w, init w, add 2r+w, reduction r,
+    // blocked scan w + r/w of the scaling pass, pow w
+    static const int streams[] = {2, 1, 3, 1, 3, 1};
+    return (double)n * sizeof(double) * streams[stage];
+}
+
+static double lab2_flops(int n, int stage) {
+    return stage == LAB2_INIT_B ? 0.0 : (double)n;
+}
+
+// Lab2/Exercice3 end to end with the four stages fused over L2-sized chunks;
+// the chunk buffers are the whole footprint, so no DRAM traffic is modelled
+static void *fused_setup(int n, int arg) {
+    return vec_setup_sized(n, 0, arg);
+}
+
+static void fused_run(void *ctx) {
+    VecBench *v = ctx;
+    Pipeline p;
+    NoiseStage noise = {0, 1.0, 1.0000001, 0.0};
+    RampStage ramp = {1, 0.5};
+    AddStage add = {0, 1, 2};
+    SumStage sum = {2, 0.0};
+
+    pipeline_init(&p, v->n, 3, 0);
+    pipeline_add_stage(&p, "add_noise", pipeline_stage_noise, &noise);
+    pipeline_add_stage(&p, "init_b", pipeline_stage_ramp, &ramp);
+    pipeline_add_stage(&p, "compute_addition", pipeline_stage_add, &add);
+    pipeline_add_stage(&p, "reduction", pipeline_stage_sum, &sum);
+    pipeline_run(&p);
+    pipeline_free(&p);
+    v->sink = sum.sum;
+}
+
+// One multiply (noise) and two additions per element
+static double fused_flops(int n, int arg) {
+    (void)arg;
+    return 3.0 * n;
+}
+
+// ===== Registration =====
+
+#define MXM_KERNEL(name, desc, kind, size, reset) \
+    {name, desc, size, kind, mxm_setup, mxm_run, reset, mxm_teardown, mxm_flops, mxm_bytes, \
+     mxm_footprint}
+
+#define VEC_KERNEL(name, desc, size, arg, setup, run, flops, bytes) \
+    {name, desc, size, arg, setup, run, NULL, vec_teardown, flops, bytes, NULL}
+
+void bench_register_all(void) {
+    static const BenchKernel kernels[] = {
+        MXM_KERNEL("mxm.ijk", "loop order ijk (Lab1/Exercice 2)", 0, 512, mxm_reset),
+        MXM_KERNEL("mxm.ikj", "loop order ikj", 1, 512, mxm_reset),
+        MXM_KERNEL("mxm.jik", "loop order jik", 2, 512, mxm_reset),
+        MXM_KERNEL("mxm.jki", "loop order jki", 3, 512, mxm_reset),
+        MXM_KERNEL("mxm.kij", "loop order kij", 4, 512, mxm_reset),
+        MXM_KERNEL("mxm.kji", "loop order kji", 5, 512, mxm_reset),
+        MXM_KERNEL("mxm.standard", "C = AB, ijk with a scalar accumulator", MXM_STANDARD, 512, NULL),
+        MXM_KERNEL("mxm.block", "32x32 blocking (Lab1/Exercice 3)", MXM_BLOCK, 512, NULL),
+        MXM_KERNEL("mxm.tiled", "MCxKCxNC tiling, tuned order/unroll", MXM_TILED, 512, mxm_reset),
+        MXM_KERNEL("mxm.ikj_parallel", "OpenMP ikj over rows", MXM_IKJ_PARALLEL, 512, mxm_reset),
+        MXM_KERNEL("mxm.block_parallel", "OpenMP over 32x32 C tiles", MXM_BLOCK_PARALLEL, 512, NULL),
+        MXM_KERNEL("mxm.gemm", "packed GEMM with SIMD micro-kernel", MXM_GEMM, 1024, mxm_reset),
+        MXM_KERNEL("mxm.recursive", "cache-oblivious GEMM, work stealing", MXM_RECURSIVE, 1024, mxm_reset),
+        MXM_KERNEL("mxm.strassen", "Strassen-Winograd, packed GEMM leaves", MXM_STRASSEN, 1024, NULL),
+        MXM_KERNEL("mxm.noise", "noise-biased matmul (Lab2/Exercice4)", MXM_NOISE, 512, NULL),
+        MXM_KERNEL("mxm.noise_packed", "noise-biased matmul, B packed once into panels", MXM_NOISE_PACKED,
+                   512, NULL),
+
+        VEC_KERNEL("stride.s1", "strided sum, stride 1 (Lab1/Exercice 1)", 1000000, 1,
+                   stride_setup, stride_run, vec_sum_flops, stride_bytes),
+        VEC_KERNEL("stride.s2", "strided sum, stride 2", 1000000, 2,
+                   stride_setup, stride_run, vec_sum_flops, stride_bytes),
+        VEC_KERNEL("stride.s4", "strided sum, stride 4", 1000000, 4,
+                   stride_setup, stride_run, vec_sum_flops, stride_bytes),
+        VEC_KERNEL("stride.s8", "strided sum, stride 8 (one line per element)", 1000000, 8,
+                   stride_setup, stride_run, vec_sum_flops, stride_bytes),
+        VEC_KERNEL("stride.s16", "strided sum, stride 16", 1000000, 16,
+                   stride_setup, stride_run, vec_sum_flops, stride_bytes),
+
+        VEC_KERNEL("unroll.u1", "sum, no unrolling (Lab2/Exercice1)", 1000000, 1,
+                   unroll_setup, unroll_run, vec_sum_flops, vec_read_bytes),
+        VEC_KERNEL("unroll.u2", "sum, unrolled x2", 1000000, 2,
+                   unroll_setup, unroll_run, vec_sum_flops, vec_read_bytes),
+        VEC_KERNEL("unroll.u4", "sum, unrolled x4", 1000000, 4,
+                   unroll_setup, unroll_run, vec_sum_flops, vec_read_bytes),
+        VEC_KERNEL("unroll.u8", "sum, unrolled x8", 1000000, 8,
+                   unroll_setup, unroll_run, vec_sum_flops, vec_read_bytes),
+
+        VEC_KERNEL("reduce.fast", "16 AVX2 accumulators per thread, tree over threads", 1000000,
+                   REDUCE_FAST, reduce_setup, reduce_run, vec_sum_flops, vec_read_bytes),
+        VEC_KERNEL("reduce.reproducible", "fixed 4096-element blocks, pairwise tree", 1000000,
+                   REDUCE_REPRODUCIBLE, reduce_setup, reduce_run, vec_sum_flops, vec_read_bytes),
+        VEC_KERNEL("reduce.compensated", "reproducible blocks with Kahan lanes", 1000000,
+                   REDUCE_COMPENSATED, reduce_setup, reduce_run, vec_sum_flops, vec_read_bytes),
+
+        VEC_KERNEL("ilp.two_streams", "x,y += a*b, product in the loop (Lab2/Exercice2)", 10000000, 0,
+                   ilp_setup, ilp_run, ilp_flops, NULL),
+        VEC_KERNEL("ilp.hoisted", "x,y += t with t = a*b hoisted by hand", 10000000, 1,
+                   ilp_setup, ilp_run, ilp_flops, NULL),
+
+        VEC_KERNEL("lab2.add_noise", "recurrence a[i] = a[i-1]*c (Lab2/Exercice3)", 10000000, LAB2_ADD_NOISE,
+                   lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.init_b", "b[i] = i * 0.5", 10000000, LAB2_INIT_B,
+                   lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.compute_addition", "c = a + b", 10000000, LAB2_ADD,
+                   lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.reduction", "sum of c", 10000000, LAB2_REDUCTION,
+                   lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.noise_scan", "add_noise as a blocked two-pass SIMD/OpenMP scan", 10000000,
+                   LAB2_NOISE_SCAN, lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.noise_pow", "add_noise in closed form, a[i] = pow(c, i)", 10000000,
+                   LAB2_NOISE_POW, lab2_setup, lab2_run, lab2_flops, lab2_bytes),
+        VEC_KERNEL("lab2.fused", "all four stages fused over L2-sized chunks", 10000000, 0,
+                   fused_setup, fused_run, fused_flops, NULL),
+    };
+
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+        bench_register(&kernels[i]);
+    }
+}
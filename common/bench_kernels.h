@@ -0,0 +1,13 @@
+#ifndef BENCH_KERNELS_H
+#define BENCH_KERNELS_H
+
+// Register every kernel of the labs with the benchmark harness:
+//   mxm.*     matrix products (loop orders, blocked, tiled, packed, parallel,
+//             work-stealing recursive, Strassen, Lab2 noise matmul)
+//   stride.*  strided sum of Lab1/Exercice 1
+//   unroll.*  manually unrolled sums of Lab2/Exercice1
+//   ilp.*     dependent / independent FMA streams of Lab2/Exercice2
+//   lab2.*    pipeline stages of Lab2/Exercice3
+void bench_register_all(void);
+
+#endif
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "cache_info.h"
+
+static CacheInfo detected_info;
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+
+// Function to read one line of a sysfs file
+static int read_sysfs(const char *path, char *buf, size_t len) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (ok) buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+// Function to parse a sysfs cache size ("48K", "2048K", "105M")
+static size_t parse_size(const char *s) {
+    char *end;
+    size_t v = strtoul(s, &end, 10);
+    if (*end == 'K') v *= 1024;
+    else if (*end == 'M') v *= 1024 * 1024;
+    else if (*end == 'G') v *= 1024UL * 1024 * 1024;
+    return v;
+}
+
+// Function to read the hierarchy from sysfs
+static void detect_sysfs(CacheInfo *c) {
+    for (int idx = 0; idx < 8; idx++) {
+        char path[128], type[32], level[16], size[32], line[16];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx);
+        if (!read_sysfs(path, type, sizeof(type))) break;
+        if (strcmp(type, "Instruction") == 0) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx);
+        if (!read_sysfs(path, level, sizeof(level))) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx);
+        if (!read_sysfs(path, size, sizeof(size))) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/coherency_line_size", idx);
+        if (read_sysfs(path, line, sizeof(line)) && atoi(line) > 0) c->line = atoi(line);
+
+        size_t bytes = parse_size(size);
+        switch (atoi(level)) {
+            case 1: c->l1d = bytes; break;
+            case 2: c->l2 = bytes; break;
+            default: c->llc = bytes; break;   // level 3 or 4: treat as last level
+        }
+        if (atoi(level) > c->levels) c->levels = atoi(level);
+    }
+}
+
+// Function to detect the hierarchy once
+static void detect(void) {
+    CacheInfo *c = &detected_info;
+    memset(c, 0, sizeof(*c));
+    detect_sysfs(c);
+
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    if (!c->l1d && sysconf(_SC_LEVEL1_DCACHE_SIZE) > 0) c->l1d = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (!c->l2 && sysconf(_SC_LEVEL2_CACHE_SIZE) > 0) c->l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (!c->llc && sysconf(_SC_LEVEL3_CACHE_SIZE) > 0) c->llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+
+    c->detected = c->l1d != 0;
+    if (!c->l1d) c->l1d = CACHE_DEFAULT_L1D;
+    if (!c->l2) c->l2 = CACHE_DEFAULT_L2;
+    if (!c->llc) c->llc = c->l2 > CACHE_DEFAULT_LLC ? c->l2 : CACHE_DEFAULT_LLC;
+    if (!c->line) c->line = CACHE_DEFAULT_LINE;
+    if (!c->levels) c->levels = 3;
+}
+
+int cache_info_detect(CacheInfo *c) {
+    pthread_once(&detect_once, detect);
+    *c = detected_info;
+    return c->detected;
+}
+
+size_t cache_level_holding(const CacheInfo *c, size_t bytes) {
+    if (bytes <= c->l1d) return c->l1d;
+    if (bytes <= c->l2) return c->l2;
+    if (bytes <= c->llc) return c->llc;
+    return 0;
+}
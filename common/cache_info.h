@@ -0,0 +1,29 @@
+#ifndef CACHE_INFO_H
+#define CACHE_INFO_H
+
+#include <stddef.h>
+
+// Data-cache hierarchy of the CPU the process runs on
+typedef struct {
+    size_t l1d;          // bytes per core
+    size_t l2;           // bytes per core (or per cluster)
+    size_t llc;          // last level, shared
+    int line;            // cache line size in bytes
+    int levels;          // data/unified levels found (1..3)
+    int detected;        // 0 if the defaults below were used
+} CacheInfo;
+
+// Used when neither sysfs nor sysconf report a size
+#define CACHE_DEFAULT_L1D  (32 * 1024)
+#define CACHE_DEFAULT_L2   (1024 * 1024)
+#define CACHE_DEFAULT_LLC  (8 * 1024 * 1024)
+#define CACHE_DEFAULT_LINE 64
+
+// Fill c from /sys/devices/system/cpu/cpu0/cache, then sysconf, then defaults.
+// Returns c->detected. Cached after the first call.
+int cache_info_detect(CacheInfo *c);
+
+// Size of the smallest cache level holding `bytes`; 0 if only DRAM does
+size_t cache_level_holding(const CacheInfo *c, size_t bytes);
+
+#endif
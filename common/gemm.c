@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+#include <pthread.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <math.h>
+
+#include "gemm.h"
+#include "cache_info.h"
+#include "tune_profile.h"
+#include "arena.h"
+
+// Micro-kernel signature: C[MR x NR] += Ap[kc x MR]^T * Bp[kc x NR]
+typedef void (*micro_kernel_func)(int kc, const double *restrict a,
+                                  const double *restrict b,
+                                  double *restrict c, int ldc);
+
+static micro_kernel_func selected_kernel = NULL;
+static const char *selected_name = "none";
+static int scalar_forced = 0;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+// Function to derive the blocking from the cache sizes: the KC x NR sliver of
+// B in half of L1, the MC x KC block of A in half of L2, the KC x NC panel of
+// B in half of the LLC (the other halves hold the streamed operands and C)
+void gemm_params_for_caches(size_t l1d, size_t l2, size_t llc, GemmParams *p) {
+    p->mc = GEMM_MC;
+    p->kc = GEMM_KC;
+    p->nc = GEMM_NC;
+
+    if (l1d) {
+        int kc = (int)(l1d / 2 / (GEMM_NR * sizeof(double)));
+        kc -= kc % 8;
+        p->kc = kc < 64 ? 64 : (kc > 1024 ? 1024 : kc);
+    }
+    if (l2) {
+        int mc = (int)(l2 / 2 / ((size_t)p->kc * sizeof(double)));
+        mc -= mc % GEMM_MR;
+        p->mc = mc < 4 * GEMM_MR ? 4 * GEMM_MR : (mc > 1020 ? 1020 : mc);
+    }
+    if (llc) {
+        size_t nc = llc / 2 / ((size_t)p->kc * sizeof(double));
+        nc -= nc % GEMM_NR;
+        p->nc = nc < 32 * GEMM_NR ? 32 * GEMM_NR : (nc > GEMM_NC ? GEMM_NC : (int)nc);
+    }
+}
+
+// Function to fill the default blocking parameters from the cache hierarchy
+void gemm_default_params(GemmParams *p) {
+    const TuneProfile *prof = tune_profile_active();
+    CacheInfo c;
+    int detected = cache_info_detect(&c);
+    size_t l1d = detected ? c.l1d : 0;
+    size_t l2 = detected ? c.l2 : 0;
+    size_t llc = detected ? c.llc : 0;
+
+    // Sizes measured by the pointer-chasing probe win over what sysfs claims
+    if (prof && prof->cache_l1d) l1d = prof->cache_l1d;
+    if (prof && prof->cache_l2) l2 = prof->cache_l2;
+    if (prof && prof->cache_llc) llc = prof->cache_llc;
+
+    gemm_params_for_caches(l1d, l2, llc, p);
+}
+
+// Function to fill the blocking parameters from the autotuning profile
+int gemm_tuned_params(int n, GemmParams *p) {
+    gemm_default_params(p);
+
+    const TuneProfile *prof = tune_profile_active();
+    const TuneEntry *e = prof ? tune_profile_lookup(prof, n) : NULL;
+    if (!e || e->mc <= 0 || e->kc <= 0 || e->nc <= 0) return 0;
+
+    p->mc = e->mc;
+    p->kc = e->kc;
+    p->nc = e->nc;
+    return 1;
+}
+
+// ===== Micro-kernels =====
+
+// Portable micro-kernel (used when the CPU has no AVX2/FMA)
+static void micro_kernel_scalar(int kc, const double *restrict a,
+                                const double *restrict b,
+                                double *restrict c, int ldc) {
+    double acc[GEMM_MR][GEMM_NR] = {{0.0}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < GEMM_MR; i++) {
+            const double ai = a[i];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    for (int i = 0; i < GEMM_MR; i++) {
+        for (int j = 0; j < GEMM_NR; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+// AVX2 + FMA micro-kernel: 6 x 8 tile held in 12 ymm accumulators
+__attribute__((target("avx2,fma")))
+static void micro_kernel_avx2(int kc, const double *restrict a,
+                              const double *restrict b,
+                              double *restrict c, int ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        const __m256d b0 = _mm256_load_pd(b);
+        const __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ai;
+
+        ai = _mm256_broadcast_sd(a + 0);
+        c00 = _mm256_fmadd_pd(ai, b0, c00);
+        c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10);
+        c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20);
+        c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30);
+        c31 = _mm256_fmadd_pd(ai, b1, c31);
+        ai = _mm256_broadcast_sd(a + 4);
+        c40 = _mm256_fmadd_pd(ai, b0, c40);
+        c41 = _mm256_fmadd_pd(ai, b1, c41);
+        ai = _mm256_broadcast_sd(a + 5);
+        c50 = _mm256_fmadd_pd(ai, b0, c50);
+        c51 = _mm256_fmadd_pd(ai, b1, c51);
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+#define GEMM_STORE_ROW(i, lo, hi) \
+    _mm256_storeu_pd(c + (i) * ldc,     _mm256_add_pd(_mm256_loadu_pd(c + (i) * ldc), lo)); \
+    _mm256_storeu_pd(c + (i) * ldc + 4, _mm256_add_pd(_mm256_loadu_pd(c + (i) * ldc + 4), hi))
+
+    GEMM_STORE_ROW(0, c00, c01);
+    GEMM_STORE_ROW(1, c10, c11);
+    GEMM_STORE_ROW(2, c20, c21);
+    GEMM_STORE_ROW(3, c30, c31);
+    GEMM_STORE_ROW(4, c40, c41);
+    GEMM_STORE_ROW(5, c50, c51);
+#undef GEMM_STORE_ROW
+}
+
+// Function to pick the micro-kernel once, based on CPUID
+static void select_kernel(void) {
+    __builtin_cpu_init();
+    if (!scalar_forced && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        selected_kernel = micro_kernel_avx2;
+        selected_name = "avx2-fma";
+    } else {
+        selected_kernel = micro_kernel_scalar;
+        selected_name = "scalar";
+    }
+}
+
+// Function to return the name of the selected micro-kernel
+const char* gemm_kernel_name(void) {
+    pthread_once(&kernel_once, select_kernel);
+    return selected_name;
+}
+
+// Function to force the portable micro-kernel (between products, not during one)
+void gemm_force_scalar(int enable) {
+    pthread_once(&kernel_once, select_kernel);
+    scalar_forced = enable;
+    select_kernel();
+}
+
+// ===== Packing =====
+
+// Pack an mc x kc block of A into MR-row slivers: Ap[sliver][p][0..MR)
+// Rows past mc are zero-filled so the micro-kernel never needs a bound check.
+static void pack_a(const Matrix *A, int row, int col, int mc, int kc, double *ap) {
+    for (int i0 = 0; i0 < mc; i0 += GEMM_MR) {
+        int mr = (mc - i0 < GEMM_MR) ? mc - i0 : GEMM_MR;
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < mr; i++) {
+                ap[i] = MAT(A, row + i0 + i, col + p);
+            }
+            for (int i = mr; i < GEMM_MR; i++) {
+                ap[i] = 0.0;
+            }
+            ap += GEMM_MR;
+        }
+    }
+}
+
+// Pack one NR-column sliver of a kc x nc panel of B: Bp[p][0..NR)
+static void pack_b_sliver(const Matrix *B, int row, int col, int kc, int nr, double *bp) {
+    for (int p = 0; p < kc; p++) {
+        const double *brow = &MAT(B, row + p, col);
+        for (int j = 0; j < nr; j++) {
+            bp[j] = brow[j];
+        }
+        for (int j = nr; j < GEMM_NR; j++) {
+            bp[j] = 0.0;
+        }
+        bp += GEMM_NR;
+    }
+}
+
+// ===== Driver =====
+
+#define GEMM_ENGINE_T  double
+#define GEMM_ENGINE_MR GEMM_MR
+#define GEMM_ENGINE_NR GEMM_NR
+#define GEMM_ENGINE_A  Matrix
+#define GEMM_ENGINE_B  Matrix
+#define GEMM_ENGINE_C  Matrix
+#include "gemm_engine.h"
+
+// Packed GEMM: C += A * B (loop nest and threading in gemm_engine.h)
+void gemm_packed(const Matrix *A, const Matrix *B, Matrix *C, const GemmParams *params) {
+    GemmParams p;
+    if (params) {
+        p = *params;
+    } else {
+        gemm_tuned_params((int)cbrt((double)C->rows * C->cols * A->cols), &p);
+    }
+    pthread_once(&kernel_once, select_kernel);
+
+    gemm_engine_run(A, B, C, A->cols, &p);
+}
@@ -0,0 +1,50 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix.h"
+
+// Register tile of the micro-kernel: MR rows of A x NR columns of B.
+// 6 x 8 doubles = 12 AVX2 accumulators, leaving room for 2 B vectors
+// and 1 broadcast A value out of the 16 ymm registers.
+#define GEMM_MR 6
+#define GEMM_NR 8
+
+// Cache blocking (GotoBLAS/BLIS naming):
+//   KC x NR  micro-panel of B stays in L1 (256 * 8 * 8 = 16 KB)
+//   MC x KC  packed block of A stays in L2 (120 * 256 * 8 = 240 KB)
+//   KC x NC  packed panel of B stays in L3
+// These are the fallbacks when the cache sizes are unknown; GEMM_NC also caps NC.
+#define GEMM_MC 120
+#define GEMM_KC 256
+#define GEMM_NC 4080
+
+typedef struct {
+    int mc;
+    int kc;
+    int nc;
+} GemmParams;
+
+// Fill params from the cache sizes, each block taking half of its level: the
+// sizes measured by the stride probe if the profile has them, else sysfs, else
+// the compile-time fallbacks above
+void gemm_default_params(GemmParams *p);
+
+// Blocking for explicit L1 / L2 / LLC sizes in bytes (0: keep the fallback)
+void gemm_params_for_caches(size_t l1d, size_t l2, size_t llc, GemmParams *p);
+
+// Fill params from the saved autotuning profile (entry closest to size n),
+// falling back to the defaults. Returns 1 if the profile was used.
+int gemm_tuned_params(int n, GemmParams *p);
+
+// C += A * B using packed panels and the register-blocked micro-kernel.
+// params may be NULL to use the tuned profile (or the defaults). Built with -fopenmp, it runs on
+// omp_get_max_threads() threads.
+void gemm_packed(const Matrix *A, const Matrix *B, Matrix *C, const GemmParams *params);
+
+// Name of the micro-kernel picked at runtime ("avx2-fma" or "scalar")
+const char* gemm_kernel_name(void);
+
+// Force the portable kernel even on AVX2 hardware (for comparisons)
+void gemm_force_scalar(int enable);
+
+#endif
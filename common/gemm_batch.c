@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "gemm_batch.h"
+#include "matrix.h"
+#include "arena.h"
+
+// Columns of C held in registers per kernel step (8 of the 16 ymm registers)
+#define BATCH_JB 8
+
+// Where product b lives: base + b * stride, or the b-th pointer
+typedef struct {
+    const double *a, *b;
+    double *c;
+    long sa, sb, sc;
+    const double *const *ap;
+    const double *const *bp;
+    double *const *cp;
+} BatchSource;
+
+static const double* src_a(const BatchSource *src, int i) {
+    return src->ap ? src->ap[i] : src->a + i * src->sa;
+}
+
+static const double* src_b(const BatchSource *src, int i) {
+    return src->bp ? src->bp[i] : src->b + i * src->sb;
+}
+
+static double* src_c(const BatchSource *src, int i) {
+    return src->cp ? src->cp[i] : src->c + i * src->sc;
+}
+
+static int use_avx2(void) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+static int is_small(const GemmBatchShape *s) {
+    return s->m <= GEMM_BATCH_MAX_DIM && s->n <= GEMM_BATCH_MAX_DIM && s->k <= GEMM_BATCH_MAX_DIM;
+}
+
+// Whether a shape has a kernel compiled for its dimensions
+static int is_specialized(const GemmBatchShape *s) {
+    if (s->m != s->n || s->n != s->k) return 0;
+    switch (s->n) {
+#define SIZE_CASE(S) case S:
+    GEMM_BATCH_SIZES(SIZE_CASE)
+#undef SIZE_CASE
+        return 1;
+    }
+    return 0;
+}
+
+const char* gemm_batch_kernel_name(const GemmBatchShape *s, char *buf, int len) {
+    if (!use_avx2() || !is_small(s)) {
+        snprintf(buf, len, "scalar");
+    } else if (is_specialized(s)) {
+        snprintf(buf, len, "avx2 interleaved %dx%dx%d", s->m, s->n, s->k);
+    } else {
+        snprintf(buf, len, "avx2 interleaved generic");
+    }
+    return buf;
+}
+
+// ===== One product at a time (no AVX2, or large shapes) =====
+
+static void product_ikj(const GemmBatchShape *s, const double *A, const double *B, double *C) {
+    for (int i = 0; i < s->m; i++) {
+        double *c = C + (size_t)i * s->ldc;
+        for (int kk = 0; kk < s->k; kk++) {
+            const double a = A[(size_t)i * s->lda + kk];
+            const double *b = B + (size_t)kk * s->ldb;
+            for (int j = 0; j < s->n; j++) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+// ===== Interleaved groups =====
+// Group buffers hold element (i, j) of lane l at [(i * cols + j) * LANES + l].
+// Lanes past the end of the batch read a zero row and write to a scratch row
+// (leading dimension 0).
+
+// 4 x 4 transpose in registers: four rows in, four columns out (its own inverse)
+#define TRANSPOSE4(r0, r1, r2, r3) do {                     \
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);            \
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);            \
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);            \
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);            \
+        r0 = _mm256_permute2f128_pd(t0, t2, 0x20);          \
+        r1 = _mm256_permute2f128_pd(t1, t3, 0x20);          \
+        r2 = _mm256_permute2f128_pd(t0, t2, 0x31);          \
+        r3 = _mm256_permute2f128_pd(t1, t3, 0x31);          \
+    } while (0)
+
+// Interleave four rows x cols matrices (lane l at src[l], leading dimension ld[l])
+__attribute__((target("avx2")))
+static void interleave(const double *const *src, const long *ld, int rows, int cols, double *dst) {
+    const int L = GEMM_BATCH_LANES;
+    for (int i = 0; i < rows; i++) {
+        const double *s0 = src[0] + i * ld[0], *s1 = src[1] + i * ld[1];
+        const double *s2 = src[2] + i * ld[2], *s3 = src[3] + i * ld[3];
+        double *d = dst + (size_t)i * cols * L;
+        int j = 0;
+        for (; j + L <= cols; j += L) {
+            __m256d r0 = _mm256_loadu_pd(s0 + j), r1 = _mm256_loadu_pd(s1 + j);
+            __m256d r2 = _mm256_loadu_pd(s2 + j), r3 = _mm256_loadu_pd(s3 + j);
+            TRANSPOSE4(r0, r1, r2, r3);
+            _mm256_store_pd(d + j * L, r0);
+            _mm256_store_pd(d + j * L + 4, r1);
+            _mm256_store_pd(d + j * L + 8, r2);
+            _mm256_store_pd(d + j * L + 12, r3);
+        }
+        for (; j < cols; j++) {
+            d[j * L] = s0[j];
+            d[j * L + 1] = s1[j];
+            d[j * L + 2] = s2[j];
+            d[j * L + 3] = s3[j];
+        }
+    }
+}
+
+// Inverse of interleave
+__attribute__((target("avx2")))
+static void deinterleave(const double *src, int rows, int cols, double *const *dst, const long *ld) {
+    const int L = GEMM_BATCH_LANES;
+    for (int i = 0; i < rows; i++) {
+        double *d0 = dst[0] + i * ld[0], *d1 = dst[1] + i * ld[1];
+        double *d2 = dst[2] + i * ld[2], *d3 = dst[3] + i * ld[3];
+        const double *s = src + (size_t)i * cols * L;
+        int j = 0;
+        for (; j + L <= cols; j += L) {
+            __m256d r0 = _mm256_load_pd(s + j * L), r1 = _mm256_load_pd(s + j * L + 4);
+            __m256d r2 = _mm256_load_pd(s + j * L + 8), r3 = _mm256_load_pd(s + j * L + 12);
+            TRANSPOSE4(r0, r1, r2, r3);
+            _mm256_storeu_pd(d0 + j, r0);
+            _mm256_storeu_pd(d1 + j, r1);
+            _mm256_storeu_pd(d2 + j, r2);
+            _mm256_storeu_pd(d3 + j, r3);
+        }
+        for (; j < cols; j++) {
+            d0[j] = s[j * L];
+            d1[j] = s[j * L + 1];
+            d2[j] = s[j * L + 2];
+            d3[j] = s[j * L + 3];
+        }
+    }
+}
+
+static const double zero_row[GEMM_BATCH_MAX_DIM];
+
+static void pack_group(const GemmBatchShape *s, const BatchSource *src, int first, int lanes,
+                       double *ai, double *bi, double *ci) {
+    const double *a[GEMM_BATCH_LANES], *b[GEMM_BATCH_LANES], *c[GEMM_BATCH_LANES];
+    long lda[GEMM_BATCH_LANES], ldb[GEMM_BATCH_LANES], ldc[GEMM_BATCH_LANES];
+    for (int l = 0; l < GEMM_BATCH_LANES; l++) {
+        int live = l < lanes;
+        a[l] = live ? src_a(src, first + l) : zero_row;
+        b[l] = live ? src_b(src, first + l) : zero_row;
+        c[l] = live ? src_c(src, first + l) : zero_row;
+        lda[l] = live ? s->lda : 0;
+        ldb[l] = live ? s->ldb : 0;
+        ldc[l] = live ? s->ldc : 0;
+    }
+    interleave(a, lda, s->m, s->k, ai);
+    interleave(b, ldb, s->k, s->n, bi);
+    interleave(c, ldc, s->m, s->n, ci);
+}
+
+static void unpack_group(const GemmBatchShape *s, const BatchSource *src, int first, int lanes,
+                         const double *ci) {
+    double scratch[GEMM_BATCH_MAX_DIM];
+    double *c[GEMM_BATCH_LANES];
+    long ldc[GEMM_BATCH_LANES];
+    for (int l = 0; l < GEMM_BATCH_LANES; l++) {
+        c[l] = l < lanes ? src_c(src, first + l) : scratch;
+        ldc[l] = l < lanes ? s->ldc : 0;
+    }
+    deinterleave(ci, s->m, s->n, c, ldc);
+}
+
+// ci += ai * bi on interleaved buffers: one row of C at a time, BATCH_JB
+// columns (vectors of four products) in registers while k runs. With constant
+// m, n, k every loop unrolls to straight-line code.
+__attribute__((target("avx2,fma")))
+static inline __attribute__((always_inline))
+void group_kernel(const int m, const int n, const int k, const double *ai, const double *bi, double *ci) {
+    const int L = GEMM_BATCH_LANES;
+    for (int i = 0; i < m; i++) {
+        for (int j0 = 0; j0 < n; j0 += BATCH_JB) {
+            const int jb = (n - j0 < BATCH_JB) ? n - j0 : BATCH_JB;
+            double *c = ci + (size_t)(i * n + j0) * L;
+            __m256d acc[BATCH_JB];
+            for (int jj = 0; jj < jb; jj++) acc[jj] = _mm256_load_pd(c + jj * L);
+            for (int kk = 0; kk < k; kk++) {
+                const __m256d a = _mm256_load_pd(ai + (size_t)(i * k + kk) * L);
+                const double *b = bi + (size_t)(kk * n + j0) * L;
+                #pragma GCC unroll 8
+                for (int jj = 0; jj < jb; jj++) {
+                    acc[jj] = _mm256_fmadd_pd(a, _mm256_load_pd(b + jj * L), acc[jj]);
+                }
+            }
+            for (int jj = 0; jj < jb; jj++) _mm256_store_pd(c + jj * L, acc[jj]);
+        }
+    }
+}
+
+// Specialized kernels for the square sizes, generic loop otherwise
+__attribute__((target("avx2,fma")))
+static void group_multiply(const GemmBatchShape *s, const double *ai, const double *bi, double *ci) {
+    if (s->m == s->n && s->n == s->k) {
+        switch (s->n) {
+#define SIZE_CASE(S) case S: group_kernel(S, S, S, ai, bi, ci); return;
+        GEMM_BATCH_SIZES(SIZE_CASE)
+#undef SIZE_CASE
+        }
+    }
+    group_kernel(s->m, s->n, s->k, ai, bi, ci);
+}
+
+// ===== Driver =====
+
+static void batch_run(const GemmBatchShape *s, const BatchSource *src, int count) {
+    if (count <= 0) return;
+
+    if (!use_avx2() || !is_small(s)) {
+        #pragma omp parallel for schedule(static) if (count > 1)
+        for (int b = 0; b < count; b++) {
+            product_ikj(s, src_a(src, b), src_b(src, b), src_c(src, b));
+        }
+        return;
+    }
+
+    const int L = GEMM_BATCH_LANES;
+    const int groups = (count + L - 1) / L;
+    const size_t a_len = (size_t)s->m * s->k * L;
+    const size_t b_len = (size_t)s->k * s->n * L;
+    const size_t c_len = (size_t)s->m * s->n * L;
+
+    #pragma omp parallel if (groups > 1)
+    {
+        // Per-thread group buffers, reused for every group of the thread
+        double *ai = pool_alloc((a_len + b_len + c_len) * sizeof(double)), *bi = ai + a_len, *ci = bi + b_len;
+
+        #pragma omp for schedule(static)
+        for (int g = 0; g < groups; g++) {
+            const int first = g * L;
+            const int lanes = (count - first < L) ? count - first : L;
+            pack_group(s, src, first, lanes, ai, bi, ci);
+            group_multiply(s, ai, bi, ci);
+            unpack_group(s, src, first, lanes, ci);
+        }
+        pool_free(ai);
+    }
+}
+
+void gemm_batch_strided(const GemmBatchShape *s, const double *A, long stride_a,
+                        const double *B, long stride_b, double *C, long stride_c, int count) {
+    BatchSource src;
+    memset(&src, 0, sizeof(src));
+    src.a = A;
+    src.b = B;
+    src.c = C;
+    src.sa = stride_a;
+    src.sb = stride_b;
+    src.sc = stride_c;
+    batch_run(s, &src, count);
+}
+
+void gemm_batch_pointers(const GemmBatchShape *s, const double *const *A,
+                         const double *const *B, double *const *C, int count) {
+    BatchSource src;
+    memset(&src, 0, sizeof(src));
+    src.ap = A;
+    src.bp = B;
+    src.cp = C;
+    batch_run(s, &src, count);
+}
@@ -0,0 +1,41 @@
+#ifndef GEMM_BATCH_H
+#define GEMM_BATCH_H
+
+// Batched small GEMM: C_b += A_b * B_b for b < count, all products of one
+// m x k by k x n shape. One call covers the whole batch, so there is no
+// per-product call, setup or thread start-up.
+//
+// With AVX2, GEMM_BATCH_LANES products are interleaved across the lanes of a
+// vector: element (i, j) of the four matrices of a group is one __m256d, so
+// every FMA advances four independent products and no shape is too narrow or
+// too odd for the vector width. Square sizes in GEMM_BATCH_SIZES get a kernel
+// compiled for their dimensions; other shapes use the generic loop. Groups are
+// shared among OpenMP threads (built with -fopenmp).
+
+#define GEMM_BATCH_LANES 4
+
+// Shapes with a dimension above this run one product at a time (the group
+// buffers would no longer fit in L2, and the packed GEMM is the tool there)
+#define GEMM_BATCH_MAX_DIM 64
+
+// Square sizes with a specialized kernel
+#define GEMM_BATCH_SIZES(X) X(4) X(8) X(16) X(32) X(64)
+
+typedef struct {
+    int m, n, k;
+    int lda, ldb, ldc;       // leading dimensions (row-major)
+} GemmBatchShape;
+
+// Product b reads A + b * stride_a and B + b * stride_b and updates C + b * stride_c
+// (a stride of 0 shares one matrix; C matrices must not overlap)
+void gemm_batch_strided(const GemmBatchShape *s, const double *A, long stride_a,
+                        const double *B, long stride_b, double *C, long stride_c, int count);
+
+// Product b reads A[b] and B[b] and updates C[b] (pointers may repeat for A and B, not for C)
+void gemm_batch_pointers(const GemmBatchShape *s, const double *const *A,
+                         const double *const *B, double *const *C, int count);
+
+// Kernel used for a shape ("avx2 interleaved 8x8x8", "avx2 interleaved generic", "scalar")
+const char* gemm_batch_kernel_name(const GemmBatchShape *s, char *buf, int len);
+
+#endif
@@ -0,0 +1,122 @@
+// Packed GEMM engine, written once and included once per element type (no
+// include guard on purpose). Before including it, a translation unit defines
+//
+//   GEMM_ENGINE_T       element type of the packed panels and of C (double, float)
+//   GEMM_ENGINE_MR/NR   register tile of its micro-kernel
+//   GEMM_ENGINE_A/B/C   operand types as seen by the packers and by MAT()
+//
+// and provides, with these exact names:
+//
+//   selected_kernel     micro-kernel C[MR x NR] += Ap[kc x MR]^T * Bp[kc x NR]
+//   pack_a              (A, row, col, mc, kc, ap): mc x kc block into MR-row slivers
+//   pack_b_sliver       (B, row, col, kc, nr, bp): one NR-column sliver
+//
+// It defines gemm_engine_run(A, B, C, k, blocking): C += A * B with the loop
+// nest and threading of gemm_packed. The caller resolves the blocking and
+// selects the micro-kernel first.
+
+#define GE_T  GEMM_ENGINE_T
+#define GE_MR GEMM_ENGINE_MR
+#define GE_NR GEMM_ENGINE_NR
+
+// Function to multiply a packed mc x kc block of A by a packed kc x nc panel of B
+static void gemm_engine_macro_kernel(int mc, int nc, int kc, const GE_T *ap, const GE_T *bp,
+                                     GE_T *c, int ldc) {
+    GE_T tmp[GE_MR * GE_NR] __attribute__((aligned(64)));
+
+    for (int j0 = 0; j0 < nc; j0 += GE_NR) {
+        int nr = (nc - j0 < GE_NR) ? nc - j0 : GE_NR;
+        const GE_T *b_sliver = bp + (size_t)j0 * kc;
+
+        for (int i0 = 0; i0 < mc; i0 += GE_MR) {
+            int mr = (mc - i0 < GE_MR) ? mc - i0 : GE_MR;
+            const GE_T *a_sliver = ap + (size_t)i0 * kc;
+            GE_T *c_tile = c + (size_t)i0 * ldc + j0;
+
+            if (mr == GE_MR && nr == GE_NR) {
+                selected_kernel(kc, a_sliver, b_sliver, c_tile, ldc);
+            } else {
+                // Edge tile: compute into a full-size scratch tile, then add the valid part
+                memset(tmp, 0, sizeof(tmp));
+                selected_kernel(kc, a_sliver, b_sliver, tmp, GE_NR);
+                for (int i = 0; i < mr; i++) {
+                    for (int j = 0; j < nr; j++) {
+                        c_tile[(size_t)i * ldc + j] += tmp[i * GE_NR + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Function to get an aligned packing buffer: from the pool, so repeated
+// products reuse the buffers (and their faulted-in pages) of the last call
+static GE_T* gemm_engine_buffer(size_t count) {
+    return (GE_T*)pool_alloc(count * sizeof(GE_T));
+}
+
+// Packed GEMM driver: C += A * B, A being m x k
+//
+// With OpenMP, the team shares the packed B panel (each thread packs some of
+// its slivers) and takes MC-row blocks of C with a dynamic schedule, so slower
+// E-cores simply end up with fewer blocks instead of holding up the finish.
+static void gemm_engine_run(const GEMM_ENGINE_A *A, const GEMM_ENGINE_B *B, GEMM_ENGINE_C *C,
+                            int k, const GemmParams *p) {
+    const int m = C->rows, n = C->cols;
+
+    // Round panel widths up to whole slivers so packing never overruns
+    int nc_alloc = (p->nc + GE_NR - 1) / GE_NR * GE_NR;
+    GE_T *bp = gemm_engine_buffer((size_t)p->kc * nc_alloc);
+
+    // Keep several row blocks per thread so the dynamic schedule can balance
+    // (not when called from inside a parallel region: that team is one thread)
+    int mc = p->mc;
+#ifdef _OPENMP
+    int threads = omp_get_max_threads();
+    if (threads > 1 && !omp_in_parallel()) {
+        int per_block = (m + 4 * threads - 1) / (4 * threads);
+        per_block = (per_block + GE_MR - 1) / GE_MR * GE_MR;
+        if (per_block < mc) mc = per_block < GE_MR ? GE_MR : per_block;
+    }
+#endif
+    int mc_alloc = (mc + GE_MR - 1) / GE_MR * GE_MR;
+
+    #pragma omp parallel
+    {
+        GE_T *ap = gemm_engine_buffer((size_t)mc_alloc * p->kc);
+
+        for (int jc = 0; jc < n; jc += p->nc) {
+            int nc = (n - jc < p->nc) ? n - jc : p->nc;
+            for (int pc = 0; pc < k; pc += p->kc) {
+                int kc = (k - pc < p->kc) ? k - pc : p->kc;
+
+                #pragma omp for schedule(static)
+                for (int j0 = 0; j0 < nc; j0 += GE_NR) {
+                    int nr = (nc - j0 < GE_NR) ? nc - j0 : GE_NR;
+                    pack_b_sliver(B, pc, jc + j0, kc, nr, bp + (size_t)j0 * kc);
+                }
+
+                #pragma omp for schedule(dynamic, 1)
+                for (int ic = 0; ic < m; ic += mc) {
+                    int mb = (m - ic < mc) ? m - ic : mc;
+                    pack_a(A, ic, pc, mb, kc, ap);
+                    gemm_engine_macro_kernel(mb, nc, kc, ap, bp, &MAT(C, ic, jc), C->ld);
+                }
+            }
+        }
+
+        pool_free(ap);
+    }
+
+    pool_free(bp);
+}
+
+#undef GE_T
+#undef GE_MR
+#undef GE_NR
+#undef GEMM_ENGINE_T
+#undef GEMM_ENGINE_MR
+#undef GEMM_ENGINE_NR
+#undef GEMM_ENGINE_A
+#undef GEMM_ENGINE_B
+#undef GEMM_ENGINE_C
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include <pthread.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "gemm_mixed.h"
+#include "arena.h"
+
+// ===== bf16 =====
+
+bf16 bf16_from_float(float x) {
+    uint32_t u;
+    memcpy(&u, &x, sizeof(u));
+    if ((u & 0x7fffffffu) > 0x7f800000u) {
+        return (bf16)((u >> 16) | 0x40);    // quiet NaN, whatever its payload
+    }
+    u += 0x7fffu + ((u >> 16) & 1);         // round to nearest, ties to even
+    return (bf16)(u >> 16);
+}
+
+float bf16_to_float(bf16 h) {
+    uint32_t u = (uint32_t)h << 16;
+    float x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+// Element loads of each storage type, widened to float
+#define LOAD_F32(x)  (x)
+#define LOAD_BF16(x) bf16_to_float(x)
+
+// ===== Typed matrices =====
+
+// Function to compute the leading dimension for elem-byte elements, with the
+// cache-line rounding and alias padding of matrix_leading_dim
+static int typed_leading_dim(int cols, int padding, size_t elem) {
+    const int line = (int)(MATRIX_ALIGNMENT / elem);
+    int ld = (cols + line - 1) / line * line;
+    if (padding == MATRIX_PAD && ((size_t)ld * elem) % MATRIX_ALIAS_STRIDE == 0) {
+        ld += line;
+    }
+    return ld;
+}
+
+#define DEFINE_TYPED_ALLOC(SUFFIX, NAME, T)                                    \
+    NAME allocate_matrix_##SUFFIX(int rows, int cols, int padding) {           \
+        NAME m;                                                                \
+        m.rows = rows;                                                         \
+        m.cols = cols;                                                         \
+        m.ld = typed_leading_dim(cols, padding, sizeof(T));                    \
+        m.owner = 1;                                                           \
+        m.data = pool_alloc((size_t)rows * m.ld * sizeof(T));                  \
+        return m;                                                              \
+    }                                                                          \
+                                                                               \
+    void free_matrix_##SUFFIX(NAME *m) {                                       \
+        if (!m || !m->data) return;                                            \
+        if (m->owner) pool_free(m->data);                                      \
+        m->data = NULL;                                                        \
+    }
+
+DEFINE_TYPED_ALLOC(f32, MatrixF32, float)
+DEFINE_TYPED_ALLOC(bf16, MatrixBF16, bf16)
+
+void matrix_to_f32(const Matrix *src, MatrixF32 *dst) {
+    for (int i = 0; i < src->rows; i++) {
+        for (int j = 0; j < src->cols; j++) MAT(dst, i, j) = (float)MAT(src, i, j);
+    }
+}
+
+// double -> float -> bf16 can round twice; the bound of gemm_type_tolerance
+// (one bf16 unit roundoff per input) still holds to first order
+void matrix_to_bf16(const Matrix *src, MatrixBF16 *dst) {
+    for (int i = 0; i < src->rows; i++) {
+        for (int j = 0; j < src->cols; j++) MAT(dst, i, j) = bf16_from_float((float)MAT(src, i, j));
+    }
+}
+
+void matrix_from_f32(const MatrixF32 *src, Matrix *dst) {
+    for (int i = 0; i < src->rows; i++) {
+        for (int j = 0; j < src->cols; j++) MAT(dst, i, j) = MAT(src, i, j);
+    }
+}
+
+void zero_matrix_f32(MatrixF32 *m) {
+    for (int i = 0; i < m->rows; i++) {
+        memset(&MAT(m, i, 0), 0, (size_t)m->cols * sizeof(float));
+    }
+}
+
+// ===== ikj loop =====
+
+#define DEFINE_IKJ(SUFFIX, NAME, T, LOAD)                                                  \
+    void matrix_multiply_ikj_##SUFFIX(const NAME *A, const NAME *B, MatrixF32 *C) {        \
+        for (int i = 0; i < C->rows; i++) {                                                \
+            float *c = &MAT(C, i, 0);                                                      \
+            for (int k = 0; k < A->cols; k++) {                                            \
+                const float a = LOAD(MAT(A, i, k));                                        \
+                const T *b = &MAT(B, k, 0);                                                \
+                for (int j = 0; j < C->cols; j++) {                                        \
+                    c[j] += a * LOAD(b[j]);                                                \
+                }                                                                          \
+            }                                                                              \
+        }                                                                                  \
+    }
+
+DEFINE_IKJ(f32, MatrixF32, float, LOAD_F32)
+DEFINE_IKJ(bf16, MatrixBF16, bf16, LOAD_BF16)
+
+// ===== Micro-kernels (float, shared by every storage type) =====
+
+// C[MR x NR] += Ap[kc x MR]^T * Bp[kc x NR]
+typedef void (*micro_kernel_f32_func)(int kc, const float *restrict a,
+                                      const float *restrict b,
+                                      float *restrict c, int ldc);
+
+static micro_kernel_f32_func selected_kernel = NULL;
+static const char *selected_name = "none";
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void micro_kernel_scalar(int kc, const float *restrict a,
+                                const float *restrict b,
+                                float *restrict c, int ldc) {
+    float acc[GEMM_F32_MR][GEMM_F32_NR] = {{0.0f}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < GEMM_F32_MR; i++) {
+            const float ai = a[i];
+            for (int j = 0; j < GEMM_F32_NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += GEMM_F32_MR;
+        b += GEMM_F32_NR;
+    }
+
+    for (int i = 0; i < GEMM_F32_MR; i++) {
+        for (int j = 0; j < GEMM_F32_NR; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+// AVX2 + FMA micro-kernel: the 6 x 8 double tile of gemm.c with 8 floats per
+// vector, i.e. 6 x 16 in the same 12 ymm accumulators
+__attribute__((target("avx2,fma")))
+static void micro_kernel_avx2(int kc, const float *restrict a,
+                              const float *restrict b,
+                              float *restrict c, int ldc) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (int p = 0; p < kc; p++) {
+        const __m256 b0 = _mm256_load_ps(b);
+        const __m256 b1 = _mm256_load_ps(b + 8);
+        __m256 ai;
+
+        ai = _mm256_broadcast_ss(a + 0);
+        c00 = _mm256_fmadd_ps(ai, b0, c00);
+        c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(ai, b0, c10);
+        c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(ai, b0, c20);
+        c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(ai, b0, c30);
+        c31 = _mm256_fmadd_ps(ai, b1, c31);
+        ai = _mm256_broadcast_ss(a + 4);
+        c40 = _mm256_fmadd_ps(ai, b0, c40);
+        c41 = _mm256_fmadd_ps(ai, b1, c41);
+        ai = _mm256_broadcast_ss(a + 5);
+        c50 = _mm256_fmadd_ps(ai, b0, c50);
+        c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+        a += GEMM_F32_MR;
+        b += GEMM_F32_NR;
+    }
+
+#define GEMM_STORE_ROW(i, lo, hi) \
+    _mm256_storeu_ps(c + (i) * ldc,     _mm256_add_ps(_mm256_loadu_ps(c + (i) * ldc), lo)); \
+    _mm256_storeu_ps(c + (i) * ldc + 8, _mm256_add_ps(_mm256_loadu_ps(c + (i) * ldc + 8), hi))
+
+    GEMM_STORE_ROW(0, c00, c01);
+    GEMM_STORE_ROW(1, c10, c11);
+    GEMM_STORE_ROW(2, c20, c21);
+    GEMM_STORE_ROW(3, c30, c31);
+    GEMM_STORE_ROW(4, c40, c41);
+    GEMM_STORE_ROW(5, c50, c51);
+#undef GEMM_STORE_ROW
+}
+
+// Function to pick the micro-kernel once, based on CPUID
+static void select_kernel(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        selected_kernel = micro_kernel_avx2;
+        selected_name = "avx2-fma";
+    } else {
+        selected_kernel = micro_kernel_scalar;
+        selected_name = "scalar";
+    }
+}
+
+const char* gemm_mixed_kernel_name(void) {
+    pthread_once(&kernel_once, select_kernel);
+    return selected_name;
+}
+
+// ===== Packing (per storage type; operands come out as float) =====
+
+// Storage-agnostic view of an operand: the packers switch on the type once
+// per block, the element loops are instantiated per type
+typedef struct {
+    const void *data;
+    int ld;
+    GemmType type;
+} Operand;
+
+#define DEFINE_PACK(SUFFIX, T, LOAD)                                                       \
+    static void pack_a_##SUFFIX(const T *A, int lda, int mc, int kc, float *ap) {          \
+        for (int i0 = 0; i0 < mc; i0 += GEMM_F32_MR) {                                     \
+            int mr = (mc - i0 < GEMM_F32_MR) ? mc - i0 : GEMM_F32_MR;                      \
+            for (int p = 0; p < kc; p++) {                                                 \
+                for (int i = 0; i < mr; i++) ap[i] = LOAD(A[(size_t)(i0 + i) * lda + p]);  \
+                for (int i = mr; i < GEMM_F32_MR; i++) ap[i] = 0.0f;                       \
+                ap += GEMM_F32_MR;                                                         \
+            }                                                                              \
+        }                                                                                  \
+    }                                                                                      \
+                                                                                           \
+    static void pack_b_sliver_##SUFFIX(const T *B, int ldb, int kc, int nr, float *bp) {   \
+        for (int p = 0; p < kc; p++) {                                                     \
+            const T *brow = B + (size_t)p * ldb;                                           \
+            for (int j = 0; j < nr; j++) bp[j] = LOAD(brow[j]);                            \
+            for (int j = nr; j < GEMM_F32_NR; j++) bp[j] = 0.0f;                           \
+            bp += GEMM_F32_NR;                                                             \
+        }                                                                                  \
+    }
+
+DEFINE_PACK(f32, float, LOAD_F32)
+DEFINE_PACK(bf16, bf16, LOAD_BF16)
+
+// Pack an mc x kc block of A at (row, col) into MR-row slivers (zero-filled past mc)
+static void pack_a(const Operand *A, int row, int col, int mc, int kc, float *ap) {
+    size_t off = (size_t)row * A->ld + col;
+    if (A->type == GEMM_BF16) {
+        pack_a_bf16((const bf16*)A->data + off, A->ld, mc, kc, ap);
+    } else {
+        pack_a_f32((const float*)A->data + off, A->ld, mc, kc, ap);
+    }
+}
+
+// Pack one NR-column sliver of B at (row, col): Bp[p][0..NR)
+static void pack_b_sliver(const Operand *B, int row, int col, int kc, int nr, float *bp) {
+    size_t off = (size_t)row * B->ld + col;
+    if (B->type == GEMM_BF16) {
+        pack_b_sliver_bf16((const bf16*)B->data + off, B->ld, kc, nr, bp);
+    } else {
+        pack_b_sliver_f32((const float*)B->data + off, B->ld, kc, nr, bp);
+    }
+}
+
+// ===== Driver =====
+
+#define GEMM_ENGINE_T  float
+#define GEMM_ENGINE_MR GEMM_F32_MR
+#define GEMM_ENGINE_NR GEMM_F32_NR
+#define GEMM_ENGINE_A  Operand
+#define GEMM_ENGINE_B  Operand
+#define GEMM_ENGINE_C  MatrixF32
+#include "gemm_engine.h"
+
+// Packed GEMM on float panels: the blocking of gemm_packed, scaled to float
+static void gemm_packed_float(const Operand *A, const Operand *B, MatrixF32 *C, int k,
+                              const GemmParams *params) {
+    GemmParams p;
+    if (params) {
+        p = *params;
+    } else {
+        gemm_tuned_params((int)cbrt((double)C->rows * C->cols * k), &p);
+    }
+    // An NR-wide float sliver has the bytes of an fp64 one, so KC carries over;
+    // the MC x KC block and the KC x NC panel hold twice the elements
+    p.mc *= 2;
+    p.nc *= 2;
+    pthread_once(&kernel_once, select_kernel);
+
+    gemm_engine_run(A, B, C, k, &p);
+}
+
+void gemm_packed_f32(const MatrixF32 *A, const MatrixF32 *B, MatrixF32 *C, const GemmParams *params) {
+    Operand a = {A->data, A->ld, GEMM_FP32};
+    Operand b = {B->data, B->ld, GEMM_FP32};
+    gemm_packed_float(&a, &b, C, A->cols, params);
+}
+
+void gemm_packed_bf16(const MatrixBF16 *A, const MatrixBF16 *B, MatrixF32 *C, const GemmParams *params) {
+    Operand a = {A->data, A->ld, GEMM_BF16};
+    Operand b = {B->data, B->ld, GEMM_BF16};
+    gemm_packed_float(&a, &b, C, A->cols, params);
+}
+
+// ===== Types =====
+
+const char* gemm_type_name(GemmType t) {
+    switch (t) {
+        case GEMM_FP64: return "fp64";
+        case GEMM_FP32: return "fp32";
+        case GEMM_BF16: return "bf16/fp32";
+    }
+    return "?";
+}
+
+double gemm_type_tolerance(GemmType t, int k) {
+    double u_in, u_acc;
+    switch (t) {
+        case GEMM_BF16: u_in = ldexp(1.0, -8);  u_acc = ldexp(1.0, -24); break;
+        case GEMM_FP32: u_in = ldexp(1.0, -24); u_acc = ldexp(1.0, -24); break;
+        default:        u_in = 0.0;             u_acc = ldexp(1.0, -53); break;
+    }
+    // First order: (1 + d_a)(1 + d_b) on every product, then k roundings of
+    // the running sum (one more for the product when there is no FMA)
+    return 2.0 * u_in + (k + 1) * u_acc;
+}
@@ -0,0 +1,79 @@
+#ifndef GEMM_MIXED_H
+#define GEMM_MIXED_H
+
+#include <stdint.h>
+
+#include "matrix.h"
+#include "gemm.h"
+
+// Reduced-precision GEMM. The packed engine of gemm_engine.h, which gemm.c
+// instantiates for double, is instantiated here for float; float32 storage and
+// bf16 storage with float32 accumulation both run on it, the packers widening
+// the operands to float (one AVX2 kernel of 8 floats per vector). Against the
+// fp64 engine, a vector does twice the work and A and B take half (float) or
+// a quarter (bf16) of the bytes.
+
+// bf16: the upper 16 bits of an IEEE float (8-bit exponent, 7-bit mantissa)
+typedef uint16_t bf16;
+
+// Element types, for names and error bounds
+typedef enum {
+    GEMM_FP64,
+    GEMM_FP32,
+    GEMM_BF16
+} GemmType;
+
+// Register tile of the float kernel: 6 rows x 16 columns = 12 ymm accumulators
+#define GEMM_F32_MR 6
+#define GEMM_F32_NR 16
+
+// Typed matrices with the layout rules of Matrix (row-major, ld >= cols,
+// 64-byte aligned rows of the buffer, owner == 0 on views)
+#define DEFINE_TYPED_MATRIX(NAME, T) \
+    typedef struct {                 \
+        T *data;                     \
+        int rows;                    \
+        int cols;                    \
+        int ld;                      \
+        int owner;                   \
+    } NAME;
+
+DEFINE_TYPED_MATRIX(MatrixF32, float)
+DEFINE_TYPED_MATRIX(MatrixBF16, bf16)
+
+// Round to nearest even (NaN stays NaN)
+bf16 bf16_from_float(float x);
+float bf16_to_float(bf16 h);
+
+// Allocation and release, from the pool like allocate_matrix (exit on failure)
+MatrixF32 allocate_matrix_f32(int rows, int cols, int padding);
+MatrixBF16 allocate_matrix_bf16(int rows, int cols, int padding);
+void free_matrix_f32(MatrixF32 *m);
+void free_matrix_bf16(MatrixBF16 *m);
+
+// Conversions from and to the fp64 matrices (same shape)
+void matrix_to_f32(const Matrix *src, MatrixF32 *dst);
+void matrix_to_bf16(const Matrix *src, MatrixBF16 *dst);
+void matrix_from_f32(const MatrixF32 *src, Matrix *dst);
+void zero_matrix_f32(MatrixF32 *m);
+
+// ikj loop (Lab1/Exercice 2 order): C += A * B, accumulating in float
+void matrix_multiply_ikj_f32(const MatrixF32 *A, const MatrixF32 *B, MatrixF32 *C);
+void matrix_multiply_ikj_bf16(const MatrixBF16 *A, const MatrixBF16 *B, MatrixF32 *C);
+
+// Packed GEMM: C += A * B with the blocking of gemm_packed (params in fp64
+// units, NULL for the tuned profile; the float blocks are scaled to the same bytes)
+void gemm_packed_f32(const MatrixF32 *A, const MatrixF32 *B, MatrixF32 *C, const GemmParams *params);
+void gemm_packed_bf16(const MatrixBF16 *A, const MatrixBF16 *B, MatrixF32 *C, const GemmParams *params);
+
+// Name of the float micro-kernel ("avx2-fma" or "scalar")
+const char* gemm_mixed_kernel_name(void);
+
+const char* gemm_type_name(GemmType t);
+
+// Relative error bound of a k-term product of same-sign operands against the
+// exact result: rounding of both inputs to the storage type plus k roundings
+// of the accumulator
+double gemm_type_tolerance(GemmType t, int k);
+
+#endif
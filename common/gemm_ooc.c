@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "gemm_ooc.h"
+#include "gemm.h"
+#include "matrix.h"
+#include "bench.h"
+#include "arena.h"
+
+// ===== Mapped files =====
+
+static int map_file(MappedMatrix *m, const char *path, int rows, int cols, int writable) {
+    m->rows = rows;
+    m->cols = cols;
+    m->bytes = (size_t)rows * cols * sizeof(double);
+    m->data = mmap(NULL, m->bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                   MAP_SHARED, m->fd, 0);
+    if (m->data == MAP_FAILED) {
+        perror(path);
+        close(m->fd);
+        m->data = NULL;
+        return -1;
+    }
+    // Tiles touch short row segments scattered over the file: no read-around
+    // on faults, the I/O thread asks for exactly the segments it needs
+    madvise(m->data, m->bytes, MADV_RANDOM);
+    return 0;
+}
+
+int mapped_matrix_open(MappedMatrix *m, const char *path, int rows, int cols, int writable) {
+    m->fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (m->fd < 0) {
+        perror(path);
+        return -1;
+    }
+    off_t size = lseek(m->fd, 0, SEEK_END);
+    if (size != (off_t)((size_t)rows * cols * sizeof(double))) {
+        fprintf(stderr, "%s: %lld bytes, expected %d x %d doubles\n", path, (long long)size, rows, cols);
+        close(m->fd);
+        return -1;
+    }
+    return map_file(m, path, rows, cols, writable);
+}
+
+int mapped_matrix_create(MappedMatrix *m, const char *path, int rows, int cols) {
+    m->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m->fd < 0) {
+        perror(path);
+        return -1;
+    }
+    if (ftruncate(m->fd, (off_t)((size_t)rows * cols * sizeof(double))) != 0) {
+        perror(path);
+        close(m->fd);
+        return -1;
+    }
+    return map_file(m, path, rows, cols, 1);
+}
+
+void mapped_matrix_drop_cache(MappedMatrix *m) {
+    msync(m->data, m->bytes, MS_SYNC);
+    // Pages still mapped here are skipped by fadvise: unmap them from this process first
+    madvise(m->data, m->bytes, MADV_DONTNEED);
+    posix_fadvise(m->fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+void mapped_matrix_close(MappedMatrix *m) {
+    if (!m->data) return;
+    munmap(m->data, m->bytes);
+    close(m->fd);
+    m->data = NULL;
+}
+
+// ===== Tiling =====
+
+void gemm_ooc_default_config(OocConfig *c) {
+    c->budget = GEMM_OOC_BUDGET;
+    c->tile = 0;
+    c->prefetch = 1;
+}
+
+int gemm_ooc_tile_for_budget(size_t budget, int max_dim) {
+    int t = (int)sqrt((double)budget / (5.0 * sizeof(double)));
+    t -= t % 64;
+    if (t < 64) t = 64;
+    return t < max_dim ? t : max_dim;
+}
+
+// Shared state of the compute thread and the I/O thread
+typedef struct {
+    const MappedMatrix *A, *B;
+    int tile, mt, nt, kt, steps;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int loaded;          // steps whose tiles are in their buffers
+    int consumed;        // steps multiplied (their pages may be evicted again)
+    double read;
+    double bytes;
+} OocPipeline;
+
+// Function to map a step to its tiles: C tiles in row-major order, kb innermost
+static void step_tiles(const OocPipeline *p, int s, int *ib, int *jb, int *kb) {
+    *kb = s % p->kt;
+    *jb = (s / p->kt) % p->nt;
+    *ib = s / (p->kt * p->nt);
+}
+
+static int tile_extent(int total, int tile, int b) {
+    return (total - b * tile < tile) ? total - b * tile : tile;
+}
+
+// Function to ask for asynchronous readahead of a rows x cols tile at (row, col)
+static void advise_tile(const MappedMatrix *m, int row, int col, int rows, int cols) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    for (int i = 0; i < rows; i++) {
+        size_t start = ((size_t)(row + i) * m->cols + col) * sizeof(double);
+        size_t end = start + (size_t)cols * sizeof(double);
+        start -= start % page;
+        madvise((char*)m->data + start, end - start, MADV_WILLNEED);
+    }
+}
+
+// Function to fault in the pages of a rows x cols tile at (row, col): one
+// load per page, so the thread mostly sleeps on the disk instead of using a
+// core. Returns the bytes of the tile.
+static double touch_tile(const MappedMatrix *m, int row, int col, int rows, int cols) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE) / sizeof(double);
+    volatile double sink = 0.0;
+    for (int i = 0; i < rows; i++) {
+        const double *seg = m->data + (size_t)(row + i) * m->cols + col;
+        for (size_t j = 0; j < (size_t)cols; j += page) sink += seg[j];
+        sink += seg[cols - 1];
+    }
+    (void)sink;
+    return (double)rows * cols * sizeof(double);
+}
+
+static void advise_step(const OocPipeline *p, int s) {
+    if (s >= p->steps) return;
+    int ib, jb, kb;
+    step_tiles(p, s, &ib, &jb, &kb);
+    const int T = p->tile;
+    int mb = tile_extent(p->A->rows, T, ib);
+    int kk = tile_extent(p->A->cols, T, kb);
+    int nb = tile_extent(p->B->cols, T, jb);
+    advise_tile(p->A, ib * T, kb * T, mb, kk);
+    advise_tile(p->B, kb * T, jb * T, kk, nb);
+}
+
+// Function to bring the A and B tiles of step s into memory
+static void load_step(OocPipeline *p, int s) {
+    int ib, jb, kb;
+    step_tiles(p, s, &ib, &jb, &kb);
+    const int T = p->tile;
+    int mb = tile_extent(p->A->rows, T, ib);
+    int kk = tile_extent(p->A->cols, T, kb);
+    int nb = tile_extent(p->B->cols, T, jb);
+
+    // One readahead request for every segment, then wait for them page by page
+    double start = bench_now();
+    advise_step(p, s);
+    p->bytes += touch_tile(p->A, ib * T, kb * T, mb, kk);
+    p->bytes += touch_tile(p->B, kb * T, jb * T, kk, nb);
+    p->read += bench_now() - start;
+}
+
+// I/O thread: stays at most one step ahead of the compute thread, so only two
+// steps' tiles need to be resident
+static void* io_thread(void *arg) {
+    OocPipeline *p = arg;
+    for (int s = 1; s < p->steps; s++) {
+        pthread_mutex_lock(&p->lock);
+        while (s - p->consumed >= 2) pthread_cond_wait(&p->cond, &p->lock);
+        pthread_mutex_unlock(&p->lock);
+
+        load_step(p, s);
+
+        pthread_mutex_lock(&p->lock);
+        p->loaded = s + 1;
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return NULL;
+}
+
+static double* allocate_tile(int tile) {
+    return pool_alloc((size_t)tile * tile * sizeof(double));
+}
+
+// ===== Product =====
+
+void gemm_ooc(const MappedMatrix *A, const MappedMatrix *B, MappedMatrix *C,
+              const OocConfig *cfg, OocStats *st) {
+    const int m = C->rows, n = C->cols, k = A->cols;
+    int max_dim = m > n ? m : n;
+    if (k > max_dim) max_dim = k;
+    const int T = cfg->tile > 0 ? cfg->tile : gemm_ooc_tile_for_budget(cfg->budget, max_dim);
+
+    OocPipeline p;
+    memset(&p, 0, sizeof(p));
+    p.A = A;
+    p.B = B;
+    p.tile = T;
+    p.mt = (m + T - 1) / T;
+    p.nt = (n + T - 1) / T;
+    p.kt = (k + T - 1) / T;
+    p.steps = p.mt * p.nt * p.kt;
+    double *cbuf = allocate_tile(T);
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.cond, NULL);
+
+    memset(st, 0, sizeof(*st));
+    st->tile = T;
+    st->steps = p.steps;
+    double wall_start = bench_now();
+
+    // Step 0 is loaded up front in both modes
+    load_step(&p, 0);
+    p.loaded = 1;
+    st->wait = p.read;      // nothing to overlap the first load with
+
+    pthread_t io;
+    int threaded = cfg->prefetch && p.steps > 1;
+    if (threaded && pthread_create(&io, NULL, io_thread, &p) != 0) {
+        threaded = 0;
+    }
+
+    for (int s = 0; s < p.steps; s++) {
+        if (threaded) {
+            double start = bench_now();
+            pthread_mutex_lock(&p.lock);
+            while (p.loaded <= s) pthread_cond_wait(&p.cond, &p.lock);
+            pthread_mutex_unlock(&p.lock);
+            st->wait += bench_now() - start;
+        } else if (s > 0) {
+            load_step(&p, s);
+        }
+
+        int ib, jb, kb;
+        step_tiles(&p, s, &ib, &jb, &kb);
+        int mb = tile_extent(m, T, ib);
+        int nb = tile_extent(n, T, jb);
+        int kk = tile_extent(k, T, kb);
+
+        // gemm_packed packs straight from views of the mappings
+        Matrix a = {A->data + (size_t)ib * T * k + (size_t)kb * T, mb, kk, k, 0};
+        Matrix b = {B->data + (size_t)kb * T * n + (size_t)jb * T, kk, nb, n, 0};
+        Matrix c = {cbuf, mb, nb, nb, 0};
+        if (kb == 0) {
+            // Stores fault in the old pages of the C tile: have them read by the time it is complete
+            advise_tile(C, ib * T, jb * T, mb, nb);
+        }
+        double start = bench_now();
+        if (kb == 0) memset(cbuf, 0, (size_t)mb * nb * sizeof(double));
+        gemm_packed(&a, &b, &c, NULL);
+        st->compute += bench_now() - start;
+
+        if (threaded) {
+            pthread_mutex_lock(&p.lock);
+            p.consumed = s + 1;
+            pthread_cond_broadcast(&p.cond);
+            pthread_mutex_unlock(&p.lock);
+        }
+
+        // Complete C tile: store it into the mapping (the kernel writes it back)
+        if (kb == p.kt - 1) {
+            start = bench_now();
+            for (int i = 0; i < mb; i++) {
+                memcpy(C->data + (size_t)(ib * T + i) * n + jb * T, cbuf + (size_t)i * nb,
+                       (size_t)nb * sizeof(double));
+            }
+            st->write += bench_now() - start;
+            st->bytes_written += (double)mb * nb * sizeof(double);
+        }
+    }
+
+    if (threaded) pthread_join(io, NULL);
+
+    double start = bench_now();
+    msync(C->data, C->bytes, MS_SYNC);
+    st->write += bench_now() - start;
+    st->wall = bench_now() - wall_start;
+    st->read = p.read;
+    st->bytes_read = p.bytes;
+    // Without the I/O thread every read is on the critical path
+    if (!threaded) st->wait = st->read;
+
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.lock);
+    pool_free(cbuf);
+}
+
+double gemm_ooc_overlap(const OocStats *st) {
+    if (st->read <= 0.0) return 0.0;
+    double hidden = 1.0 - st->wait / st->read;
+    return hidden < 0.0 ? 0.0 : (hidden > 1.0 ? 1.0 : hidden);
+}
@@ -0,0 +1,76 @@
+#ifndef GEMM_OOC_H
+#define GEMM_OOC_H
+
+#include <stddef.h>
+
+// Out-of-core GEMM: A, B and C live in files of row-major doubles mapped
+// with mmap, and only a few T x T tiles need to be resident at a time. The
+// product runs over C tiles (kb innermost, the C tile stays in a RAM buffer
+// until it is complete); each step multiplies an A tile by a B tile with
+// gemm_packed, which packs them straight out of the mappings.
+//
+// A step is loaded by one MADV_WILLNEED request per tile row (the kernel
+// reads them ahead in large I/Os), then faulting the pages in. With prefetch
+// on, an I/O thread loads the next step while the current one is multiplied,
+// so disk reads overlap compute.
+// io_uring is not used: the page cache + readahead path needs no extra
+// library and works on any file system.
+
+// Matrix file mapped into memory (MAP_SHARED: stores to C reach the file)
+typedef struct {
+    double *data;
+    int rows;
+    int cols;
+    size_t bytes;
+    int fd;
+} MappedMatrix;
+
+// Map an existing file of rows x cols doubles (read-only unless writable).
+// Returns 0, or -1 after printing the reason.
+int mapped_matrix_open(MappedMatrix *m, const char *path, int rows, int cols, int writable);
+
+// Create (or truncate) a file of rows x cols doubles and map it read-write
+int mapped_matrix_create(MappedMatrix *m, const char *path, int rows, int cols);
+
+// Write dirty pages back and drop the file from the page cache, so that the
+// next reads come from the disk
+void mapped_matrix_drop_cache(MappedMatrix *m);
+
+void mapped_matrix_close(MappedMatrix *m);
+
+typedef struct {
+    size_t budget;     // bytes of RAM for the tile buffers
+    int tile;          // tile edge T (0: the largest that fits the budget)
+    int prefetch;      // 1: double-buffered I/O thread, 0: load each step in turn
+} OocConfig;
+
+// Seconds spent in each part of a product
+typedef struct {
+    int tile;
+    int steps;
+    double wall;       // whole product, final msync included
+    double compute;    // gemm_packed on the tiles
+    double read;       // faulting tiles in (page faults = disk reads)
+    double wait;       // compute blocked on a tile not loaded yet
+    double write;      // C tiles stored into the mapping + final msync
+    double bytes_read;
+    double bytes_written;
+} OocStats;
+
+// Default tile budget: 64 MB
+#define GEMM_OOC_BUDGET (64UL << 20)
+
+void gemm_ooc_default_config(OocConfig *c);
+
+// Tile edge for a budget: five T x T tiles (A and B of two steps, C),
+// rounded down to a multiple of 64 and capped at the largest dimension
+int gemm_ooc_tile_for_budget(size_t budget, int max_dim);
+
+// C = A * B for mapped A (m x k), B (k x n) and C (m x n)
+void gemm_ooc(const MappedMatrix *A, const MappedMatrix *B, MappedMatrix *C,
+              const OocConfig *cfg, OocStats *st);
+
+// Share of the read time hidden behind compute: 1 - wait / read
+double gemm_ooc_overlap(const OocStats *st);
+
+#endif
@@ -0,0 +1,83 @@
+#include "gemm_recursive.h"
+#include "mxm_kernels.h"
+
+typedef struct {
+    WsScheduler *sched;
+    Matrix A;
+    Matrix B;
+    Matrix C;
+    size_t leaf_bytes;
+} RecursiveArgs;
+
+static void recurse(void *arg);
+
+// Function to run two independent halves, the first one as a stealable task
+static void fork_join(RecursiveArgs *first, RecursiveArgs *second, int spawn) {
+    if (!spawn) {
+        recurse(first);
+        recurse(second);
+        return;
+    }
+
+    WsGroup group;
+    WsTask task;
+    ws_group_init(&group);
+    ws_spawn(first->sched, &task, recurse, first, &group);
+    recurse(second);
+    ws_wait(first->sched, &group);
+}
+
+// Function to split the largest dimension until the blocks fit in L1
+static void recurse(void *arg) {
+    RecursiveArgs *r = (RecursiveArgs*)arg;
+    const int m = r->C.rows, n = r->C.cols, k = r->A.cols;
+    const size_t bytes = ((size_t)m * k + (size_t)k * n + (size_t)m * n) * sizeof(double);
+
+    if (bytes <= r->leaf_bytes || (m == 1 && n == 1 && k == 1)) {
+        matrix_multiply_ikj(&r->A, &r->B, &r->C);
+        return;
+    }
+
+    const int spawn = (double)m * n * k > GEMM_RECURSIVE_SPAWN_FLOPS;
+    RecursiveArgs lo = *r, hi = *r;
+
+    if (m >= n && m >= k) {
+        // Split rows of A and C
+        int h = m / 2;
+        lo.A = matrix_view(&r->A, 0, 0, h, k);
+        lo.C = matrix_view(&r->C, 0, 0, h, n);
+        hi.A = matrix_view(&r->A, h, 0, m - h, k);
+        hi.C = matrix_view(&r->C, h, 0, m - h, n);
+        fork_join(&lo, &hi, spawn);
+    } else if (n >= k) {
+        // Split columns of B and C
+        int h = n / 2;
+        lo.B = matrix_view(&r->B, 0, 0, k, h);
+        lo.C = matrix_view(&r->C, 0, 0, m, h);
+        hi.B = matrix_view(&r->B, 0, h, k, n - h);
+        hi.C = matrix_view(&r->C, 0, h, m, n - h);
+        fork_join(&lo, &hi, spawn);
+    } else {
+        // Split the shared dimension: both halves accumulate into the same C
+        int h = k / 2;
+        lo.A = matrix_view(&r->A, 0, 0, m, h);
+        lo.B = matrix_view(&r->B, 0, 0, h, n);
+        hi.A = matrix_view(&r->A, 0, h, m, k - h);
+        hi.B = matrix_view(&r->B, h, 0, k - h, n);
+        recurse(&lo);
+        recurse(&hi);
+    }
+}
+
+// Recursive GEMM entry point
+void gemm_recursive(WsScheduler *s, const Matrix *A, const Matrix *B, Matrix *C,
+                    int leaf_bytes) {
+    RecursiveArgs root;
+    root.sched = s;
+    root.A = *A;
+    root.B = *B;
+    root.C = *C;
+    root.A.owner = root.B.owner = root.C.owner = 0;
+    root.leaf_bytes = leaf_bytes > 0 ? (size_t)leaf_bytes : GEMM_RECURSIVE_LEAF_BYTES;
+    recurse(&root);
+}
@@ -0,0 +1,25 @@
+#ifndef GEMM_RECURSIVE_H
+#define GEMM_RECURSIVE_H
+
+#include "matrix.h"
+#include "ws_sched.h"
+
+// Stop splitting once A, B and C blocks together fit in this many bytes
+// (i7-1255U P-core L1D is 48 KB; keep a third free for streams and stack)
+#ifndef GEMM_RECURSIVE_LEAF_BYTES
+#define GEMM_RECURSIVE_LEAF_BYTES (32 * 1024)
+#endif
+
+// Below this many multiply-adds, recurse inline instead of spawning tasks
+#ifndef GEMM_RECURSIVE_SPAWN_FLOPS
+#define GEMM_RECURSIVE_SPAWN_FLOPS (64 * 64 * 64)
+#endif
+
+// Cache-oblivious C += A * B: split the largest of M, N and K in half until
+// the three blocks fit in leaf_bytes. M and N halves are independent and run
+// as tasks on the work-stealing scheduler; K halves update the same C block
+// and run one after the other. leaf_bytes <= 0 uses the default.
+void gemm_recursive(WsScheduler *s, const Matrix *A, const Matrix *B, Matrix *C,
+                    int leaf_bytes);
+
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+#include "ilp.h"
+#include "bench.h"
+
+// Step operands: the chains stay normal numbers (no denormal slow path) for
+// far more iterations than a run makes
+#define ILP_FACTOR 1.0000001
+#define ILP_ADDEND 1e-9
+
+// Read at run time, so the compiler cannot fold (x AND 0) away and cut the chain
+static volatile double ilp_zero = 0.0;
+
+static const char *op_names[ILP_NUM_OPS] = {"add", "mul", "fma", "div", "sqrt"};
+static const char *width_names[ILP_NUM_WIDTHS] = {"scalar", "sse", "avx2"};
+
+const char* ilp_op_name(IlpOp op) {
+    return (op >= 0 && op < ILP_NUM_OPS) ? op_names[op] : "?";
+}
+
+const char* ilp_width_name(IlpWidth width) {
+    return (width >= 0 && width < ILP_NUM_WIDTHS) ? width_names[width] : "?";
+}
+
+int ilp_supported(IlpOp op, IlpWidth width) {
+    if (op == ILP_FMA && !__builtin_cpu_supports("fma")) return 0;
+    if (width == ILP_AVX2 && !__builtin_cpu_supports("avx2")) return 0;
+    return 1;
+}
+
+int ilp_flops_per_instruction(IlpOp op, IlpWidth width) {
+    int lanes = width == ILP_AVX2 ? 4 : width == ILP_SSE ? 2 : 1;
+    return op == ILP_FMA ? 2 * lanes : lanes;
+}
+
+// ===== Kernels =====
+// One step of a chain per operation; PRE/SUF pick the instruction
+// (_mm/sd scalar, _mm/pd SSE, _mm256/pd AVX2)
+// (sqrt uses b as the all-zero mask and c as its input)
+#define STEP_add(PRE, SUF, x)  PRE##_add_##SUF(x, c)
+#define STEP_mul(PRE, SUF, x)  PRE##_mul_##SUF(x, b)
+#define STEP_fma(PRE, SUF, x)  PRE##_fmadd_##SUF(x, b, c)
+#define STEP_div(PRE, SUF, x)  PRE##_div_##SUF(x, b)
+#define STEP_sqrt(PRE, SUF, x) SQRT_##SUF(PRE, PRE##_or_pd(PRE##_and_pd(x, b), c))
+#define SQRT_sd(PRE, x) _mm_sqrt_sd(x, x)
+#define SQRT_pd(PRE, x) PRE##_sqrt_pd(x)
+
+#define CONST_B_add  ILP_FACTOR
+#define CONST_B_mul  ILP_FACTOR
+#define CONST_B_fma  ILP_FACTOR
+#define CONST_B_div  ILP_FACTOR
+#define CONST_B_sqrt ilp_zero
+#define CONST_C_add  ILP_ADDEND
+#define CONST_C_mul  ILP_ADDEND
+#define CONST_C_fma  ILP_ADDEND
+#define CONST_C_div  ILP_ADDEND
+#define CONST_C_sqrt ILP_SQRT_INPUT
+
+// The chain count must be a compile-time constant for the chains to live in
+// registers, so every kernel is instantiated once per count behind a switch
+#define ILP_CASE(F, C) case C: return F##_chains(C, iterations);
+#define ILP_CASES(F)                                                   \
+    ILP_CASE(F, 1)  ILP_CASE(F, 2)  ILP_CASE(F, 3)  ILP_CASE(F, 4)     \
+    ILP_CASE(F, 5)  ILP_CASE(F, 6)  ILP_CASE(F, 7)  ILP_CASE(F, 8)     \
+    ILP_CASE(F, 9)  ILP_CASE(F, 10) ILP_CASE(F, 11) ILP_CASE(F, 12)    \
+    ILP_CASE(F, 13) ILP_CASE(F, 14)
+
+#define DEFINE_ILP_KERNEL(OP, WIDTH, TARGET, VEC, PRE, SUF)                         \
+    TARGET static inline __attribute__((always_inline))                             \
+    double OP##_##WIDTH##_chains(const int chains, long iterations) {               \
+        VEC x[ILP_MAX_CHAINS];                                                      \
+        const VEC b = PRE##_set1_pd(CONST_B_##OP), c = PRE##_set1_pd(CONST_C_##OP); \
+        (void)b;                                                                    \
+        (void)c;                                                                    \
+        for (int k = 0; k < chains; k++) {                                          \
+            x[k] = PRE##_set1_pd(1.0 + k / 64.0);                                   \
+        }                                                                           \
+        for (long i = 0; i < iterations; i++) {                                     \
+            _Pragma("GCC unroll 14")                                                \
+            for (int k = 0; k < chains; k++) {                                      \
+                x[k] = STEP_##OP(PRE, SUF, x[k]);                                   \
+            }                                                                       \
+        }                                                                           \
+        double sink = 0.0;                                                          \
+        for (int k = 0; k < chains; k++) {                                          \
+            sink += PRE##_cvtsd_f64(x[k]);                                          \
+        }                                                                           \
+        return sink;                                                                \
+    }                                                                               \
+    TARGET static double OP##_##WIDTH(int chains, long iterations) {                \
+        switch (chains) {                                                           \
+        ILP_CASES(OP##_##WIDTH)                                                     \
+        }                                                                           \
+        return 0.0;                                                                 \
+    }
+
+#define NO_TARGET
+#define FMA_TARGET  __attribute__((target("fma")))
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+#define DEFINE_ILP_OP(OP, SCALAR_TARGET)                                \
+    DEFINE_ILP_KERNEL(OP, scalar, SCALAR_TARGET, __m128d, _mm, sd)      \
+    DEFINE_ILP_KERNEL(OP, sse, SCALAR_TARGET, __m128d, _mm, pd)         \
+    DEFINE_ILP_KERNEL(OP, avx2, AVX2_TARGET, __m256d, _mm256, pd)
+
+DEFINE_ILP_OP(add, NO_TARGET)
+DEFINE_ILP_OP(mul, NO_TARGET)
+DEFINE_ILP_OP(fma, FMA_TARGET)
+DEFINE_ILP_OP(div, NO_TARGET)
+DEFINE_ILP_OP(sqrt, NO_TARGET)
+
+typedef double (*ilp_kernel)(int chains, long iterations);
+
+static const ilp_kernel kernels[ILP_NUM_OPS][ILP_NUM_WIDTHS] = {
+    {add_scalar, add_sse, add_avx2},
+    {mul_scalar, mul_sse, mul_avx2},
+    {fma_scalar, fma_sse, fma_avx2},
+    {div_scalar, div_sse, div_avx2},
+    {sqrt_scalar, sqrt_sse, sqrt_avx2},
+};
+
+// Keeps the chain results alive
+static volatile double ilp_sink;
+
+// ===== Measurement =====
+
+double ilp_cycles(IlpOp op, IlpWidth width, int chains, long iterations) {
+    if (!ilp_supported(op, width) || chains < 1 || chains > ILP_MAX_CHAINS) return 0.0;
+    if (iterations <= 0) iterations = ILP_DEFAULT_ITERATIONS;
+
+    ilp_kernel kernel = kernels[op][width];
+    ilp_sink = kernel(chains, iterations);   // warmup
+
+    double best = 0.0;
+    for (int rep = 0; rep < ILP_REPS; rep++) {
+        double ticks;
+        if (bench_cycles_available()) {
+            uint64_t c0 = bench_cycles();
+            ilp_sink = kernel(chains, iterations);
+            ticks = (double)(bench_cycles() - c0);
+        } else {
+            // No TSC: nanoseconds stand in for cycles (1 GHz)
+            double t0 = bench_now();
+            ilp_sink = kernel(chains, iterations);
+            ticks = (bench_now() - t0) * 1e9;
+        }
+        if (rep == 0 || ticks < best) best = ticks;
+    }
+    return best / iterations;
+}
+
+double ilp_throughput_at(const IlpResult *r, int chains) {
+    if (chains < 1 || chains > ILP_MAX_CHAINS || r->cycles[chains] <= 0.0) return 0.0;
+    return chains / r->cycles[chains];
+}
+
+void ilp_measure(IlpOp op, IlpWidth width, long iterations, IlpResult *r) {
+    r->cycles[0] = 0.0;
+    r->latency = r->throughput = 0.0;
+    r->chains = 0;
+    for (int c = 1; c <= ILP_MAX_CHAINS; c++) {
+        r->cycles[c] = ilp_cycles(op, width, c, iterations);
+        if (ilp_throughput_at(r, c) > r->throughput) r->throughput = ilp_throughput_at(r, c);
+    }
+    if (r->throughput <= 0.0) return;
+
+    r->latency = r->cycles[1];
+    for (int c = 1; c <= ILP_MAX_CHAINS; c++) {
+        if (ilp_throughput_at(r, c) >= ILP_SATURATION * r->throughput) {
+            r->chains = c;
+            break;
+        }
+    }
+}
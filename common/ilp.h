@@ -0,0 +1,70 @@
+#ifndef ILP_H
+#define ILP_H
+
+// Latency / throughput microbenchmarks of FP instructions. Each kernel runs
+// `chains` independent dependency chains of one instruction (x = x op b):
+// with one chain every instruction waits for the previous one (latency), and
+// adding chains fills the pipelined ports until throughput stops growing.
+// This is Lab2/Exercice2 (two FMA streams x and y) swept over 1..14 chains.
+// Cycles are TSC (reference) cycles: under turbo the core ticks faster, so
+// latencies read low, but the chain count to saturate is a ratio and is not
+// affected.
+
+// x86-64 has 16 vector registers and every kernel keeps two constants live
+// besides its chains: beyond 14 chains the sweep would measure spills
+#define ILP_MAX_CHAINS 14
+
+// Dependent steps per chain and timed runs (the fastest run is kept)
+#define ILP_DEFAULT_ITERATIONS (1L << 18)
+#define ILP_REPS 5
+
+// sqrt(x) would converge to 1.0 within a few dozen steps, so the sqrt chain
+// takes this full-mantissa input on every step instead: (x AND 0) OR input
+// keeps the dependency on x, at the cost of two 1-cycle logic ops per step
+#define ILP_SQRT_INPUT 2.718281828459045
+
+// Fraction of the best throughput at which the ports count as saturated
+#define ILP_SATURATION 0.9
+
+typedef enum {
+    ILP_ADD = 0,
+    ILP_MUL,
+    ILP_FMA,
+    ILP_DIV,
+    ILP_SQRT,
+    ILP_NUM_OPS
+} IlpOp;
+
+typedef enum {
+    ILP_SCALAR = 0,   // _sd instructions, one double
+    ILP_SSE,          // _pd on 128-bit registers, 2 doubles
+    ILP_AVX2,         // _pd on 256-bit registers, 4 doubles
+    ILP_NUM_WIDTHS
+} IlpWidth;
+
+typedef struct {
+    double cycles[ILP_MAX_CHAINS + 1];   // TSC cycles per iteration (all chains step once), by chain count
+    double latency;                      // cycles per instruction with one chain
+    double throughput;                   // instructions per cycle, best chain count
+    int chains;                          // fewest chains within ILP_SATURATION of that throughput
+} IlpResult;
+
+// Whether this CPU runs op at this width (FMA and AVX2 are checked at runtime)
+int ilp_supported(IlpOp op, IlpWidth width);
+
+// TSC cycles per iteration of `chains` independent chains (iterations <= 0: default)
+double ilp_cycles(IlpOp op, IlpWidth width, int chains, long iterations);
+
+// Sweep 1..ILP_MAX_CHAINS chains and derive latency, throughput and saturation
+void ilp_measure(IlpOp op, IlpWidth width, long iterations, IlpResult *r);
+
+// Instructions per cycle of r at a chain count
+double ilp_throughput_at(const IlpResult *r, int chains);
+
+// Floating-point operations per instruction (lanes, twice for FMA)
+int ilp_flops_per_instruction(IlpOp op, IlpWidth width);
+
+const char* ilp_op_name(IlpOp op);
+const char* ilp_width_name(IlpWidth width);
+
+#endif
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <float.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "lu.h"
+#include "gemm.h"
+
+// Trailing-update chunks: at least this many columns (so gemm_packed keeps
+// wide panels), and about this many chunks per thread for balance
+#define LU_MIN_CHUNK 256
+#define LU_CHUNKS_PER_THREAD 4
+
+void lu_default_params(LuParams *p) {
+    p->nb = LU_NB;
+    p->nbmin = LU_NBMIN;
+    p->depth = 1;
+}
+
+// ===== Building blocks (rows [r0, r1) or columns [c0, c1) of A) =====
+
+// Function to apply the row swaps of pivots [r0, r1) to columns [c0, c1)
+static void apply_swaps(Matrix *A, int r0, int r1, const int *ipiv, int c0, int c1) {
+    for (int i = r0; i < r1; i++) {
+        int p = ipiv[i];
+        if (p == i) continue;
+        double *a = &MAT(A, i, 0), *b = &MAT(A, p, 0);
+        for (int c = c0; c < c1; c++) {
+            double t = a[c];
+            a[c] = b[c];
+            b[c] = t;
+        }
+    }
+}
+
+// Function to overwrite rows [r0, r1) x columns [c0, c1) with L11^-1 times
+// themselves, L11 being the unit lower triangle at rows / columns [r0, r1)
+static void trsm_unit_lower(Matrix *A, int r0, int r1, int c0, int c1) {
+    for (int i = r0 + 1; i < r1; i++) {
+        double *row = &MAT(A, i, 0);
+        for (int p = r0; p < i; p++) {
+            double l = row[p];
+            const double *u = &MAT(A, p, 0);
+            for (int c = c0; c < c1; c++) row[c] -= l * u[c];
+        }
+    }
+}
+
+// Function to subtract L (rows [r0, n) x columns [k0, k1)) times U (rows
+// [k0, k1) x columns [c0, c1)) inside a panel; narrow, so plain loops
+static void panel_update(Matrix *A, int r0, int k0, int k1, int c0, int c1) {
+    for (int i = r0; i < A->rows; i++) {
+        double *row = &MAT(A, i, 0);
+        for (int p = k0; p < k1; p++) {
+            double l = row[p];
+            const double *u = &MAT(A, p, 0);
+            for (int c = c0; c < c1; c++) row[c] -= l * u[c];
+        }
+    }
+}
+
+// ===== Panel factorization =====
+
+// Function to factor columns [j0, j1) over rows [j0, n) one column at a time;
+// rows are swapped inside the panel only
+static int panel_unblocked(Matrix *A, int j0, int j1, int *ipiv) {
+    const int n = A->rows;
+    int info = 0;
+    for (int j = j0; j < j1; j++) {
+        int p = j;
+        double best = fabs(MAT(A, j, j));
+        for (int i = j + 1; i < n; i++) {
+            double v = fabs(MAT(A, i, j));
+            if (v > best) {
+                best = v;
+                p = i;
+            }
+        }
+        ipiv[j] = p;
+        if (p != j) apply_swaps(A, j, j + 1, ipiv, j0, j1);
+
+        double d = MAT(A, j, j);
+        if (d == 0.0) {
+            if (!info) info = j + 1;
+            continue;
+        }
+        // Scale the column and update the rest of the panel in one pass per row
+        double inv = 1.0 / d;
+        const double *u = &MAT(A, j, 0);
+        for (int i = j + 1; i < n; i++) {
+            double *row = &MAT(A, i, 0);
+            double l = row[j] *= inv;
+            for (int c = j + 1; c < j1; c++) row[c] -= l * u[c];
+        }
+    }
+    return info;
+}
+
+// Function to factor columns [j0, j1) recursively: left half, its pivots and
+// U12 / Schur update on the right half, right half, its pivots on the left half
+static int panel_recursive(Matrix *A, int j0, int j1, int *ipiv, int nbmin) {
+    if (j1 - j0 <= nbmin) return panel_unblocked(A, j0, j1, ipiv);
+
+    int jm = j0 + (j1 - j0) / 2;
+    int info = panel_recursive(A, j0, jm, ipiv, nbmin);
+    apply_swaps(A, j0, jm, ipiv, jm, j1);
+    trsm_unit_lower(A, j0, jm, jm, j1);
+    panel_update(A, jm, j0, jm, jm, j1);
+
+    int info_right = panel_recursive(A, jm, j1, ipiv, nbmin);
+    apply_swaps(A, jm, j1, ipiv, j0, jm);
+    return info ? info : info_right;
+}
+
+// ===== Trailing update =====
+
+// Function to bring columns [c0, c1) up to date with panel [k, k + kb):
+// its row swaps, U12, then A22 -= L21 U12 with the negated L21 in negL
+static void update_columns(Matrix *A, const Matrix *negL, int k, int kb, int c0, int c1,
+                           const int *ipiv, const GemmParams *gp) {
+    apply_swaps(A, k, k + kb, ipiv, c0, c1);
+    trsm_unit_lower(A, k, k + kb, c0, c1);
+    if (negL->rows > 0) {
+        Matrix U = matrix_view(A, k, c0, kb, c1 - c0);
+        Matrix C = matrix_view(A, k + kb, c0, negL->rows, c1 - c0);
+        gemm_packed(negL, &U, &C, gp);
+    }
+}
+
+int lu_factor(Matrix *A, int *ipiv, const LuParams *params) {
+    const int n = A->rows;
+    LuParams p;
+    if (params) p = *params;
+    else lu_default_params(&p);
+    if (p.nb < 1) p.nb = LU_NB;
+    if (p.nbmin < 1) p.nbmin = 1;
+
+    GemmParams gp;
+    gemm_default_params(&gp);
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    // gemm_packed only adds, so L21 is kept negated
+    Matrix negL_buf = allocate_matrix(n, p.nb, MATRIX_NO_PAD);
+
+    int info = panel_recursive(A, 0, n < p.nb ? n : p.nb, ipiv, p.nbmin);
+    for (int k = 0; k < n; k += p.nb) {
+        int kb = n - k < p.nb ? n - k : p.nb;
+        int next = k + kb;
+        if (next >= n) break;
+        int next_kb = n - next < p.nb ? n - next : p.nb;
+
+        Matrix negL = matrix_view(&negL_buf, 0, 0, n - next, kb);
+
+        // Chunk 0 is the next panel under lookahead, the rest is split evenly
+        int rest0 = p.depth > 0 ? next + next_kb : next;
+        int rest = n - rest0;
+        int width = (rest + LU_CHUNKS_PER_THREAD * threads - 1) / (LU_CHUNKS_PER_THREAD * threads);
+        if (width < LU_MIN_CHUNK) width = LU_MIN_CHUNK;
+        width = (width + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+        int chunks = (rest + width - 1) / width;
+        int first = p.depth > 0 ? 0 : 1;
+        int panel_info = 0;
+
+        #pragma omp parallel
+        {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < negL.rows; i++) {
+                const double *src = &MAT(A, next + i, k);
+                double *dst = &MAT(&negL, i, 0);
+                for (int c = 0; c < kb; c++) dst[c] = -src[c];
+            }
+
+            // Dynamic: whoever takes chunk 0 factors the next panel, then joins in
+            #pragma omp for schedule(dynamic, 1)
+            for (int c = first; c <= chunks; c++) {
+                if (c == 0) {
+                    update_columns(A, &negL, k, kb, next, next + next_kb, ipiv, &gp);
+                    panel_info = panel_recursive(A, next, next + next_kb, ipiv, p.nbmin);
+                } else {
+                    int c0 = rest0 + (c - 1) * width;
+                    int c1 = c0 + width < n ? c0 + width : n;
+                    update_columns(A, &negL, k, kb, c0, c1, ipiv, &gp);
+                }
+            }
+        }
+
+        // Without lookahead the next panel waits for the whole update
+        if (p.depth == 0) panel_info = panel_recursive(A, next, next + next_kb, ipiv, p.nbmin);
+        if (!info) info = panel_info;
+    }
+
+    // Later pivots on the columns of L left of each panel (deferred, as in dgetrf)
+    int width = LU_MIN_CHUNK;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int c0 = 0; c0 < n; c0 += width) {
+        int c1 = c0 + width < n ? c0 + width : n;
+        for (int k = p.nb; k < n; k += p.nb) {
+            if (k <= c0) continue;
+            int kb = n - k < p.nb ? n - k : p.nb;
+            apply_swaps(A, k, k + kb, ipiv, c0, c1 < k ? c1 : k);
+        }
+    }
+
+    free_matrix(&negL_buf);
+    return info;
+}
+
+void lu_solve(const Matrix *LU, const int *ipiv, double *b) {
+    const int n = LU->rows;
+    for (int i = 0; i < n; i++) {
+        int p = ipiv[i];
+        if (p != i) {
+            double t = b[i];
+            b[i] = b[p];
+            b[p] = t;
+        }
+    }
+    // L y = P b, then U x = y; row-major rows make both dot products contiguous
+    for (int i = 1; i < n; i++) {
+        const double *row = &MAT(LU, i, 0);
+        double s = 0.0;
+        for (int j = 0; j < i; j++) s += row[j] * b[j];
+        b[i] -= s;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        const double *row = &MAT(LU, i, 0);
+        double s = 0.0;
+        for (int j = i + 1; j < n; j++) s += row[j] * b[j];
+        b[i] = (b[i] - s) / row[i];
+    }
+}
+
+double lu_flops(int n) {
+    return 2.0 / 3.0 * n * (double)n * n + 1.5 * n * (double)n;
+}
+
+// ===== HPL problem =====
+
+// Function to hash (seed, i, j) into [-0.5, 0.5) (splitmix64 finalizer)
+static inline double hpl_element(unsigned long seed, int i, int j) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL * ((uint64_t)(unsigned)i << 32 | (unsigned)j);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (double)(z >> 11) * (1.0 / 9007199254740992.0) - 0.5;
+}
+
+void lu_hpl_generate(Matrix *A, double *b, unsigned long seed) {
+    const int n = A->rows;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        double *row = &MAT(A, i, 0);
+        for (int j = 0; j < n; j++) row[j] = hpl_element(seed, i, j);
+        b[i] = hpl_element(seed, i, n);    // b is column n of [A | b], as in HPL
+    }
+}
+
+double lu_hpl_residual(int n, unsigned long seed, const double *x) {
+    double r = 0.0, norm_a = 0.0, norm_b = 0.0, norm_x = 0.0;
+    for (int i = 0; i < n; i++) norm_x = fmax(norm_x, fabs(x[i]));
+
+    #pragma omp parallel for schedule(static) reduction(max:r, norm_a, norm_b)
+    for (int i = 0; i < n; i++) {
+        double ax = 0.0, row_sum = 0.0;
+        for (int j = 0; j < n; j++) {
+            double a = hpl_element(seed, i, j);
+            ax += a * x[j];
+            row_sum += fabs(a);
+        }
+        double bi = hpl_element(seed, i, n);
+        r = fmax(r, fabs(ax - bi));
+        norm_a = fmax(norm_a, row_sum);
+        norm_b = fmax(norm_b, fabs(bi));
+    }
+
+    // Unit roundoff, HPL_dlamch(HPL_MACH_EPS)
+    double eps = DBL_EPSILON / 2.0;
+    return r / (eps * (norm_a * norm_x + norm_b) * n);
+}
@@ -0,0 +1,48 @@
+#ifndef LU_H
+#define LU_H
+
+#include "matrix.h"
+
+// Right-looking blocked LU with partial pivoting (HPL's algorithm on one
+// process, row-major):
+//   - panels of NB columns factored recursively (halves down to NBMIN columns,
+//     then unblocked), pivots searched over the whole column below the diagonal
+//   - the trailing matrix updated in column chunks: row swaps, U12 = L11^-1 A12,
+//     then A22 -= L21 U12 through gemm_packed; chunks go to the threads
+//   - lookahead depth 1: the next panel's columns are updated first and that
+//     panel is factored by one thread while the others update the rest
+#define LU_NB    128
+#define LU_NBMIN 8
+
+typedef struct {
+    int nb;        // panel width
+    int nbmin;     // recursion stops at this many columns
+    int depth;     // lookahead depth (0 or 1)
+} LuParams;
+
+void lu_default_params(LuParams *p);
+
+// Factor A = P L U in place: L unit lower (below the diagonal), U upper. ipiv
+// holds n entries: row i was swapped with row ipiv[i] (LAPACK's convention,
+// 0-based). Returns 0, or j + 1 if U(j, j) is exactly zero (like LAPACK's info).
+// params may be NULL for the defaults.
+int lu_factor(Matrix *A, int *ipiv, const LuParams *params);
+
+// Solve A x = b with lu_factor's output; b is overwritten with x
+void lu_solve(const Matrix *LU, const int *ipiv, double *b);
+
+// HPL operation count for an n x n solve: 2/3 n^3 + 3/2 n^2
+double lu_flops(int n);
+
+// ===== HPL problem =====
+// Uniform entries in [-0.5, 0.5) from a hash of (seed, row, column), so the
+// residual check regenerates A and b instead of keeping a copy of A.
+
+void lu_hpl_generate(Matrix *A, double *b, unsigned long seed);
+
+// HPL's scaled residual ||A x - b||_oo / (eps (||A||_oo ||x||_oo + ||b||_oo) n);
+// the run passes below LU_HPL_THRESHOLD
+#define LU_HPL_THRESHOLD 16.0
+double lu_hpl_residual(int n, unsigned long seed, const double *x);
+
+#endif
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "matrix.h"
+#include "arena.h"
+
+// Function to compute the leading dimension of a matrix row
+int matrix_leading_dim(int cols, int padding) {
+    const int line = MATRIX_ALIGNMENT / sizeof(double);
+
+    // Round up to a whole number of cache lines so every row stays aligned
+    int ld = (cols + line - 1) / line * line;
+
+    // Power-of-two-like strides send every row to the same cache sets:
+    // shift each row by one extra cache line to spread them out
+    if (padding == MATRIX_PAD && ((size_t)ld * sizeof(double)) % MATRIX_ALIAS_STRIDE == 0) {
+        ld += line;
+    }
+    return ld;
+}
+
+// Function to allocate a matrix
+Matrix allocate_matrix(int rows, int cols, int padding) {
+    Matrix m;
+    m.rows = rows;
+    m.cols = cols;
+    m.ld = matrix_leading_dim(cols, padding);
+    m.owner = 1;
+
+    // From the pool: a benchmark that frees and reallocates the same shapes
+    // gets its buffers back instead of new ones from the system
+    m.data = pool_alloc((size_t)rows * m.ld * sizeof(double));
+    return m;
+}
+
+// Function to free a matrix
+void free_matrix(Matrix *m) {
+    if (!m || !m->data) return;
+    if (m->owner) {
+        pool_free(m->data);
+    }
+    m->data = NULL;
+}
+
+// Function to create a view over a sub-block of a matrix
+Matrix matrix_view(const Matrix *m, int row, int col, int rows, int cols) {
+    Matrix v;
+    v.data = m->data + (size_t)row * m->ld + col;
+    v.rows = rows;
+    v.cols = cols;
+    v.ld = m->ld;
+    v.owner = 0;
+    return v;
+}
+
+// Function to initialize a matrix with random values
+void initialize_matrix(Matrix *m) {
+    for (int i = 0; i < m->rows; i++) {
+        for (int j = 0; j < m->cols; j++) {
+            MAT(m, i, j) = (double)(rand() % 100) / 10.0;
+        }
+    }
+}
+
+// Function to zero-initialize a matrix
+void zero_matrix(Matrix *m) {
+    for (int i = 0; i < m->rows; i++) {
+        memset(&MAT(m, i, 0), 0, (size_t)m->cols * sizeof(double));
+    }
+}
+
+// Function to copy a matrix
+void copy_matrix(Matrix *dst, const Matrix *src) {
+    for (int i = 0; i < src->rows; i++) {
+        memcpy(&MAT(dst, i, 0), &MAT(src, i, 0), (size_t)src->cols * sizeof(double));
+    }
+}
+
+// Function to verify if two matrices are equal (within tolerance)
+int verify_matrices(const Matrix *C1, const Matrix *C2) {
+    double tolerance = 1e-6;
+    for (int i = 0; i < C1->rows; i++) {
+        for (int j = 0; j < C1->cols; j++) {
+            if (fabs(MAT(C1, i, j) - MAT(C2, i, j)) > tolerance) {
+                printf("Mismatch at [%d][%d]: %f vs %f\n", i, j, MAT(C1, i, j), MAT(C2, i, j));
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Function to verify two matrices against a relative tolerance
+int verify_matrices_rel(const Matrix *C1, const Matrix *C2, double tol) {
+    for (int i = 0; i < C1->rows; i++) {
+        for (int j = 0; j < C1->cols; j++) {
+            double ref = fabs(MAT(C2, i, j));
+            if (fabs(MAT(C1, i, j) - MAT(C2, i, j)) > tol * ref) {
+                printf("Mismatch at [%d][%d]: %f vs %f (relative %.2e > %.2e)\n", i, j,
+                       MAT(C1, i, j), MAT(C2, i, j), fabs(MAT(C1, i, j) - MAT(C2, i, j)) / ref, tol);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Function to compute the largest absolute difference between two matrices
+double matrix_max_abs_error(const Matrix *C1, const Matrix *C2) {
+    double max_err = 0.0;
+    for (int i = 0; i < C1->rows; i++) {
+        for (int j = 0; j < C1->cols; j++) {
+            double err = fabs(MAT(C1, i, j) - MAT(C2, i, j));
+            if (err > max_err) max_err = err;
+        }
+    }
+    return max_err;
+}
+
+// Function to compute the largest relative difference against a reference
+double matrix_max_rel_error(const Matrix *C1, const Matrix *C2) {
+    double max_err = 0.0;
+    for (int i = 0; i < C1->rows; i++) {
+        for (int j = 0; j < C1->cols; j++) {
+            double ref = fabs(MAT(C2, i, j));
+            double err = fabs(MAT(C1, i, j) - MAT(C2, i, j)) / (ref > 1e-300 ? ref : 1e-300);
+            if (err > max_err) max_err = err;
+        }
+    }
+    return max_err;
+}
@@ -0,0 +1,66 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stddef.h>
+
+// Every matrix buffer starts on a cache-line boundary (also enough for AVX-512 loads)
+#define MATRIX_ALIGNMENT 64
+
+// Rows whose byte stride is a multiple of this map to the same L1 sets
+// (48 KB / 12-way L1D on the i7-1255U -> 4 KB critical stride); padding
+// kicks in only for those strides (N = 512, 1024, ... doubles)
+#define MATRIX_ALIAS_STRIDE 4096
+
+// Padding policy for allocate_matrix()
+#define MATRIX_NO_PAD 0
+#define MATRIX_PAD    1
+
+// Row-major matrix stored in one contiguous, 64-byte aligned buffer.
+// Element (i, j) lives at data[i * ld + j] with ld >= cols.
+// Views share the buffer of their parent and have owner == 0.
+typedef struct {
+    double *data;
+    int rows;
+    int cols;
+    int ld;
+    int owner;
+} Matrix;
+
+// Element access: MAT(&A, i, j) = 1.0;
+#define MAT(m, i, j) ((m)->data[(size_t)(i) * (m)->ld + (j)])
+
+// Leading dimension used for a row of 'cols' doubles under the given policy
+int matrix_leading_dim(int cols, int padding);
+
+// Allocate a rows x cols matrix (exits on failure, like the rest of the labs)
+Matrix allocate_matrix(int rows, int cols, int padding);
+
+// Free a matrix allocated with allocate_matrix (no-op on views)
+void free_matrix(Matrix *m);
+
+// Sub-block view [row, row+rows) x [col, col+cols) sharing m's buffer
+Matrix matrix_view(const Matrix *m, int row, int col, int rows, int cols);
+
+// Fill with random values in [0, 9.9] (same distribution as the original labs)
+void initialize_matrix(Matrix *m);
+
+// Set every element to zero
+void zero_matrix(Matrix *m);
+
+// Copy src into dst (same shape, any leading dimensions)
+void copy_matrix(Matrix *dst, const Matrix *src);
+
+// Return 1 if C1 and C2 match within 1e-6, print the first mismatch otherwise
+int verify_matrices(const Matrix *C1, const Matrix *C2);
+
+// Return 1 if |C1 - C2| <= tol * |C2| everywhere (C2 being the reference),
+// print the first mismatch otherwise
+int verify_matrices_rel(const Matrix *C1, const Matrix *C2, double tol);
+
+// Largest |C1 - C2| over all elements
+double matrix_max_abs_error(const Matrix *C1, const Matrix *C2);
+
+// Largest |C1 - C2| / max(|C2|, 1e-300), C2 being the reference
+double matrix_max_rel_error(const Matrix *C1, const Matrix *C2);
+
+#endif
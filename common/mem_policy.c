@@ -0,0 +1,236 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "mem_policy.h"
+
+// Node masks cover this many nodes
+#define MAX_NODES 1024
+#define MASK_WORDS (MAX_NODES / (8 * sizeof(unsigned long)))
+
+static const char *page_names[PAGES_NUM_POLICIES] = {"default", "4k", "thp", "hugetlb"};
+static const char *numa_names[NUMA_NUM_POLICIES] = {"default", "local", "interleave"};
+
+int page_policy_parse(const char *name) {
+    for (int i = 0; i < PAGES_NUM_POLICIES; i++) {
+        if (strcmp(name, page_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char* page_policy_name(PagePolicy p) {
+    return p >= 0 && p < PAGES_NUM_POLICIES ? page_names[p] : "unknown";
+}
+
+int numa_policy_parse(const char *name) {
+    for (int i = 0; i < NUMA_NUM_POLICIES; i++) {
+        if (strcmp(name, numa_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char* numa_policy_name(NumaPolicy p) {
+    return p >= 0 && p < NUMA_NUM_POLICIES ? numa_names[p] : "unknown";
+}
+
+void mem_policy_default(MemPolicy *p) {
+    p->pages = PAGES_DEFAULT;
+    p->numa = NUMA_DEFAULT;
+
+    const char *env = getenv("MEM_PAGES");
+    if (env) {
+        int v = page_policy_parse(env);
+        if (v >= 0) p->pages = (PagePolicy)v;
+        else fprintf(stderr, "MEM_PAGES: unknown page policy %s, using default\n", env);
+    }
+    env = getenv("MEM_NUMA");
+    if (env) {
+        int v = numa_policy_parse(env);
+        if (v >= 0) p->numa = (NumaPolicy)v;
+        else fprintf(stderr, "MEM_NUMA: unknown NUMA policy %s, using default\n", env);
+    }
+}
+
+int mem_policy_parse_arg(MemPolicy *p, const char *arg) {
+    if (strncmp(arg, "--pages=", 8) == 0) {
+        int v = page_policy_parse(arg + 8);
+        if (v < 0) {
+            fprintf(stderr, "Unknown page policy: %s (default, 4k, thp, hugetlb)\n", arg + 8);
+            return -1;
+        }
+        p->pages = (PagePolicy)v;
+        return 1;
+    }
+    if (strncmp(arg, "--numa=", 7) == 0) {
+        int v = numa_policy_parse(arg + 7);
+        if (v < 0) {
+            fprintf(stderr, "Unknown NUMA policy: %s (default, local, interleave)\n", arg + 7);
+            return -1;
+        }
+        p->numa = (NumaPolicy)v;
+        return 1;
+    }
+    return 0;
+}
+
+// ===== NUMA =====
+
+// Function to read the nodes with memory ("0", "0-1,4") into a mask
+static int memory_nodes(unsigned long *mask) {
+    memset(mask, 0, MASK_WORDS * sizeof(unsigned long));
+    FILE *f = fopen("/sys/devices/system/node/has_memory", "r");
+    if (!f) {
+        mask[0] = 1;    // no NUMA support in the kernel: one node
+        return 1;
+    }
+    char line[4096];
+    int count = 0;
+    if (fgets(line, sizeof(line), f)) {
+        char *s = line;
+        while (*s && *s != '\n') {
+            char *end;
+            long lo = strtol(s, &end, 10), hi = lo;
+            if (end == s) break;
+            if (*end == '-') hi = strtol(end + 1, &end, 10);
+            for (long n = lo; n <= hi && n < MAX_NODES; n++) {
+                mask[n / (8 * sizeof(unsigned long))] |= 1UL << (n % (8 * sizeof(unsigned long)));
+                count++;
+            }
+            s = *end == ',' ? end + 1 : end;
+        }
+    }
+    fclose(f);
+    if (count == 0) {
+        mask[0] = 1;
+        count = 1;
+    }
+    return count;
+}
+
+int mem_numa_nodes(void) {
+    unsigned long mask[MASK_WORDS];
+    return memory_nodes(mask);
+}
+
+// Function to set the NUMA policy of a mapping before its first touch
+// (raw syscalls, so there is no libnuma dependency)
+static int apply_numa(void *data, size_t len, NumaPolicy policy) {
+    unsigned long mask[MASK_WORDS];
+    int mode;
+    if (policy == NUMA_INTERLEAVE) {
+        memory_nodes(mask);
+        mode = MPOL_INTERLEAVE;
+    } else {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0 || node >= MAX_NODES) node = 0;
+        memset(mask, 0, sizeof(mask));
+        mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+        mode = MPOL_BIND;
+    }
+    return syscall(SYS_mbind, data, len, mode, mask, (unsigned long)MAX_NODES + 1, 0) == 0;
+}
+
+// ===== Regions =====
+
+static size_t round_up(size_t bytes, size_t unit) {
+    if (bytes == 0) bytes = 1;
+    return (bytes + unit - 1) / unit * unit;
+}
+
+// Function to map len bytes on a 2 MB boundary: over-allocate by one huge
+// page and trim both ends
+static void* map_huge_aligned(size_t len) {
+    size_t span = len + HUGE_PAGE_BYTES;
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    char *aligned = (char*)(((uintptr_t)raw + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1));
+    if (aligned > raw) munmap(raw, aligned - raw);
+    if (raw + span > aligned + len) munmap(aligned + len, raw + span - (aligned + len));
+    return aligned;
+}
+
+int mem_region_alloc(MemRegion *r, size_t bytes, const MemPolicy *p) {
+    memset(r, 0, sizeof(*r));
+    r->bytes = bytes;
+    r->pages = p->pages;
+    r->numa = p->numa;
+
+    if (r->pages == PAGES_HUGETLB) {
+        r->len = round_up(bytes, HUGE_PAGE_BYTES);
+        void *data = mmap(NULL, r->len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) r->data = data;
+        else r->pages = PAGES_THP;    // no reserved huge pages (vm.nr_hugepages)
+    }
+
+    if (r->pages == PAGES_THP) {
+        r->len = round_up(bytes, HUGE_PAGE_BYTES);
+        r->data = map_huge_aligned(r->len);
+        if (!r->data) return 0;
+        madvise(r->data, r->len, MADV_HUGEPAGE);
+    } else if (!r->data) {
+        r->len = round_up(bytes, (size_t)sysconf(_SC_PAGESIZE));
+        void *data = mmap(NULL, r->len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) return 0;
+        r->data = data;
+        if (r->pages == PAGES_4K) madvise(r->data, r->len, MADV_NOHUGEPAGE);
+    }
+
+    if (r->numa != NUMA_DEFAULT) r->numa_applied = apply_numa(r->data, r->len, r->numa);
+    return 1;
+}
+
+void mem_region_free(MemRegion *r) {
+    if (r->data) munmap(r->data, r->len);
+    r->data = NULL;
+}
+
+size_t mem_region_huge_kb(const MemRegion *r) {
+    if (!r->data) return 0;
+    if (r->pages == PAGES_HUGETLB) return r->len / 1024;
+
+    // AnonHugePages of the mapping holding the region
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (!f) return 0;
+    char line[512];
+    uintptr_t start, end, addr = (uintptr_t)r->data;
+    int inside = 0;
+    size_t kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            if (inside) break;
+            inside = addr >= start && addr < end;
+        } else if (inside && sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return kb < r->len / 1024 ? kb : r->len / 1024;
+}
+
+const char* mem_region_backing(const MemRegion *r, char *buf, size_t len) {
+    if (r->pages == PAGES_HUGETLB) {
+        snprintf(buf, len, "2M hugetlb");
+        return buf;
+    }
+    size_t huge = mem_region_huge_kb(r);
+    if (r->pages == PAGES_THP || huge > 0) snprintf(buf, len, "2M THP %.0f%%", 100.0 * huge * 1024 / r->len);
+    else snprintf(buf, len, "4K");
+    return buf;
+}
+
+// ===== Page faults =====
+
+void mem_faults_read(MemFaults *f) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    f->minor = ru.ru_minflt;
+    f->major = ru.ru_majflt;
+}
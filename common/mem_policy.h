@@ -0,0 +1,84 @@
+#ifndef MEM_POLICY_H
+#define MEM_POLICY_H
+
+#include <stddef.h>
+
+// Placement of large arrays, chosen per run: the page size backing them and
+// the NUMA node(s) their pages come from. Arrays of hundreds of MB on 4 KB
+// pages pay one fault per page on first touch and miss the dTLB on every
+// new page; 2 MB pages cut both by 512x.
+//
+// Select with --pages= / --numa= (mem_policy_parse_arg) or with the
+// MEM_PAGES / MEM_NUMA environment variables (mem_policy_default).
+
+#define HUGE_PAGE_BYTES (2UL * 1024 * 1024)
+
+typedef enum {
+    PAGES_DEFAULT = 0,   // plain anonymous mapping, as malloc gives: the system THP mode decides
+    PAGES_4K,            // MADV_NOHUGEPAGE
+    PAGES_THP,           // 2 MB-aligned mapping with MADV_HUGEPAGE (transparent huge pages)
+    PAGES_HUGETLB,       // MAP_HUGETLB from the reserved pool; PAGES_THP if the pool is empty
+    PAGES_NUM_POLICIES
+} PagePolicy;
+
+typedef enum {
+    NUMA_DEFAULT = 0,    // first touch: each page lands on the node of the thread writing it first
+    NUMA_LOCAL,          // every page on the node of the allocating thread (MPOL_BIND)
+    NUMA_INTERLEAVE,     // pages round-robin over the memory nodes (MPOL_INTERLEAVE)
+    NUMA_NUM_POLICIES
+} NumaPolicy;
+
+typedef struct {
+    PagePolicy pages;
+    NumaPolicy numa;
+} MemPolicy;
+
+typedef struct {
+    void *data;
+    size_t bytes;        // requested
+    size_t len;          // mapped (a multiple of the page size)
+    PagePolicy pages;    // what was mapped (PAGES_HUGETLB may have fallen back to PAGES_THP)
+    NumaPolicy numa;
+    int numa_applied;    // 1 if the kernel accepted the NUMA policy
+} MemRegion;
+
+// Parse "default", "4k", "thp" or "hugetlb"; returns -1 on unknown names
+int page_policy_parse(const char *name);
+const char* page_policy_name(PagePolicy p);
+
+// Parse "default", "local" or "interleave"; returns -1 on unknown names
+int numa_policy_parse(const char *name);
+const char* numa_policy_name(NumaPolicy p);
+
+// Policy from MEM_PAGES / MEM_NUMA (default / default when unset or unknown)
+void mem_policy_default(MemPolicy *p);
+
+// Consume --pages=NAME or --numa=NAME: 1 if arg was one of them, 0 if not,
+// -1 for an unknown name (reported on stderr)
+int mem_policy_parse_arg(MemPolicy *p, const char *arg);
+
+// Map bytes under the policy without touching them (the first write faults
+// the pages in, on the policy's node). Returns 0 if the mapping failed.
+int mem_region_alloc(MemRegion *r, size_t bytes, const MemPolicy *p);
+void mem_region_free(MemRegion *r);
+
+// kB of the region backed by huge pages (after it has been touched)
+size_t mem_region_huge_kb(const MemRegion *r);
+
+// What backs a touched region: "4K", "2M hugetlb", "2M THP 97%"
+const char* mem_region_backing(const MemRegion *r, char *buf, size_t len);
+
+// Number of nodes with memory (1 on a non-NUMA machine)
+int mem_numa_nodes(void);
+
+// ===== Page faults =====
+
+typedef struct {
+    long minor;          // faults served without I/O (first touch of anonymous memory)
+    long major;
+} MemFaults;
+
+// Process totals so far (getrusage); subtract two reads to count a region
+void mem_faults_read(MemFaults *f);
+
+#endif
@@ -0,0 +1,480 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/resource.h>
+#include <sys/single_threaded.h>
+
+// In-process heap profiler: a Valgrind-style heap and leak summary at a few
+// percent of the cost, so it can run at full problem sizes.
+//
+//   gcc -O2 -shared -fPIC -o libmemprof.so memprof.c -ldl
+//   LD_PRELOAD=./libmemprof.so ./program             (any dynamic binary)
+//   gcc -g -rdynamic program.c memprof.c -ldl        (or linked in directly)
+//
+// malloc, calloc, realloc, free and the aligned variants (posix_memalign,
+// aligned_alloc, memalign, valloc, pvalloc) are interposed and forwarded to
+// glibc. A 16-byte header in front of each block records its size and
+// allocation site, so free costs three counter updates and no lookup; the
+// updates are plain stores until the process starts a thread. A site is
+// the caller's return address; its full backtrace is sampled once, on the
+// site's first allocation, so the stack walk stays off the hot path.
+//
+// At exit (stderr): total allocations, peak live heap, peak RSS, the sites
+// that allocated the most, and the blocks never freed grouped by site.
+// Stdio buffers, which glibc keeps until the process dies, and the blocks of
+// the dynamic loader and libgomp (thread TLS, OpenMP thread pool) are listed
+// as still reachable rather than as leaks. Symbols need -rdynamic; the module
+// offset printed next to each frame goes to addr2line -e <module>.
+//
+//   MEMPROF_TOP=n     allocation sites listed (default 5, 0: leaks only)
+
+// glibc's allocator, below any interposer
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void *p, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *p);
+
+#define HEADER 16                // keeps malloc's 16-byte alignment
+#define MAX_SITES 16384          // power of two; full table: site 0
+#define STACK_DEPTH 8
+#define REPORT_LEAK_SITES 20
+
+typedef struct {
+    size_t size;
+    uint32_t site;
+    uint32_t offset;             // user pointer - block start
+} BlockHeader;
+
+typedef struct {
+    _Atomic uintptr_t pc;        // 0: free slot
+    atomic_long allocs;
+    atomic_long frees;
+    atomic_long bytes_total;
+    atomic_long bytes_freed;
+    _Atomic int stack_state;     // 0: none, 1: being captured, 2: ready
+    int depth;
+    void *stack[STACK_DEPTH];
+} Site;
+
+// Site 0 collects the profiler's own allocations (the unwinder, dladdr) and
+// is left out of the report, like a tool's own memory under Valgrind
+static Site sites[MAX_SITES];
+static atomic_int sites_overflow;
+
+static atomic_long live_bytes;
+static atomic_long peak_bytes;
+
+// Set while the profiler itself allocates (backtrace, dladdr)
+static __thread int in_profiler __attribute__((tls_model("initial-exec")));
+
+// Function to add to a counter: a locked add costs more than the allocation
+// itself, so it is only paid once there is a second thread
+static inline void count(atomic_long *c, long delta) {
+    if (__libc_single_threaded) {
+        atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + delta, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(c, delta, memory_order_relaxed);
+    }
+}
+
+static long site_live_bytes(const Site *s) {
+    return atomic_load(&s->bytes_total) - atomic_load(&s->bytes_freed);
+}
+
+static long site_live_blocks(const Site *s) {
+    return atomic_load(&s->allocs) - atomic_load(&s->frees);
+}
+
+// ===== Site table =====
+
+// Function to find or claim the site of a return address (open addressing)
+static uint32_t site_index(void *caller) {
+    uintptr_t pc = (uintptr_t)caller;
+    if (in_profiler || pc == 0) return 0;
+    uint32_t h = (uint32_t)((pc >> 4) * 0x9E3779B1u) & (MAX_SITES - 1);
+    for (int probe = 0; probe < 64; probe++) {
+        uint32_t i = (h + probe) & (MAX_SITES - 1);
+        if (i == 0) continue;
+        uintptr_t cur = atomic_load_explicit(&sites[i].pc, memory_order_acquire);
+        if (cur == pc) return i;
+        if (cur == 0) {
+            uintptr_t expected = 0;
+            if (atomic_compare_exchange_strong(&sites[i].pc, &expected, pc)) return i;
+            if (expected == pc) return i;
+        }
+    }
+    atomic_store_explicit(&sites_overflow, 1, memory_order_relaxed);
+    return 0;
+}
+
+// Function to sample the backtrace of a site on its first allocation
+static __attribute__((noinline)) void capture_stack(Site *s) {
+    int none = 0;
+    if (!atomic_compare_exchange_strong(&s->stack_state, &none, 1)) return;
+    void *frames[STACK_DEPTH + 4];
+    in_profiler = 1;
+    int n = backtrace(frames, STACK_DEPTH + 4);
+    in_profiler = 0;
+    // Start at the caller: the profiler's own frames (some of them tail
+    // calls) are dropped whatever their number
+    int first = 0;
+    while (first < n && (uintptr_t)frames[first] != s->pc) first++;
+    if (first == n) first = 0;
+    s->depth = n - first < STACK_DEPTH ? n - first : STACK_DEPTH;
+    memcpy(s->stack, frames + first, s->depth * sizeof(void*));
+    atomic_store_explicit(&s->stack_state, 2, memory_order_release);
+}
+
+// Function to tag a new block and count it against its site
+static __attribute__((noinline)) void* record(void *base, size_t offset, size_t size, void *caller) {
+    if (!base) return NULL;
+    uint32_t idx = site_index(caller);
+    BlockHeader *h = (BlockHeader*)((char*)base + offset - HEADER);
+    h->size = size;
+    h->site = idx;
+    h->offset = (uint32_t)offset;
+
+    Site *s = &sites[idx];
+    count(&s->allocs, 1);
+    count(&s->bytes_total, (long)size);
+    if (idx == 0) return (char*)base + offset;
+
+    count(&live_bytes, (long)size);
+    long live = atomic_load_explicit(&live_bytes, memory_order_relaxed);
+    long peak = atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&peak_bytes, &peak, live, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+    if (atomic_load_explicit(&s->stack_state, memory_order_relaxed) == 0) {
+        capture_stack(s);
+    }
+    return (char*)base + offset;
+}
+
+// Function to uncount a block (from its header)
+static void uncount(const BlockHeader *h) {
+    Site *s = &sites[h->site];
+    count(&s->frees, 1);
+    count(&s->bytes_freed, (long)h->size);
+    if (h->site != 0) count(&live_bytes, -(long)h->size);
+}
+
+// Function to uncount a block; returns where the underlying allocation starts
+static void* forget(void *p) {
+    BlockHeader *h = (BlockHeader*)((char*)p - HEADER);
+    uncount(h);
+    return (char*)p - h->offset;
+}
+
+// ===== Interposed allocator =====
+
+void* malloc(size_t size) {
+    if (size > SIZE_MAX - HEADER) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return record(__libc_malloc(size + HEADER), HEADER, size, __builtin_return_address(0));
+}
+
+void* calloc(size_t n, size_t size) {
+    if (size != 0 && n > (SIZE_MAX - HEADER) / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return record(__libc_calloc(1, n * size + HEADER), HEADER, n * size, __builtin_return_address(0));
+}
+
+void free(void *p) {
+    if (p) __libc_free(forget(p));
+}
+
+// Function to allocate with a header in front of an aligned payload
+static void* aligned(size_t alignment, size_t size, void *caller) {
+    if (alignment < HEADER) alignment = HEADER;
+    if (size > SIZE_MAX - alignment) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    // The header fits in the first 'alignment' bytes
+    return record(__libc_memalign(alignment, size + alignment), alignment, size, caller);
+}
+
+void* realloc(void *p, size_t size) {
+    void *caller = __builtin_return_address(0);
+    if (!p) return record(__libc_malloc(size + HEADER), HEADER, size, caller);
+    if (size == 0) {
+        free(p);
+        return NULL;
+    }
+    if (size > SIZE_MAX - HEADER) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    BlockHeader *h = (BlockHeader*)((char*)p - HEADER);
+    if (h->offset != HEADER) {
+        // Aligned block: glibc's realloc would drop the alignment
+        size_t old = h->size;
+        void *q = aligned(h->offset, size, caller);
+        if (!q) return NULL;
+        memcpy(q, p, old < size ? old : size);
+        free(p);
+        return q;
+    }
+    void *base = __libc_realloc((char*)p - HEADER, size + HEADER);
+    if (!base) return NULL;
+    // Moved or not, the old block leaves its site (the header came along) and
+    // the new one joins the caller's
+    uncount((BlockHeader*)base);
+    return record(base, HEADER, size, caller);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    if (alignment == 0 || (alignment & (alignment - 1)) || alignment % sizeof(void*)) return EINVAL;
+    void *p = aligned(alignment, size, __builtin_return_address(0));
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return aligned(alignment, size, __builtin_return_address(0));
+}
+
+void* memalign(size_t alignment, size_t size) {
+    return aligned(alignment, size, __builtin_return_address(0));
+}
+
+void* valloc(size_t size) {
+    return aligned((size_t)sysconf(_SC_PAGESIZE), size, __builtin_return_address(0));
+}
+
+// Like valloc, with the size rounded up to whole pages (0: one page, as glibc)
+void* pvalloc(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t rounded = size ? (size + page - 1) & ~(page - 1) : page;
+    if (rounded < size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return aligned(page, rounded, __builtin_return_address(0));
+}
+
+size_t malloc_usable_size(void *p) {
+    return p ? ((BlockHeader*)((char*)p - HEADER))->size : 0;
+}
+
+// ===== Report =====
+
+// The report is formatted into a stack buffer and written with write(2), so
+// printing it allocates nothing
+
+static void out(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void out(const char *fmt, ...) {
+    char line[512];
+    int len = snprintf(line, sizeof(line), "==%d== ", (int)getpid());
+    va_list ap;
+    va_start(ap, fmt);
+    len += vsnprintf(line + len, sizeof(line) - len, fmt, ap);
+    va_end(ap);
+    if (len > (int)sizeof(line) - 2) len = (int)sizeof(line) - 2;
+    line[len++] = '\n';
+    ssize_t w = write(STDERR_FILENO, line, len);
+    (void)w;
+}
+
+static void blank(void) {
+    out("%s", "");
+}
+
+// Function to print a count with thousands separators, Valgrind style
+static const char* commas(long v, char *buf) {
+    char tmp[32];
+    int n = snprintf(tmp, sizeof(tmp), "%ld", v < 0 ? -v : v);
+    int j = 0;
+    if (v < 0) buf[j++] = '-';
+    for (int i = 0; i < n; i++) {
+        if (i > 0 && (n - i) % 3 == 0) buf[j++] = ',';
+        buf[j++] = tmp[i];
+    }
+    buf[j] = '\0';
+    return buf;
+}
+
+static void print_frame(const char *prefix, void *pc) {
+    Dl_info info;
+    // pc - 1: the call instruction, not the one after it
+    if (dladdr((char*)pc - 1, &info) && info.dli_fname) {
+        const char *module = strrchr(info.dli_fname, '/');
+        module = module ? module + 1 : info.dli_fname;
+        out("   %s %p: %s (%s+0x%lx)", prefix, pc, info.dli_sname ? info.dli_sname : "???", module,
+            (unsigned long)((char*)pc - (char*)info.dli_fbase));
+    } else {
+        out("   %s %p: ???", prefix, pc);
+    }
+}
+
+static void print_site(const Site *s) {
+    if (atomic_load(&s->stack_state) != 2 || s->depth == 0) {
+        print_frame("at", (void*)s->pc);
+        return;
+    }
+    for (int f = 0; f < s->depth; f++) {
+        print_frame(f == 0 ? "at" : "by", s->stack[f]);
+        Dl_info info;
+        if (dladdr((char*)s->stack[f] - 1, &info) && info.dli_sname && strcmp(info.dli_sname, "main") == 0) {
+            break;
+        }
+    }
+}
+
+// Where a site's blocks go at exit: the program's leaks, or memory the C
+// library and the runtime keep until the process dies (still reachable)
+enum { SITE_PROGRAM, SITE_STDIO, SITE_RUNTIME };
+
+// Function to classify a site by its caller: glibc's stdio buffers, or the
+// dynamic loader (thread DTVs from _dl_allocate_tls) and libgomp (thread
+// pool and team structures), which Valgrind also counts as reachable
+static int site_class(const Site *s) {
+    Dl_info info;
+    if (!dladdr((char*)s->pc - 1, &info)) return SITE_PROGRAM;
+    if (info.dli_sname && strncmp(info.dli_sname, "_IO_", 4) == 0) return SITE_STDIO;
+    if (info.dli_fname) {
+        const char *module = strrchr(info.dli_fname, '/');
+        module = module ? module + 1 : info.dli_fname;
+        if (strncmp(module, "ld-linux", 8) == 0 || strncmp(module, "ld.so", 5) == 0 ||
+            strncmp(module, "libgomp.so", 10) == 0) {
+            return SITE_RUNTIME;
+        }
+    }
+    return SITE_PROGRAM;
+}
+
+static long site_key(const Site *s, int by_live) {
+    return by_live ? site_live_bytes(s) : atomic_load(&s->bytes_total);
+}
+
+// Function to pick the n largest sites by live or total bytes (insertion
+// into a sorted array of n; n is small)
+static int top_sites(int *order, int n, int by_live) {
+    int count = 0;
+    for (int i = 1; i < MAX_SITES; i++) {
+        long key = site_key(&sites[i], by_live);
+        if (key <= 0 || (by_live && site_class(&sites[i]) != SITE_PROGRAM)) continue;
+        int pos;
+        if (count < n) {
+            pos = count++;
+        } else if (key > site_key(&sites[order[n - 1]], by_live)) {
+            pos = n - 1;
+        } else {
+            continue;
+        }
+        while (pos > 0 && site_key(&sites[order[pos - 1]], by_live) < key) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+    return count;
+}
+
+static void __attribute__((destructor)) memprof_report(void) {
+    in_profiler = 1;
+    char a[32], b[32], c[32];
+    long allocs = 0, frees = 0, total = 0;
+    long leak_bytes = 0, leak_blocks = 0, leak_sites = 0;
+    long stdio_bytes = 0, stdio_blocks = 0;
+    long runtime_bytes = 0, runtime_blocks = 0;
+    for (int i = 1; i < MAX_SITES; i++) {
+        const Site *s = &sites[i];
+        allocs += atomic_load(&s->allocs);
+        frees += atomic_load(&s->frees);
+        total += atomic_load(&s->bytes_total);
+        long blocks = site_live_blocks(s);
+        if (blocks <= 0) continue;
+        int kind = site_class(s);
+        if (kind == SITE_STDIO) {
+            stdio_bytes += site_live_bytes(s);
+            stdio_blocks += blocks;
+        } else if (kind == SITE_RUNTIME) {
+            runtime_bytes += site_live_bytes(s);
+            runtime_blocks += blocks;
+        } else {
+            leak_bytes += site_live_bytes(s);
+            leak_blocks += blocks;
+            leak_sites++;
+        }
+    }
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    fflush(NULL);    // the program's output first
+
+    out("memprof heap profiler");
+    out("HEAP SUMMARY:");
+    out("    in use at exit: %s bytes in %s blocks", commas(leak_bytes + stdio_bytes + runtime_bytes, a),
+        commas(leak_blocks + stdio_blocks + runtime_blocks, b));
+    out("  total heap usage: %s allocs, %s frees, %s bytes allocated", commas(allocs, a), commas(frees, b),
+        commas(total, c));
+    out("    peak live heap: %s bytes", commas(atomic_load(&peak_bytes), a));
+    out("          peak RSS: %s kB", commas(ru.ru_maxrss, a));
+    if (atomic_load(&sites_overflow)) {
+        out("warning: more than %d call sites, the rest are not attributed", MAX_SITES);
+    }
+
+    const char *env = getenv("MEMPROF_TOP");
+    int top = env ? atoi(env) : 5;
+    if (top > 0) {
+        int order[64];
+        if (top > 64) top = 64;
+        int n = top_sites(order, top, 0);
+        for (int k = 0; k < n; k++) {
+            const Site *s = &sites[order[k]];
+            blank();
+            out("%s bytes in %s allocs (%s still live) from site %d of %d:", commas(s->bytes_total, a),
+                commas(s->allocs, b), commas(site_live_bytes(s), c), k + 1, n);
+            print_site(s);
+        }
+    }
+
+    if (leak_blocks > 0) {
+        int order[REPORT_LEAK_SITES];
+        int n = top_sites(order, REPORT_LEAK_SITES, 1);
+        for (int k = 0; k < n; k++) {
+            const Site *s = &sites[order[k]];
+            blank();
+            out("%s bytes in %s blocks are not freed at exit (leak %d of %ld)", commas(site_live_bytes(s), a),
+                commas(site_live_blocks(s), b), k + 1, leak_sites);
+            print_site(s);
+        }
+    }
+
+    blank();
+    out("LEAK SUMMARY:");
+    out("   not freed at exit: %s bytes in %s blocks", commas(leak_bytes, a), commas(leak_blocks, b));
+    out("     still reachable: %s bytes in %s blocks (stdio buffers)", commas(stdio_bytes, a),
+        commas(stdio_blocks, b));
+    out("     still reachable: %s bytes in %s blocks (runtime)", commas(runtime_bytes, a),
+        commas(runtime_blocks, b));
+    if (leak_blocks == 0) {
+        out("All heap blocks were freed -- no leaks are possible");
+    }
+}
+
+// Function to load the unwinder before the first allocation needs it
+// (backtrace dlopens libgcc_s, which allocates)
+static void __attribute__((constructor)) memprof_init(void) {
+    void *frames[2];
+    in_profiler = 1;
+    backtrace(frames, 2);
+    in_profiler = 0;
+}
@@ -0,0 +1,340 @@
+#include <string.h>
+
+#include "mxm_kernels.h"
+#include "tune_profile.h"
+
+// Each kernel copies sizes and leading dimensions into locals and works on
+// restrict-qualified row pointers, so the compiler can keep them in registers
+// and vectorize the unit-stride inner loops.
+
+// Standard matrix multiplication (ijk order) - ORIGINAL
+void matrix_multiply_ijk(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+    const double *restrict A = a->data;
+    const double *restrict B = b->data;
+    double *restrict C = c->data;
+
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = C[(size_t)i * ldc + j];
+            for (int k = 0; k < p; k++) {
+                sum += A[(size_t)i * lda + k] * B[(size_t)k * ldb + j];
+            }
+            C[(size_t)i * ldc + j] = sum;
+        }
+    }
+}
+
+// Optimized matrix multiplication (ikj order) - CACHE OPTIMIZED
+void matrix_multiply_ikj(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+
+    for (int i = 0; i < m; i++) {
+        double *restrict ci = c->data + (size_t)i * ldc;
+        for (int k = 0; k < p; k++) {
+            const double r = a->data[(size_t)i * lda + k];
+            const double *restrict bk = b->data + (size_t)k * ldb;
+            for (int j = 0; j < n; j++) {
+                ci[j] += r * bk[j];
+            }
+        }
+    }
+}
+
+// Alternative: jik order
+void matrix_multiply_jik(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+    const double *restrict A = a->data;
+    const double *restrict B = b->data;
+    double *restrict C = c->data;
+
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+            double sum = C[(size_t)i * ldc + j];
+            for (int k = 0; k < p; k++) {
+                sum += A[(size_t)i * lda + k] * B[(size_t)k * ldb + j];
+            }
+            C[(size_t)i * ldc + j] = sum;
+        }
+    }
+}
+
+// Alternative: kij order
+void matrix_multiply_kij(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+
+    for (int k = 0; k < p; k++) {
+        const double *restrict bk = b->data + (size_t)k * ldb;
+        for (int i = 0; i < m; i++) {
+            const double r = a->data[(size_t)i * lda + k];
+            double *restrict ci = c->data + (size_t)i * ldc;
+            for (int j = 0; j < n; j++) {
+                ci[j] += r * bk[j];
+            }
+        }
+    }
+}
+
+// Alternative: jki order
+void matrix_multiply_jki(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+    const double *restrict A = a->data;
+    double *restrict C = c->data;
+
+    for (int j = 0; j < n; j++) {
+        for (int k = 0; k < p; k++) {
+            const double r = b->data[(size_t)k * ldb + j];
+            for (int i = 0; i < m; i++) {
+                C[(size_t)i * ldc + j] += A[(size_t)i * lda + k] * r;
+            }
+        }
+    }
+}
+
+// Alternative: kji order
+void matrix_multiply_kji(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+    const double *restrict A = a->data;
+    double *restrict C = c->data;
+
+    for (int k = 0; k < p; k++) {
+        for (int j = 0; j < n; j++) {
+            const double r = b->data[(size_t)k * ldb + j];
+            for (int i = 0; i < m; i++) {
+                C[(size_t)i * ldc + j] += A[(size_t)i * lda + k] * r;
+            }
+        }
+    }
+}
+
+// Standard matrix multiplication (for verification)
+void matrix_multiply_standard(const Matrix *A, const Matrix *B, Matrix *C) {
+    for (int i = 0; i < C->rows; i++) {
+        for (int j = 0; j < C->cols; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < A->cols; k++) {
+                sum += MAT(A, i, k) * MAT(B, k, j);
+            }
+            MAT(C, i, j) = sum;
+        }
+    }
+}
+
+// Block matrix multiplication
+void matrix_multiply_block(const Matrix *A, const Matrix *B, Matrix *C, int block_size) {
+    const int m = C->rows, n = C->cols, p = A->cols;
+
+    // Initialize result matrix to zero
+    zero_matrix(C);
+
+    // Iterate over blocks; each tile product is a view-based ijk nest
+    for (int i0 = 0; i0 < m; i0 += block_size) {
+        int ib = (i0 + block_size < m) ? block_size : m - i0;
+        for (int j0 = 0; j0 < n; j0 += block_size) {
+            int jb = (j0 + block_size < n) ? block_size : n - j0;
+            Matrix c_tile = matrix_view(C, i0, j0, ib, jb);
+            for (int k0 = 0; k0 < p; k0 += block_size) {
+                int kb = (k0 + block_size < p) ? block_size : p - k0;
+                Matrix a_tile = matrix_view(A, i0, k0, ib, kb);
+                Matrix b_tile = matrix_view(B, k0, j0, kb, jb);
+                matrix_multiply_ijk(&a_tile, &b_tile, &c_tile);
+            }
+        }
+    }
+}
+
+// Parallel ikj: each thread owns whole rows of C, handed out in small chunks
+void matrix_multiply_ikj_parallel(const Matrix *a, const Matrix *b, Matrix *c) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    const int lda = a->ld, ldb = b->ld, ldc = c->ld;
+
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (int i = 0; i < m; i++) {
+        double *restrict ci = c->data + (size_t)i * ldc;
+        for (int k = 0; k < p; k++) {
+            const double r = a->data[(size_t)i * lda + k];
+            const double *restrict bk = b->data + (size_t)k * ldb;
+            for (int j = 0; j < n; j++) {
+                ci[j] += r * bk[j];
+            }
+        }
+    }
+}
+
+// Parallel block multiplication: each (i0, j0) tile of C belongs to one thread,
+// which runs the whole k0 loop for it, so no two threads ever write the same tile
+void matrix_multiply_block_parallel(const Matrix *A, const Matrix *B, Matrix *C, int block_size) {
+    const int m = C->rows, n = C->cols, p = A->cols;
+    const int tiles_i = (m + block_size - 1) / block_size;
+    const int tiles_j = (n + block_size - 1) / block_size;
+
+    #pragma omp parallel for collapse(2) schedule(dynamic, 1)
+    for (int ti = 0; ti < tiles_i; ti++) {
+        for (int tj = 0; tj < tiles_j; tj++) {
+            int i0 = ti * block_size, j0 = tj * block_size;
+            int ib = (i0 + block_size < m) ? block_size : m - i0;
+            int jb = (j0 + block_size < n) ? block_size : n - j0;
+            Matrix c_tile = matrix_view(C, i0, j0, ib, jb);
+            zero_matrix(&c_tile);
+            for (int k0 = 0; k0 < p; k0 += block_size) {
+                int kb = (k0 + block_size < p) ? block_size : p - k0;
+                Matrix a_tile = matrix_view(A, i0, k0, ib, kb);
+                Matrix b_tile = matrix_view(B, k0, j0, kb, jb);
+                matrix_multiply_ijk(&a_tile, &b_tile, &c_tile);
+            }
+        }
+    }
+}
+
+// ===== Loop-order table =====
+
+static const char *order_names[NUM_LOOP_ORDERS] = {"ijk", "ikj", "jik", "jki", "kij", "kji"};
+static const multiply_func order_funcs[NUM_LOOP_ORDERS] = {
+    matrix_multiply_ijk, matrix_multiply_ikj, matrix_multiply_jik,
+    matrix_multiply_jki, matrix_multiply_kij, matrix_multiply_kji
+};
+
+// Function to return the name of a loop order
+const char* loop_order_name(int order) {
+    return (order >= 0 && order < NUM_LOOP_ORDERS) ? order_names[order] : "?";
+}
+
+// Function to look a loop order up by name
+int loop_order_index(const char *name) {
+    for (int i = 0; i < NUM_LOOP_ORDERS; i++) {
+        if (strcmp(name, order_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Function to return the kernel of a loop order
+multiply_func loop_order_func(int order) {
+    return order_funcs[order];
+}
+
+// ===== Tiled kernel =====
+
+// Function to fill the untuned tile configuration
+void tile_default_config(TileConfig *t) {
+    t->mc = 64;
+    t->kc = 64;
+    t->nc = 256;
+    t->order = 1; // ikj
+    t->unroll = 1;
+}
+
+// Function to load the tuned tile configuration for size n
+int tile_tuned_config(int n, TileConfig *t) {
+    tile_default_config(t);
+
+    const TuneProfile *prof = tune_profile_active();
+    const TuneEntry *e = prof ? tune_profile_lookup(prof, n) : NULL;
+    if (!e || e->tile_m <= 0 || e->tile_k <= 0 || e->tile_n <= 0) return 0;
+
+    int order = loop_order_index(e->order);
+    t->mc = e->tile_m;
+    t->kc = e->tile_k;
+    t->nc = e->tile_n;
+    t->order = order >= 0 ? order : t->order;
+    t->unroll = e->unroll > 0 ? e->unroll : 1;
+    return 1;
+}
+
+// Width of the next unrolled-and-jammed k step: the largest of 8 / 4 / 2 allowed
+// by u that still fits in [k, p), else 1
+static inline int jam_width(int k, int p, int u) {
+    for (int s = 8; s > 1; s /= 2) {
+        if (u >= s && k + s <= p) return s;
+    }
+    return 1;
+}
+
+// Function to add s rows of B (starting at bk), weighted by ak[0..s), to the C row ci
+static inline void jam_row(double *restrict ci, const double *ak, const double *restrict bk,
+                           int ldb, int n, int s) {
+    if (s == 8) {
+        const double r0 = ak[0], r1 = ak[1], r2 = ak[2], r3 = ak[3];
+        const double r4 = ak[4], r5 = ak[5], r6 = ak[6], r7 = ak[7];
+        for (int j = 0; j < n; j++) {
+            ci[j] += r0 * bk[j] + r1 * bk[ldb + j]
+                   + r2 * bk[2 * ldb + j] + r3 * bk[3 * ldb + j]
+                   + r4 * bk[4 * ldb + j] + r5 * bk[5 * ldb + j]
+                   + r6 * bk[6 * ldb + j] + r7 * bk[7 * ldb + j];
+        }
+    } else if (s == 4) {
+        const double r0 = ak[0], r1 = ak[1], r2 = ak[2], r3 = ak[3];
+        for (int j = 0; j < n; j++) {
+            ci[j] += r0 * bk[j] + r1 * bk[ldb + j]
+                   + r2 * bk[2 * ldb + j] + r3 * bk[3 * ldb + j];
+        }
+    } else if (s == 2) {
+        const double r0 = ak[0], r1 = ak[1];
+        for (int j = 0; j < n; j++) {
+            ci[j] += r0 * bk[j] + r1 * bk[ldb + j];
+        }
+    } else {
+        const double r = ak[0];
+        for (int j = 0; j < n; j++) {
+            ci[j] += r * bk[j];
+        }
+    }
+}
+
+// ikj tile with the k loop unrolled-and-jammed: u rows of B per pass over a C row
+static void tile_ikj_unrolled(const Matrix *a, const Matrix *b, Matrix *c, int u) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    for (int i = 0; i < m; i++) {
+        double *ci = c->data + (size_t)i * c->ld;
+        const double *ai = a->data + (size_t)i * a->ld;
+        for (int k = 0, s; k < p; k += s) {
+            s = jam_width(k, p, u);
+            jam_row(ci, ai + k, b->data + (size_t)k * b->ld, b->ld, n, s);
+        }
+    }
+}
+
+// kij tile with the k loop unrolled-and-jammed: the same u rows of B are
+// applied to every row of C before moving to the next k step
+static void tile_kij_unrolled(const Matrix *a, const Matrix *b, Matrix *c, int u) {
+    const int m = c->rows, n = c->cols, p = a->cols;
+    for (int k = 0, s; k < p; k += s) {
+        s = jam_width(k, p, u);
+        const double *bk = b->data + (size_t)k * b->ld;
+        for (int i = 0; i < m; i++) {
+            jam_row(c->data + (size_t)i * c->ld, a->data + (size_t)i * a->ld + k, bk, b->ld, n, s);
+        }
+    }
+}
+
+// Tiled multiplication with a configurable tile shape, loop order and unroll
+void matrix_multiply_tiled(const Matrix *A, const Matrix *B, Matrix *C, const TileConfig *t) {
+    const int m = C->rows, n = C->cols, p = A->cols;
+    const int jammed = t->unroll > 1 && (t->order == 1 || t->order == 4); // ikj, kij
+    const multiply_func func = loop_order_func(t->order);
+
+    for (int jc = 0; jc < n; jc += t->nc) {
+        int nb = (jc + t->nc < n) ? t->nc : n - jc;
+        for (int pc = 0; pc < p; pc += t->kc) {
+            int kb = (pc + t->kc < p) ? t->kc : p - pc;
+            Matrix b_tile = matrix_view(B, pc, jc, kb, nb);
+            for (int ic = 0; ic < m; ic += t->mc) {
+                int mb = (ic + t->mc < m) ? t->mc : m - ic;
+                Matrix a_tile = matrix_view(A, ic, pc, mb, kb);
+                Matrix c_tile = matrix_view(C, ic, jc, mb, nb);
+                if (jammed && t->order == 4) {
+                    tile_kij_unrolled(&a_tile, &b_tile, &c_tile, t->unroll);
+                } else if (jammed) {
+                    tile_ikj_unrolled(&a_tile, &b_tile, &c_tile, t->unroll);
+                } else {
+                    func(&a_tile, &b_tile, &c_tile);
+                }
+            }
+        }
+    }
+}
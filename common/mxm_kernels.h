@@ -0,0 +1,60 @@
+#ifndef MXM_KERNELS_H
+#define MXM_KERNELS_H
+
+#include "matrix.h"
+
+// All kernels compute C += A * B for an (m x k) A, (k x n) B and (m x n) C,
+// except matrix_multiply_standard and matrix_multiply_block which overwrite C.
+
+// Six loop orders from Lab1/Exercice 2
+void matrix_multiply_ijk(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_ikj(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_jik(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_jki(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_kij(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_kji(const Matrix *a, const Matrix *b, Matrix *c);
+
+// Reference multiplication used for verification (C = A * B)
+void matrix_multiply_standard(const Matrix *A, const Matrix *B, Matrix *C);
+
+// Square-tile block multiplication from Lab1/Exercice 3 (C = A * B)
+void matrix_multiply_block(const Matrix *A, const Matrix *B, Matrix *C, int block_size);
+
+// Multithreaded versions (OpenMP; serial when built without -fopenmp).
+// Rows / C tiles are handed out dynamically so that slow E-cores on hybrid
+// CPUs take fewer of them.
+void matrix_multiply_ikj_parallel(const Matrix *a, const Matrix *b, Matrix *c);
+void matrix_multiply_block_parallel(const Matrix *A, const Matrix *B, Matrix *C, int block_size);
+
+// Common signature of the loop-order kernels
+typedef void (*multiply_func)(const Matrix*, const Matrix*, Matrix*);
+
+// Loop-order table: index <-> name ("ijk", "ikj", ...) <-> kernel
+#define NUM_LOOP_ORDERS 6
+const char* loop_order_name(int order);
+int loop_order_index(const char *name);   // -1 if unknown
+multiply_func loop_order_func(int order);
+
+// Non-square tiling for the tiled kernel: tiles of C are mc x nc and the
+// shared dimension is cut in kc slices. Inside a tile the chosen loop order
+// runs; for ikj/kij the k loop is also unrolled-and-jammed by 'unroll'
+// (1, 2, 4 or 8), which cuts loads/stores of C by that factor.
+typedef struct {
+    int mc;
+    int kc;
+    int nc;
+    int order;
+    int unroll;
+} TileConfig;
+
+// Untuned starting point: 64 x 64 x 256 tiles, ikj, no unrolling
+void tile_default_config(TileConfig *t);
+
+// Tile config from the saved autotuning profile for size n (defaults if none).
+// Returns 1 if it came from the profile.
+int tile_tuned_config(int n, TileConfig *t);
+
+// Tiled multiplication: C += A * B
+void matrix_multiply_tiled(const Matrix *A, const Matrix *B, Matrix *C, const TileConfig *t);
+
+#endif
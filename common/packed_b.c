@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "packed_b.h"
+#include "matrix.h"
+
+static int use_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+const char* packed_b_kernel_name(void) {
+    return use_avx2() ? "avx2" : "scalar";
+}
+
+// ===== Packing =====
+
+void packed_b_init(PackedB *pb, const double *B, int k, int n, int ldb) {
+    pb->k = k;
+    pb->n = n;
+    pb->panels = (n + PACKED_B_NR - 1) / PACKED_B_NR;
+
+    void *p = NULL;
+    size_t count = (size_t)pb->panels * k * PACKED_B_NR;
+    if (posix_memalign(&p, MATRIX_ALIGNMENT, (count > 0 ? count : 1) * sizeof(double)) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    pb->data = p;
+    packed_b_update(pb, B, ldb);
+}
+
+void packed_b_update(PackedB *pb, const double *B, int ldb) {
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < pb->panels; p++) {
+        const int j0 = p * PACKED_B_NR;
+        const int cols = (pb->n - j0 < PACKED_B_NR) ? pb->n - j0 : PACKED_B_NR;
+        double *dst = pb->data + (size_t)p * pb->k * PACKED_B_NR;
+        for (int kk = 0; kk < pb->k; kk++) {
+            const double *src = B + (size_t)kk * ldb + j0;
+            int c = 0;
+            for (; c < cols; c++) dst[c] = src[c];
+            for (; c < PACKED_B_NR; c++) dst[c] = 0.0;
+            dst += PACKED_B_NR;
+        }
+    }
+}
+
+void packed_b_free(PackedB *pb) {
+    free(pb->data);
+    pb->data = NULL;
+    pb->panels = 0;
+}
+
+// ===== Kernels: mr rows of C x one panel =====
+// Each of the mr x PACKED_B_NR elements is one dependency chain
+// bias, + a*b (k = 0), + a*b (k = 1), ... exactly as in the naive loop.
+// Results go to a PACKED_B_NR-wide tile and are copied out, so a partial
+// last panel never writes past column n.
+
+static inline __attribute__((always_inline))
+void kernel_scalar(const int mr, int k, const double *A, int lda, const double *panel,
+                   const double *bias, double tile[PACKED_B_MR][PACKED_B_NR]) {
+    double acc[PACKED_B_MR][PACKED_B_NR];
+    for (int r = 0; r < mr; r++) {
+        for (int c = 0; c < PACKED_B_NR; c++) acc[r][c] = bias[r];
+    }
+    for (int kk = 0; kk < k; kk++) {
+        const double *b = panel + (size_t)kk * PACKED_B_NR;
+        #pragma GCC unroll 4
+        for (int r = 0; r < mr; r++) {
+            const double a = A[(size_t)r * lda + kk];
+            for (int c = 0; c < PACKED_B_NR; c++) acc[r][c] += a * b[c];
+        }
+    }
+    for (int r = 0; r < mr; r++) {
+        for (int c = 0; c < PACKED_B_NR; c++) tile[r][c] = acc[r][c];
+    }
+}
+
+// Multiply and add stay separate instructions (no "fma" target), which is what
+// keeps the bits of the naive loop
+__attribute__((target("avx2")))
+static inline __attribute__((always_inline))
+void kernel_avx2(const int mr, int k, const double *A, int lda, const double *panel,
+                 const double *bias, double tile[PACKED_B_MR][PACKED_B_NR]) {
+    __m256d acc0[PACKED_B_MR], acc1[PACKED_B_MR];
+    for (int r = 0; r < mr; r++) {
+        acc0[r] = acc1[r] = _mm256_set1_pd(bias[r]);
+    }
+    for (int kk = 0; kk < k; kk++) {
+        const __m256d b0 = _mm256_load_pd(panel + (size_t)kk * PACKED_B_NR);
+        const __m256d b1 = _mm256_load_pd(panel + (size_t)kk * PACKED_B_NR + 4);
+        #pragma GCC unroll 4
+        for (int r = 0; r < mr; r++) {
+            const __m256d a = _mm256_broadcast_sd(A + (size_t)r * lda + kk);
+            acc0[r] = _mm256_add_pd(acc0[r], _mm256_mul_pd(a, b0));
+            acc1[r] = _mm256_add_pd(acc1[r], _mm256_mul_pd(a, b1));
+        }
+    }
+    for (int r = 0; r < mr; r++) {
+        _mm256_storeu_pd(tile[r], acc0[r]);
+        _mm256_storeu_pd(tile[r] + 4, acc1[r]);
+    }
+}
+
+#define KERNEL_CASES(F)                                                  \
+    case 1: F(1, k, A, lda, panel, bias, tile); break;                   \
+    case 2: F(2, k, A, lda, panel, bias, tile); break;                   \
+    case 3: F(3, k, A, lda, panel, bias, tile); break;                   \
+    default: F(PACKED_B_MR, k, A, lda, panel, bias, tile); break;
+
+static void block_scalar(int mr, int k, const double *A, int lda, const double *panel,
+                         const double *bias, double tile[PACKED_B_MR][PACKED_B_NR]) {
+    switch (mr) {
+    KERNEL_CASES(kernel_scalar)
+    }
+}
+
+__attribute__((target("avx2")))
+static void block_avx2(int mr, int k, const double *A, int lda, const double *panel,
+                       const double *bias, double tile[PACKED_B_MR][PACKED_B_NR]) {
+    switch (mr) {
+    KERNEL_CASES(kernel_avx2)
+    }
+}
+
+// ===== Product =====
+
+void packed_b_multiply(const double *A, int m, int lda, const PackedB *pb,
+                       const double *bias, double *C, int ldc) {
+    const int k = pb->k, n = pb->n;
+    const int avx2 = use_avx2();
+    double zeros[PACKED_B_MR] = {0.0};
+
+    // Panel outer, rows inner: the panel (k x 8 doubles) stays in L1/L2 while
+    // the rows of A stream past it
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < pb->panels; p++) {
+        const double *panel = pb->data + (size_t)p * k * PACKED_B_NR;
+        const int j0 = p * PACKED_B_NR;
+        const int cols = (n - j0 < PACKED_B_NR) ? n - j0 : PACKED_B_NR;
+        double tile[PACKED_B_MR][PACKED_B_NR];
+
+        for (int i0 = 0; i0 < m; i0 += PACKED_B_MR) {
+            const int mr = (m - i0 < PACKED_B_MR) ? m - i0 : PACKED_B_MR;
+            const double *rows = A + (size_t)i0 * lda;
+            const double *b = bias ? bias + i0 : zeros;
+            if (avx2) {
+                block_avx2(mr, k, rows, lda, panel, b, tile);
+            } else {
+                block_scalar(mr, k, rows, lda, panel, b, tile);
+            }
+            for (int r = 0; r < mr; r++) {
+                memcpy(C + (size_t)(i0 + r) * ldc + j0, tile[r], cols * sizeof(double));
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef PACKED_B_H
+#define PACKED_B_H
+
+// Row-biased product C[i][j] = bias[i] + sum_k A[i][k] * B[k][j] with B
+// packed once. The naive loop (Lab2/Exercice4 matmul) reads B[k][j] with a
+// stride of n doubles in its inner loop; here B is copied into column panels
+// of PACKED_B_NR columns stored k after k, so the kernel reads it with unit
+// stride. Packing costs one pass over B and is paid once for every product
+// that reuses the same B.
+
+// Columns per panel (two AVX2 vectors) and rows of A per kernel call
+// (2 x 4 = 8 independent accumulators)
+#define PACKED_B_NR 8
+#define PACKED_B_MR 4
+
+typedef struct {
+    int k, n;          // B is k x n
+    int panels;        // ceil(n / PACKED_B_NR); the last one is zero-padded
+    double *data;      // panel p, row kk at data[(p * k + kk) * PACKED_B_NR], 64-byte aligned
+} PackedB;
+
+// Pack a k x n row-major B with leading dimension ldb (exits on allocation failure)
+void packed_b_init(PackedB *pb, const double *B, int k, int n, int ldb);
+
+// Repack new values of a B with the same shape (no allocation)
+void packed_b_update(PackedB *pb, const double *B, int ldb);
+
+void packed_b_free(PackedB *pb);
+
+// C = bias + A * packed B for the m rows of A (lda, ldc: leading dimensions;
+// bias NULL: 0). Every element starts from bias[i] and adds the products in
+// k order with a separate multiply and add, like the naive loop compiled
+// without FMA contraction, so both give the same bits. Built with -fopenmp,
+// the panels are shared among omp_get_max_threads() threads.
+void packed_b_multiply(const double *A, int m, int lda, const PackedB *pb,
+                       const double *bias, double *C, int ldc);
+
+// Name of the kernel picked at runtime ("avx2" or "scalar")
+const char* packed_b_kernel_name(void);
+
+#endif
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "perf_counters.h"
+
+#define CACHE_LINE_BYTES 64
+
+// Intel FP_ARITH_INST_RETIRED (event 0xC7); umasks for double precision
+#define INTEL_FP_ARITH_EVENT 0xC7
+#define INTEL_FP_SCALAR_DOUBLE 0x01
+#define INTEL_FP_128_DOUBLE 0x04
+#define INTEL_FP_256_DOUBLE 0x10
+
+static const char *event_names[PERF_NUM_EVENTS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses",
+    "fp_scalar", "fp_128", "fp_256"
+};
+
+// Function to encode a generic hardware cache event
+static uint64_t cache_event(int cache, int op, int result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+// Function to tell whether raw Intel events make sense on this CPU
+static int is_intel(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_is("intel");
+#else
+    return 0;
+#endif
+}
+
+// Function to fill the attributes of one event; returns 0 if not supported here
+static int event_attr(PerfEvent e, struct perf_event_attr *attr) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->disabled = 1;
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->inherit = 1;
+    attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (e) {
+    case PERF_CYCLES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        return 1;
+    case PERF_INSTRUCTIONS:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        return 1;
+    case PERF_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                   PERF_COUNT_HW_CACHE_RESULT_MISS);
+        return 1;
+    case PERF_LLC_MISSES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CACHE_MISSES;
+        return 1;
+    case PERF_DTLB_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                   PERF_COUNT_HW_CACHE_RESULT_MISS);
+        return 1;
+    case PERF_FP_SCALAR:
+    case PERF_FP_128:
+    case PERF_FP_256:
+        if (!is_intel()) return 0;
+        attr->type = PERF_TYPE_RAW;
+        attr->config = INTEL_FP_ARITH_EVENT |
+            ((e == PERF_FP_SCALAR ? INTEL_FP_SCALAR_DOUBLE :
+              e == PERF_FP_128 ? INTEL_FP_128_DOUBLE : INTEL_FP_256_DOUBLE) << 8);
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// Function to open all available counters for the calling process
+int perf_counters_open(PerfCounters *pc) {
+    int first_errno = 0;
+
+    pc->num_open = 0;
+    pc->reason[0] = '\0';
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        struct perf_event_attr attr;
+        pc->fd[e] = -1;
+        if (!event_attr(e, &attr)) continue;
+        int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            if (!first_errno) first_errno = errno;
+            continue;
+        }
+        pc->fd[e] = fd;
+        pc->num_open++;
+    }
+
+    if (pc->num_open == 0) {
+        const char *why;
+        switch (first_errno) {
+        case ENOENT:
+        case ENODEV:
+        case EOPNOTSUPP:
+            why = "no hardware PMU exposed (VM or container)";
+            break;
+        case EACCES:
+        case EPERM:
+            why = "not permitted (check /proc/sys/kernel/perf_event_paranoid)";
+            break;
+        case ENOSYS:
+            why = "perf_event_open not supported by this kernel";
+            break;
+        default:
+            why = "perf_event_open failed";
+            break;
+        }
+        snprintf(pc->reason, sizeof(pc->reason), "%s: %s", why, strerror(first_errno));
+    }
+    return pc->num_open;
+}
+
+// Function to close the counters
+void perf_counters_close(PerfCounters *pc) {
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) close(pc->fd[e]);
+        pc->fd[e] = -1;
+    }
+    pc->num_open = 0;
+}
+
+// Function to apply one ioctl to every open counter
+static void ioctl_all(PerfCounters *pc, unsigned long request) {
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) ioctl(pc->fd[e], request, 0);
+    }
+}
+
+void perf_counters_reset(PerfCounters *pc) {
+    ioctl_all(pc, PERF_EVENT_IOC_RESET);
+}
+
+void perf_counters_enable(PerfCounters *pc) {
+    ioctl_all(pc, PERF_EVENT_IOC_ENABLE);
+}
+
+void perf_counters_disable(PerfCounters *pc) {
+    ioctl_all(pc, PERF_EVENT_IOC_DISABLE);
+}
+
+// Function to read the totals, scaling events that were multiplexed
+void perf_counters_read(PerfCounters *pc, PerfSample *s) {
+    memset(s, 0, sizeof(*s));
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        uint64_t buf[3];   // value, time_enabled, time_running
+        if (pc->fd[e] < 0) continue;
+        if (read(pc->fd[e], buf, sizeof(buf)) != sizeof(buf)) continue;
+        if (buf[2] == 0) continue;   // never scheduled on the PMU
+        double scale = buf[2] < buf[1] ? (double)buf[1] / buf[2] : 1.0;
+        s->value[e] = (uint64_t)(buf[0] * scale);
+        s->valid |= 1u << e;
+    }
+}
+
+const char* perf_event_name(PerfEvent e) {
+    return (e >= 0 && e < PERF_NUM_EVENTS) ? event_names[e] : "?";
+}
+
+int perf_sample_has(const PerfSample *s, PerfEvent e) {
+    return (s->valid >> e) & 1u;
+}
+
+// Function to compute instructions per cycle
+double perf_ipc(const PerfSample *s) {
+    if (!perf_sample_has(s, PERF_CYCLES) || !perf_sample_has(s, PERF_INSTRUCTIONS) ||
+        s->value[PERF_CYCLES] == 0) {
+        return -1.0;
+    }
+    return (double)s->value[PERF_INSTRUCTIONS] / s->value[PERF_CYCLES];
+}
+
+// Function to normalize an event count per thousand floating-point operations
+double perf_per_kflop(const PerfSample *s, PerfEvent e, double flops) {
+    if (!perf_sample_has(s, e) || flops <= 0) return -1.0;
+    return s->value[e] / (flops / 1000.0);
+}
+
+// Function to estimate memory bandwidth from LLC misses
+double perf_llc_bandwidth(const PerfSample *s, double seconds) {
+    if (!perf_sample_has(s, PERF_LLC_MISSES) || seconds <= 0) return -1.0;
+    return s->value[PERF_LLC_MISSES] * (double)CACHE_LINE_BYTES / seconds / 1e9;
+}
+
+// Function to count double-precision FLOPs from the FP_ARITH events
+double perf_fp_ops(const PerfSample *s) {
+    if (!perf_sample_has(s, PERF_FP_SCALAR) || !perf_sample_has(s, PERF_FP_128) ||
+        !perf_sample_has(s, PERF_FP_256)) {
+        return -1.0;
+    }
+    return s->value[PERF_FP_SCALAR] + 2.0 * s->value[PERF_FP_128] + 4.0 * s->value[PERF_FP_256];
+}
@@ -0,0 +1,53 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+// Hardware events counted around benchmarked regions (user space only)
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,         // L1D read misses
+    PERF_LLC_MISSES,         // last-level cache misses
+    PERF_DTLB_MISSES,        // dTLB read misses
+    PERF_FP_SCALAR,          // scalar double FP ops (Intel FP_ARITH, FMA counts 2)
+    PERF_FP_128,             // 128-bit packed double instructions
+    PERF_FP_256,             // 256-bit packed double instructions
+    PERF_NUM_EVENTS
+} PerfEvent;
+
+typedef struct {
+    int fd[PERF_NUM_EVENTS];             // -1 if the event could not be opened
+    int num_open;
+    char reason[128];                    // why counters are missing, if they are
+} PerfCounters;
+
+typedef struct {
+    uint64_t value[PERF_NUM_EVENTS];     // scaled for multiplexing
+    unsigned valid;                      // bit e set if value[e] was measured
+} PerfSample;
+
+// Open every event this CPU/kernel allows. Returns the number opened; 0 in
+// containers or VMs without a PMU (reason says why), which callers treat as
+// "no counters" rather than an error. Threads created after this call are
+// counted too (inherit), so open before the first OpenMP region.
+int perf_counters_open(PerfCounters *pc);
+void perf_counters_close(PerfCounters *pc);
+
+// Zero the counts; enable/disable bracket the measured region and may be
+// repeated to accumulate several runs; read collects the totals.
+void perf_counters_reset(PerfCounters *pc);
+void perf_counters_enable(PerfCounters *pc);
+void perf_counters_disable(PerfCounters *pc);
+void perf_counters_read(PerfCounters *pc, PerfSample *s);
+
+const char* perf_event_name(PerfEvent e);
+int perf_sample_has(const PerfSample *s, PerfEvent e);
+
+// Derived metrics; return -1 when an input event is missing
+double perf_ipc(const PerfSample *s);
+double perf_per_kflop(const PerfSample *s, PerfEvent e, double flops);
+double perf_llc_bandwidth(const PerfSample *s, double seconds);   // GB/s, 64 B per miss
+double perf_fp_ops(const PerfSample *s);                          // measured double FLOPs
+
+#endif
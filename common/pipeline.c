@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+#include "cache_info.h"
+
+// Function to size a chunk: num_buffers chunks in half of L2, leaving the
+// other half to the code, the stack and whatever the stages read besides
+long pipeline_chunk_for_cache(int num_buffers) {
+    CacheInfo c;
+    cache_info_detect(&c);
+    long chunk = (long)(c.l2 / 2 / ((size_t)(num_buffers > 0 ? num_buffers : 1) * sizeof(double)));
+    chunk -= chunk % 8;
+    return chunk < 1024 ? 1024 : chunk;
+}
+
+void pipeline_init(Pipeline *p, long n, int num_buffers, long chunk) {
+    memset(p, 0, sizeof(*p));
+    if (num_buffers > PIPELINE_MAX_BUFFERS) num_buffers = PIPELINE_MAX_BUFFERS;
+    p->n = n;
+    p->num_buffers = num_buffers;
+    p->chunk = chunk > 0 ? chunk : pipeline_chunk_for_cache(num_buffers);
+    if (p->chunk > n && n > 0) p->chunk = n;
+
+    for (int i = 0; i < num_buffers; i++) {
+        if (posix_memalign((void**)&p->buf[i], 64, p->chunk * sizeof(double)) != 0) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void pipeline_add_stage(Pipeline *p, const char *name, pipeline_stage_func run, void *state) {
+    if (p->num_stages >= PIPELINE_MAX_STAGES) {
+        fprintf(stderr, "Too many pipeline stages (max %d)\n", PIPELINE_MAX_STAGES);
+        exit(EXIT_FAILURE);
+    }
+    PipelineStage *s = &p->stages[p->num_stages++];
+    s->name = name;
+    s->run = run;
+    s->state = state;
+}
+
+// Function to run all stages on one chunk before moving to the next
+void pipeline_run(Pipeline *p) {
+    for (long begin = 0; begin < p->n; begin += p->chunk) {
+        long len = (p->n - begin < p->chunk) ? p->n - begin : p->chunk;
+        for (int s = 0; s < p->num_stages; s++) {
+            p->stages[s].run(p->buf, begin, len, p->stages[s].state);
+        }
+    }
+}
+
+size_t pipeline_footprint(const Pipeline *p) {
+    return (size_t)p->num_buffers * p->chunk * sizeof(double);
+}
+
+void pipeline_free(Pipeline *p) {
+    for (int i = 0; i < p->num_buffers; i++) {
+        free(p->buf[i]);
+        p->buf[i] = NULL;
+    }
+}
+
+// ===== Stages =====
+
+// The recurrence carries across chunks, so the values are the same products
+// in the same order as the serial add_noise
+void pipeline_stage_noise(double **buf, long begin, long len, void *state) {
+    NoiseStage *s = state;
+    double *a = buf[s->out];
+    a[0] = (begin == 0) ? s->first : s->carry * s->factor;
+    for (long i = 1; i < len; i++) {
+        a[i] = a[i - 1] * s->factor;
+    }
+    s->carry = a[len - 1];
+}
+
+void pipeline_stage_ramp(double **buf, long begin, long len, void *state) {
+    RampStage *s = state;
+    double *b = buf[s->out];
+    for (long i = 0; i < len; i++) {
+        b[i] = (begin + i) * s->scale;
+    }
+}
+
+void pipeline_stage_add(double **buf, long begin, long len, void *state) {
+    AddStage *s = state;
+    const double *x = buf[s->x], *y = buf[s->y];
+    double *out = buf[s->out];
+    (void)begin;
+    for (long i = 0; i < len; i++) {
+        out[i] = x[i] + y[i];
+    }
+}
+
+void pipeline_stage_sum(double **buf, long begin, long len, void *state) {
+    SumStage *s = state;
+    const double *x = buf[s->in];
+    double sum = (begin == 0) ? 0.0 : s->sum;
+    for (long i = 0; i < len; i++) {
+        sum += x[i];
+    }
+    s->sum = sum;
+}
+
+void pipeline_stage_store(double **buf, long begin, long len, void *state) {
+    StoreStage *s = state;
+    memcpy(s->dst + begin, buf[s->in], len * sizeof(double));
+}
@@ -0,0 +1,89 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+
+// Fused streaming pipeline: instead of running every stage over the whole
+// stream (one full DRAM pass per stage), the stream is cut into chunks small
+// enough to stay in L2 and all stages run on a chunk before the next one.
+// Intermediate arrays only exist as chunk-sized buffers.
+
+#define PIPELINE_MAX_STAGES  8
+#define PIPELINE_MAX_BUFFERS 4
+
+// Stage callback: process elements [begin, begin + len) of the stream, held
+// in buf[0..num_buffers) (chunk doubles each, reused for every chunk).
+// begin == 0 marks the start of a run, where stages reset their state.
+typedef void (*pipeline_stage_func)(double **buf, long begin, long len, void *state);
+
+typedef struct {
+    const char *name;
+    pipeline_stage_func run;
+    void *state;
+} PipelineStage;
+
+typedef struct {
+    long n;                      // stream length
+    long chunk;                  // elements per chunk
+    int num_buffers;
+    int num_stages;
+    PipelineStage stages[PIPELINE_MAX_STAGES];
+    double *buf[PIPELINE_MAX_BUFFERS];
+} Pipeline;
+
+// Chunk length so that num_buffers chunks fill half of L2 (multiple of 8)
+long pipeline_chunk_for_cache(int num_buffers);
+
+// Allocate the chunk buffers (chunk <= 0: pipeline_chunk_for_cache); exits on failure
+void pipeline_init(Pipeline *p, long n, int num_buffers, long chunk);
+
+// Append a stage; stages run in the order they were added
+void pipeline_add_stage(Pipeline *p, const char *name, pipeline_stage_func run, void *state);
+
+// Run every stage over every chunk
+void pipeline_run(Pipeline *p);
+
+// Bytes of buffers the pipeline holds
+size_t pipeline_footprint(const Pipeline *p);
+
+void pipeline_free(Pipeline *p);
+
+// ===== Stages of the Lab2/Exercice3 workload =====
+
+// buf[out][i] = a[i] with a[0] = first, a[i] = a[i-1] * factor (add_noise)
+typedef struct {
+    int out;
+    double first, factor;
+    double carry;                // last element of the previous chunk
+} NoiseStage;
+
+// buf[out][i] = (begin + i) * scale (init_b)
+typedef struct {
+    int out;
+    double scale;
+} RampStage;
+
+// buf[out][i] = buf[x][i] + buf[y][i] (compute_addition)
+typedef struct {
+    int x, y, out;
+} AddStage;
+
+// sum += buf[in][i] in stream order, so it matches the unfused reduction bit for bit
+typedef struct {
+    int in;
+    double sum;
+} SumStage;
+
+// dst[begin + i] = buf[in][i], for when a full-length result is consumed
+typedef struct {
+    int in;
+    double *dst;
+} StoreStage;
+
+void pipeline_stage_noise(double **buf, long begin, long len, void *state);
+void pipeline_stage_ramp(double **buf, long begin, long len, void *state);
+void pipeline_stage_add(double **buf, long begin, long len, void *state);
+void pipeline_stage_sum(double **buf, long begin, long len, void *state);
+void pipeline_stage_store(double **buf, long begin, long len, void *state);
+
+#endif
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "reduce.h"
+#include "tune_profile.h"
+
+// Largest thread count of the fast mode
+#define REDUCE_MAX_THREADS 256
+
+static const char *mode_names[REDUCE_NUM_MODES] = {"fast", "reproducible", "compensated"};
+
+const char* reduce_mode_name(ReduceMode mode) {
+    return (mode >= 0 && mode < REDUCE_NUM_MODES) ? mode_names[mode] : "?";
+}
+
+static int use_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+const char* reduce_kernel_name(void) {
+    return use_avx2() ? "avx2" : "scalar";
+}
+
+// ===== Single-thread kernels =====
+// Accumulator j takes elements i + j (vector j / 4, lane j % 4). The lanes
+// are combined as ((j, j+4) + (j+8, j+12)) per lane, then (0+1) + (2+3), and
+// the tail is added last; the scalar versions follow the same order.
+
+static double lanes_combine(const double *acc) {
+    double s[4];
+    for (int l = 0; l < 4; l++) {
+        s[l] = (acc[l] + acc[4 + l]) + (acc[8 + l] + acc[12 + l]);
+    }
+    return (s[0] + s[1]) + (s[2] + s[3]);
+}
+
+static double block_sum_scalar(const double *a, long n) {
+    double acc[REDUCE_ACCUMULATORS] = {0.0};
+    long i = 0;
+    for (; i + REDUCE_ACCUMULATORS <= n; i += REDUCE_ACCUMULATORS) {
+        for (int j = 0; j < REDUCE_ACCUMULATORS; j++) {
+            acc[j] += a[i + j];
+        }
+    }
+    double sum = lanes_combine(acc);
+    for (; i < n; i++) sum += a[i];
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static double block_sum_avx2(const double *a, long n) {
+    __m256d v0 = _mm256_setzero_pd(), v1 = _mm256_setzero_pd();
+    __m256d v2 = _mm256_setzero_pd(), v3 = _mm256_setzero_pd();
+    long i = 0;
+    for (; i + REDUCE_ACCUMULATORS <= n; i += REDUCE_ACCUMULATORS) {
+        v0 = _mm256_add_pd(v0, _mm256_loadu_pd(a + i));
+        v1 = _mm256_add_pd(v1, _mm256_loadu_pd(a + i + 4));
+        v2 = _mm256_add_pd(v2, _mm256_loadu_pd(a + i + 8));
+        v3 = _mm256_add_pd(v3, _mm256_loadu_pd(a + i + 12));
+    }
+    double acc[REDUCE_ACCUMULATORS];
+    _mm256_storeu_pd(acc, v0);
+    _mm256_storeu_pd(acc + 4, v1);
+    _mm256_storeu_pd(acc + 8, v2);
+    _mm256_storeu_pd(acc + 12, v3);
+    double sum = lanes_combine(acc);
+    for (; i < n; i++) sum += a[i];
+    return sum;
+}
+
+// Kahan: c carries the low-order bits lost by the previous addition
+static double lanes_combine_compensated(const double *s, const double *c, const double *tail, long tail_len) {
+    double sum = 0.0, comp = 0.0;
+    for (int j = 0; j < 2 * REDUCE_ACCUMULATORS + tail_len; j++) {
+        double x = (j < REDUCE_ACCUMULATORS) ? s[j] :
+                   (j < 2 * REDUCE_ACCUMULATORS) ? -c[j - REDUCE_ACCUMULATORS] :
+                   tail[j - 2 * REDUCE_ACCUMULATORS];
+        double y = x - comp;
+        double t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+    }
+    return sum;
+}
+
+static double block_sum_compensated_scalar(const double *a, long n) {
+    double s[REDUCE_ACCUMULATORS] = {0.0}, c[REDUCE_ACCUMULATORS] = {0.0};
+    long i = 0;
+    for (; i + REDUCE_ACCUMULATORS <= n; i += REDUCE_ACCUMULATORS) {
+        for (int j = 0; j < REDUCE_ACCUMULATORS; j++) {
+            double y = a[i + j] - c[j];
+            double t = s[j] + y;
+            c[j] = (t - s[j]) - y;
+            s[j] = t;
+        }
+    }
+    return lanes_combine_compensated(s, c, a + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static double block_sum_compensated_avx2(const double *a, long n) {
+    __m256d s[4], c[4];
+    for (int k = 0; k < 4; k++) {
+        s[k] = _mm256_setzero_pd();
+        c[k] = _mm256_setzero_pd();
+    }
+    long i = 0;
+    for (; i + REDUCE_ACCUMULATORS <= n; i += REDUCE_ACCUMULATORS) {
+        for (int k = 0; k < 4; k++) {
+            __m256d y = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4 * k), c[k]);
+            __m256d t = _mm256_add_pd(s[k], y);
+            c[k] = _mm256_sub_pd(_mm256_sub_pd(t, s[k]), y);
+            s[k] = t;
+        }
+    }
+    double sl[REDUCE_ACCUMULATORS], cl[REDUCE_ACCUMULATORS];
+    for (int k = 0; k < 4; k++) {
+        _mm256_storeu_pd(sl + 4 * k, s[k]);
+        _mm256_storeu_pd(cl + 4 * k, c[k]);
+    }
+    return lanes_combine_compensated(sl, cl, a + i, n - i);
+}
+
+double reduce_sum_block(const double *a, long n) {
+    return use_avx2() ? block_sum_avx2(a, n) : block_sum_scalar(a, n);
+}
+
+double reduce_sum_block_compensated(const double *a, long n) {
+    return use_avx2() ? block_sum_compensated_avx2(a, n) : block_sum_compensated_scalar(a, n);
+}
+
+// ===== Tuned kernels of the fast mode =====
+// Same loops with a compile-time chain count, instantiated per count behind a
+// switch so the chains stay in registers
+
+static inline __attribute__((always_inline))
+double chains_sum_scalar(const double *a, long n, const int chains) {
+    double acc[REDUCE_MAX_CHAINS];
+    for (int k = 0; k < chains; k++) acc[k] = 0.0;
+    long i = 0;
+    for (; i + chains <= n; i += chains) {
+        #pragma GCC unroll 16
+        for (int k = 0; k < chains; k++) {
+            acc[k] += a[i + k];
+        }
+    }
+    double sum = reduce_pairwise(acc, chains);
+    for (; i < n; i++) sum += a[i];
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static inline __attribute__((always_inline))
+double chains_sum_avx2(const double *a, long n, const int chains) {
+    __m256d v[REDUCE_MAX_CHAINS];
+    for (int k = 0; k < chains; k++) v[k] = _mm256_setzero_pd();
+    long i = 0;
+    for (; i + 4 * chains <= n; i += 4 * chains) {
+        #pragma GCC unroll 16
+        for (int k = 0; k < chains; k++) {
+            v[k] = _mm256_add_pd(v[k], _mm256_loadu_pd(a + i + 4 * k));
+        }
+    }
+    double acc[4 * REDUCE_MAX_CHAINS];
+    for (int k = 0; k < chains; k++) _mm256_storeu_pd(acc + 4 * k, v[k]);
+    double sum = reduce_pairwise(acc, 4 * chains);
+    for (; i < n; i++) sum += a[i];
+    return sum;
+}
+
+#define CHAINS_CASE(F, C) case C: return F(a, n, C);
+#define CHAINS_CASES(F)                                                        \
+    CHAINS_CASE(F, 1)  CHAINS_CASE(F, 2)  CHAINS_CASE(F, 3)  CHAINS_CASE(F, 4)  \
+    CHAINS_CASE(F, 5)  CHAINS_CASE(F, 6)  CHAINS_CASE(F, 7)  CHAINS_CASE(F, 8)  \
+    CHAINS_CASE(F, 9)  CHAINS_CASE(F, 10) CHAINS_CASE(F, 11) CHAINS_CASE(F, 12) \
+    CHAINS_CASE(F, 13) CHAINS_CASE(F, 14) CHAINS_CASE(F, 15) CHAINS_CASE(F, 16)
+
+static double fast_sum_scalar(const double *a, long n, int chains) {
+    switch (chains) {
+    CHAINS_CASES(chains_sum_scalar)
+    }
+    return block_sum_scalar(a, n);
+}
+
+__attribute__((target("avx2")))
+static double fast_sum_avx2(const double *a, long n, int chains) {
+    switch (chains) {
+    CHAINS_CASES(chains_sum_avx2)
+    }
+    return block_sum_avx2(a, n);
+}
+
+int reduce_fast_chains(void) {
+    const TuneProfile *p = tune_profile_active();
+    const TuneIlpEntry *e = p ? tune_profile_ilp(p, "add", reduce_kernel_name()) : NULL;
+    if (e && e->chains > 0) {
+        return e->chains < REDUCE_MAX_CHAINS ? e->chains : REDUCE_MAX_CHAINS;
+    }
+    return use_avx2() ? REDUCE_ACCUMULATORS / 4 : REDUCE_ACCUMULATORS;
+}
+
+// ===== Trees =====
+
+double reduce_pairwise(const double *partials, long count) {
+    if (count <= 0) return 0.0;
+    if (count == 1) return partials[0];
+    if (count == 2) return partials[0] + partials[1];
+    long half = count / 2;
+    return reduce_pairwise(partials, half) + reduce_pairwise(partials + half, count - half);
+}
+
+// Function to sum with one contiguous chunk per thread
+static double sum_fast(const double *a, long n) {
+    double partials[REDUCE_MAX_THREADS];
+    int used = 1;
+    int avx2 = use_avx2();
+    int chains = reduce_fast_chains();
+
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+#else
+        int t = 0, nt = 1;
+#endif
+        if (nt > REDUCE_MAX_THREADS) nt = REDUCE_MAX_THREADS;
+        if (t < nt) {
+            long chunk = (n + nt - 1) / nt;
+            long begin = (long)t * chunk;
+            long len = begin < n ? ((n - begin < chunk) ? n - begin : chunk) : 0;
+            partials[t] = avx2 ? fast_sum_avx2(a + begin, len, chains)
+                               : fast_sum_scalar(a + begin, len, chains);
+        }
+        if (t == 0) used = nt;
+    }
+    return reduce_pairwise(partials, used);
+}
+
+// Function to sum fixed REDUCE_BLOCK blocks in any thread, then the block sums in a fixed tree
+static double sum_blocked(const double *a, long n, int compensated) {
+    long blocks = (n + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    if (blocks <= 1) {
+        return compensated ? reduce_sum_block_compensated(a, n) : reduce_sum_block(a, n);
+    }
+
+    double *partials = malloc(blocks * sizeof(double));
+    if (!partials) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < blocks; b++) {
+        long begin = b * REDUCE_BLOCK;
+        long len = (n - begin < REDUCE_BLOCK) ? n - begin : REDUCE_BLOCK;
+        partials[b] = compensated ? reduce_sum_block_compensated(a + begin, len)
+                                  : reduce_sum_block(a + begin, len);
+    }
+
+    double sum = reduce_pairwise(partials, blocks);
+    free(partials);
+    return sum;
+}
+
+double reduce_sum(const double *a, long n, ReduceMode mode) {
+    switch (mode) {
+    case REDUCE_REPRODUCIBLE: return sum_blocked(a, n, 0);
+    case REDUCE_COMPENSATED:  return sum_blocked(a, n, 1);
+    default:                  return sum_fast(a, n);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+// Sum reductions. A single accumulator waits one FP-add latency (about 4
+// cycles) per element; these kernels keep REDUCE_ACCUMULATORS independent
+// partial sums (4 AVX2 vectors of 4 lanes) so the adds pipeline.
+
+#define REDUCE_ACCUMULATORS 16
+
+// Most independent chains (AVX2 vectors, or scalars without AVX2) of REDUCE_FAST
+#define REDUCE_MAX_CHAINS 16
+
+// Elements per block of the reproducible modes. Blocks, not threads, are the
+// unit of summation, so the grouping of the additions is fixed by n alone.
+#define REDUCE_BLOCK 4096
+
+typedef enum {
+    REDUCE_FAST = 0,        // per-thread sums with reduce_fast_chains() chains, tree over threads (bits depend on T)
+    REDUCE_REPRODUCIBLE,    // fixed blocks, fixed lane order, pairwise tree over blocks (same bits for any T)
+    REDUCE_COMPENSATED,     // as reproducible, with Kahan-compensated lanes inside each block
+    REDUCE_NUM_MODES
+} ReduceMode;
+
+// Sum a[0..n) with one thread: multi-accumulator kernel (AVX2 when available;
+// the scalar fallback adds in exactly the same order and gives the same bits)
+double reduce_sum_block(const double *a, long n);
+
+// Kahan-compensated variant of reduce_sum_block
+double reduce_sum_block_compensated(const double *a, long n);
+
+// Sum a[0..n) on omp_get_max_threads() threads (built with -fopenmp)
+double reduce_sum(const double *a, long n, ReduceMode mode);
+
+// Independent add chains of REDUCE_FAST: the count that saturates the FP
+// adders of this CPU (ilp_bench --save), else REDUCE_ACCUMULATORS lanes.
+// The reproducible modes keep REDUCE_ACCUMULATORS so their bits never depend
+// on the machine profile.
+int reduce_fast_chains(void);
+
+// Pairwise (tree) sum of a small array of partial sums, in a fixed order
+double reduce_pairwise(const double *partials, long count);
+
+const char* reduce_mode_name(ReduceMode mode);
+
+// "avx2" or "scalar"
+const char* reduce_kernel_name(void);
+
+#endif
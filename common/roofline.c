@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "roofline.h"
+#include "bench.h"
+
+// Each ceiling is the best of this many timed passes
+#define ROOF_TRIALS 5
+
+// Minimum wall time of one STREAM measurement, to dwarf timer resolution
+#define ROOF_MIN_SECONDS 0.05
+
+// DRAM triad: at least 4x the LLC, at most this many bytes
+#define ROOF_DRAM_MAX_BYTES (512UL * 1024 * 1024)
+
+// Independent FMA chains per thread (>= latency x ports on current cores)
+#define ROOF_FMA_CHAINS 12
+#define ROOF_FMA_ITERS 20000000L
+
+static const char *level_names[ROOF_NUM_LEVELS] = {"L1", "L2", "LLC", "DRAM"};
+
+const char* roofline_level_name(RoofLevel level) {
+    return (level >= 0 && level < ROOF_NUM_LEVELS) ? level_names[level] : "?";
+}
+
+static int max_threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// ===== STREAM triad =====
+
+__attribute__((target("avx2,fma")))
+static void triad_avx2(double *restrict a, const double *restrict b,
+                       const double *restrict c, double s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        a[i] = b[i] + s * c[i];
+}
+
+static void triad_plain(double *restrict a, const double *restrict b,
+                        const double *restrict c, double s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        a[i] = b[i] + s * c[i];
+}
+
+// Function to run the triad on this thread's arrays `passes` times
+static void triad_passes(double *a, const double *b, const double *c, size_t n, long passes) {
+    int avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    for (long p = 0; p < passes; p++) {
+        if (avx2) triad_avx2(a, b, c, 3.0, n);
+        else triad_plain(a, b, c, 3.0, n);
+    }
+}
+
+// Function to measure triad bandwidth; per_thread: bytes is per thread
+// (private caches) instead of shared by all threads
+double roofline_stream_triad(size_t bytes, int per_thread) {
+    int threads = max_threads();
+    size_t total = per_thread ? bytes * threads : bytes;
+    size_t n = total / (3 * sizeof(double));
+    n -= n % (8 * threads);
+    if (n == 0) n = 8 * threads;
+
+    double *a, *b, *c;
+    if (posix_memalign((void**)&a, 64, n * sizeof(double)) ||
+        posix_memalign((void**)&b, 64, n * sizeof(double)) ||
+        posix_memalign((void**)&c, 64, n * sizeof(double))) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // First touch by the thread that will stream each chunk
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    // Calibrate passes so one measurement lasts ROOF_MIN_SECONDS
+    long passes = 1;
+    for (;;) {
+        double t0 = bench_now();
+        #pragma omp parallel
+        {
+#ifdef _OPENMP
+            int t = omp_get_thread_num(), nt = omp_get_num_threads();
+#else
+            int t = 0, nt = 1;
+#endif
+            size_t chunk = n / nt;
+            triad_passes(a + t * chunk, b + t * chunk, c + t * chunk, chunk, passes);
+        }
+        if (bench_now() - t0 >= ROOF_MIN_SECONDS || passes > (1L << 24)) break;
+        passes *= 2;
+    }
+
+    double best = 1e30;
+    for (int trial = 0; trial < ROOF_TRIALS; trial++) {
+        double t0 = bench_now();
+        #pragma omp parallel
+        {
+#ifdef _OPENMP
+            int t = omp_get_thread_num(), nt = omp_get_num_threads();
+#else
+            int t = 0, nt = 1;
+#endif
+            size_t chunk = n / nt;
+            triad_passes(a + t * chunk, b + t * chunk, c + t * chunk, chunk, passes);
+        }
+        double elapsed = bench_now() - t0;
+        if (elapsed < best) best = elapsed;
+    }
+
+    free(a);
+    free(b);
+    free(c);
+    // STREAM convention: 3 arrays x 8 bytes per element, write-allocate not counted
+    return 3.0 * sizeof(double) * n * passes / best / 1e9;
+}
+
+// ===== Peak FMA =====
+
+// Named accumulators so they stay in registers without relying on unrolling
+#define FMA_CHAINS(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7) OP(8) OP(9) OP(10) OP(11)
+
+__attribute__((target("avx2,fma")))
+static double fma_chains_avx2(long iters) {
+    const __m256d x = _mm256_set1_pd(0.999999), y = _mm256_set1_pd(1e-9);
+#define DECLARE(c) __m256d acc##c = _mm256_set1_pd(c);
+#define STEP(c) acc##c = _mm256_fmadd_pd(acc##c, x, y);
+#define SUM(c) sum = _mm256_add_pd(sum, acc##c);
+    FMA_CHAINS(DECLARE)
+    for (long i = 0; i < iters; i++) {
+        FMA_CHAINS(STEP)
+    }
+    __m256d sum = _mm256_setzero_pd();
+    FMA_CHAINS(SUM)
+#undef DECLARE
+#undef STEP
+#undef SUM
+    double out[4];
+    _mm256_storeu_pd(out, sum);
+    return out[0] + out[1] + out[2] + out[3];
+}
+
+static double fma_chains_scalar(long iters) {
+#define DECLARE(c) double acc##c = c;
+#define STEP(c) acc##c = acc##c * 0.999999 + 1e-9;
+#define SUM(c) sum += acc##c;
+    FMA_CHAINS(DECLARE)
+    for (long i = 0; i < iters; i++) {
+        FMA_CHAINS(STEP)
+    }
+    double sum = 0.0;
+    FMA_CHAINS(SUM)
+#undef DECLARE
+#undef STEP
+#undef SUM
+    return sum;
+}
+
+// Function to measure the peak of the widest FMA the kernels use (AVX2)
+double roofline_peak_fma(const char **isa) {
+    int avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    long iters = avx2 ? ROOF_FMA_ITERS : ROOF_FMA_ITERS / 4;
+    double lanes = avx2 ? 4.0 : 1.0;
+    volatile double sink = 0.0;
+    double best = 1e30;
+    int threads = max_threads();
+
+    if (isa) *isa = avx2 ? "AVX2+FMA" : "scalar";
+    for (int trial = 0; trial < ROOF_TRIALS; trial++) {
+        double t0 = bench_now();
+        #pragma omp parallel reduction(+:sink)
+        {
+            sink += avx2 ? fma_chains_avx2(iters) : fma_chains_scalar(iters);
+        }
+        double elapsed = bench_now() - t0;
+        if (elapsed < best) best = elapsed;
+    }
+    return 2.0 * lanes * ROOF_FMA_CHAINS * iters * threads / best / 1e9;
+}
+
+// ===== Machine ceilings =====
+
+void roofline_measure(MachineRoof *m) {
+    memset(m, 0, sizeof(*m));
+    cache_info_detect(&m->caches);
+    m->threads = max_threads();
+
+    const CacheInfo *c = &m->caches;
+    size_t dram = 4 * c->llc;
+    if (dram > ROOF_DRAM_MAX_BYTES) dram = ROOF_DRAM_MAX_BYTES;
+
+    // Half of each level, so the three arrays stay resident in it
+    m->working_set[ROOF_L1] = c->l1d / 2;
+    m->working_set[ROOF_L2] = c->l2 / 2;
+    m->working_set[ROOF_LLC] = c->llc / 2;
+    m->working_set[ROOF_DRAM] = dram;
+
+    m->peak_gflops = roofline_peak_fma(&m->peak_isa);
+    m->bandwidth[ROOF_L1] = roofline_stream_triad(m->working_set[ROOF_L1], 1);
+    m->bandwidth[ROOF_L2] = roofline_stream_triad(m->working_set[ROOF_L2], 1);
+    m->bandwidth[ROOF_LLC] = roofline_stream_triad(m->working_set[ROOF_LLC], 0);
+    m->bandwidth[ROOF_DRAM] = roofline_stream_triad(m->working_set[ROOF_DRAM], 0);
+}
+
+void roofline_print(const MachineRoof *m) {
+    printf("Peak (%s, %d thread%s): %.2f GFLOPS\n", m->peak_isa, m->threads,
+           m->threads > 1 ? "s" : "", m->peak_gflops);
+    for (int l = 0; l < ROOF_NUM_LEVELS; l++) {
+        printf("%-5s triad %9.1f KB: %8.2f GB/s  (ridge at %.2f flop/byte)\n",
+               level_names[l], m->working_set[l] / 1024.0, m->bandwidth[l],
+               m->peak_gflops / m->bandwidth[l]);
+    }
+}
+
+double roofline_attainable(const MachineRoof *m, RoofLevel level, double intensity) {
+    double memory_bound = intensity * m->bandwidth[level];
+    return memory_bound < m->peak_gflops ? memory_bound : m->peak_gflops;
+}
+
+// ===== Traffic models =====
+
+RoofLevel roofline_home_level(const CacheInfo *c, int n) {
+    return roofline_level_for_bytes(c, 3.0 * n * n * sizeof(double));
+}
+
+RoofLevel roofline_level_for_bytes(const CacheInfo *c, double bytes) {
+    if (bytes <= c->l1d) return ROOF_L1;
+    if (bytes <= c->l2) return ROOF_L2;
+    if (bytes <= c->llc) return ROOF_LLC;
+    return ROOF_DRAM;
+}
+
+// Function to return the capacity Z of the cache above the home level (0 for L1)
+static double cache_above(const CacheInfo *c, int n) {
+    switch (roofline_home_level(c, n)) {
+        case ROOF_L2:  return c->l1d;
+        case ROOF_LLC: return c->l2;
+        case ROOF_DRAM: return c->llc;
+        default:       return 0.0;
+    }
+}
+
+// Compulsory traffic: read A and B, read and write C
+static double compulsory(int n) {
+    return 4.0 * n * n * sizeof(double);
+}
+
+double roofline_traffic_loop_order(const CacheInfo *c, int order, int n) {
+    // Operand swept once per outer iteration (0=A, 1=B, 2=C) and whether the
+    // innermost loop walks it down a column; indices follow loop_order_name()
+    static const int swept[6] = {1, 1, 0, 0, 2, 2};       // ijk ikj jik jki kij kji
+    static const int strided[6] = {1, 0, 0, 1, 0, 1};
+    double z = cache_above(c, n);
+    double matrix = (double)n * n * sizeof(double);
+
+    if (z == 0.0 || matrix <= z / 2 || order < 0 || order > 5) return compulsory(n);
+
+    double sweep = (double)n * matrix;                     // n passes over one matrix
+    if (swept[order] == 2) sweep *= 2.0;                   // C is read and written
+    if (strided[order] && (double)n * c->line > z) sweep *= c->line / sizeof(double);
+    return compulsory(n) + sweep;
+}
+
+double roofline_traffic_blocked(const CacheInfo *c, int n, int block) {
+    double z = cache_above(c, n);
+    if (z == 0.0) return compulsory(n);
+    if (3.0 * block * block * sizeof(double) > z) return roofline_traffic_loop_order(c, 0, n);
+
+    // A and B tiles per (i0, j0, k0) step, each C tile read and written once
+    double steps = ceil((double)n / block);
+    return steps * steps * steps * 2.0 * block * block * sizeof(double) + compulsory(n) / 2.0;
+}
+
+double roofline_traffic_packed(const CacheInfo *c, int n, int mc, int kc, int nc) {
+    double z = cache_above(c, n);
+    if (z == 0.0) return compulsory(n);
+
+    double b_reads = (double)n * n;                        // B panel packed once per (jc, pc)
+    if ((double)kc * nc * sizeof(double) > z) {
+        b_reads *= ceil((double)n / mc);                   // panel evicted between ic blocks
+    }
+    double a_reads = (double)n * n * ceil((double)n / nc);
+    double c_updates = 2.0 * n * n * ceil((double)n / kc);
+    return (a_reads + b_reads + c_updates) * sizeof(double);
+}
+
+double roofline_traffic_oblivious(const CacheInfo *c, int n) {
+    double z = cache_above(c, n);
+    if (z == 0.0) return compulsory(n);
+    int block = (int)sqrt(z / (3.0 * sizeof(double)));
+    return roofline_traffic_blocked(c, n, block > 1 ? block : 1);
+}
@@ -0,0 +1,67 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <stddef.h>
+
+#include "cache_info.h"
+
+// Memory levels of the roofline, fastest first
+typedef enum {
+    ROOF_L1,
+    ROOF_L2,
+    ROOF_LLC,
+    ROOF_DRAM,
+    ROOF_NUM_LEVELS
+} RoofLevel;
+
+// Measured ceilings of this machine
+typedef struct {
+    int threads;                          // OpenMP threads used for every ceiling
+    double peak_gflops;                   // FMA microbenchmark
+    const char *peak_isa;                 // "AVX2+FMA" or "scalar"
+    double bandwidth[ROOF_NUM_LEVELS];    // STREAM triad GB/s per level
+    size_t working_set[ROOF_NUM_LEVELS];  // bytes touched by each triad
+    CacheInfo caches;
+} MachineRoof;
+
+const char* roofline_level_name(RoofLevel level);
+
+// Measure the peak and the four bandwidth ceilings with omp_get_max_threads()
+// threads (run with OMP_NUM_THREADS=1 to get the roof of a serial kernel)
+void roofline_measure(MachineRoof *m);
+void roofline_print(const MachineRoof *m);
+
+// STREAM triad a = b + s*c over `bytes` (all three arrays), best-of-N GB/s
+double roofline_stream_triad(size_t bytes, int per_thread);
+
+// Peak double-precision GFLOPS of independent FMA chains
+double roofline_peak_fma(const char **isa);
+
+// min(peak, intensity * bandwidth of level)
+double roofline_attainable(const MachineRoof *m, RoofLevel level, double intensity);
+
+// ===== Traffic models for C(n x n) += A * B =====
+// Operands totalling 3*n*n*8 bytes live in their "home" level: the smallest
+// cache holding them, else DRAM. The models count bytes crossing between the
+// home level and the cache right above it (capacity Z), so intensity =
+// 2n^3 / traffic is the one the home level's bandwidth ceiling applies to.
+
+RoofLevel roofline_home_level(const CacheInfo *c, int n);
+
+// Smallest level holding a working set of `bytes`
+RoofLevel roofline_level_for_bytes(const CacheInfo *c, double bytes);
+
+// Naive loop order (mxm_kernels.h index): one operand is swept per outer
+// iteration, at a full line per element when the inner loop strides over it
+double roofline_traffic_loop_order(const CacheInfo *c, int order, int n);
+
+// matrix_multiply_block with b x b tiles
+double roofline_traffic_blocked(const CacheInfo *c, int n, int block);
+
+// GotoBLAS loop nest with MC x KC x NC blocking (packed GEMM, tiled kernel)
+double roofline_traffic_packed(const CacheInfo *c, int n, int mc, int kc, int nc);
+
+// Cache-oblivious recursion: behaves as tiles of sqrt(Z / 24) doubles
+double roofline_traffic_oblivious(const CacheInfo *c, int n);
+
+#endif
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <immintrin.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "scan.h"
+
+// Largest thread count whose block carries are kept
+#define SCAN_MAX_THREADS 256
+
+static int use_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+void scan_mul_serial(double *a, long n, double first, double factor) {
+    if (n <= 0) return;
+    a[0] = first;
+    for (long i = 1; i < n; i++) {
+        a[i] = a[i - 1] * factor;
+    }
+}
+
+// ===== In-block kernels: a[i] = start * factor^i over one block =====
+
+static void block_scan_scalar(double *a, long len, double start, double factor) {
+    double v = start;
+    for (long i = 0; i < len; i++) {
+        a[i] = v;
+        v *= factor;
+    }
+}
+
+// Two 4-lane chains: lanes hold factor^0..3 and factor^4..7 times start, and
+// each step multiplies both by factor^8, so the dependency chain is len/8 long
+__attribute__((target("avx2")))
+static void block_scan_avx2(double *a, long len, double start, double factor) {
+    double p[SCAN_SIMD_WIDTH + 1];
+    p[0] = 1.0;
+    for (int j = 1; j <= SCAN_SIMD_WIDTH; j++) p[j] = p[j - 1] * factor;
+
+    const __m256d s = _mm256_set1_pd(start);
+    __m256d v0 = _mm256_mul_pd(s, _mm256_loadu_pd(p));
+    __m256d v1 = _mm256_mul_pd(s, _mm256_loadu_pd(p + 4));
+    const __m256d step = _mm256_set1_pd(p[SCAN_SIMD_WIDTH]);
+
+    long i = 0;
+    for (; i + SCAN_SIMD_WIDTH <= len; i += SCAN_SIMD_WIDTH) {
+        _mm256_storeu_pd(a + i, v0);
+        _mm256_storeu_pd(a + i + 4, v1);
+        v0 = _mm256_mul_pd(v0, step);
+        v1 = _mm256_mul_pd(v1, step);
+    }
+
+    // Tail: continue from the last full step
+    double v = (i > 0) ? a[i - 1] * factor : start;
+    for (; i < len; i++) {
+        a[i] = v;
+        v *= factor;
+    }
+}
+
+static void block_scale(double *a, long len, double carry) {
+    for (long i = 0; i < len; i++) {
+        a[i] *= carry;
+    }
+}
+
+__attribute__((target("avx2")))
+static void block_scale_avx2(double *a, long len, double carry) {
+    const __m256d c = _mm256_set1_pd(carry);
+    long i = 0;
+    for (; i + 4 <= len; i += 4) {
+        _mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), c));
+    }
+    for (; i < len; i++) {
+        a[i] *= carry;
+    }
+}
+
+const char* scan_kernel_name(void) {
+    return use_avx2() ? "avx2" : "scalar";
+}
+
+// Function to run the blocked two-pass scan
+void scan_mul_blocked(double *a, long n, double first, double factor) {
+    if (n <= 0) return;
+    double totals[SCAN_MAX_THREADS + 1];
+    int avx2 = use_avx2();
+
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+#else
+        int t = 0, nt = 1;
+#endif
+        if (nt > SCAN_MAX_THREADS) nt = SCAN_MAX_THREADS;
+        long chunk = (n + nt - 1) / nt;
+        chunk += (SCAN_SIMD_WIDTH - chunk % SCAN_SIMD_WIDTH) % SCAN_SIMD_WIDTH;
+        long begin = (long)t * chunk;
+        long len = (t < nt && begin < n) ? ((n - begin < chunk) ? n - begin : chunk) : 0;
+
+        // Pass 1: local scan from 1.0 (block 0 starts from `first` directly);
+        // the block total is the value one step past its last element
+        if (len > 0) {
+            double start = (t == 0) ? first : 1.0;
+            if (avx2) block_scan_avx2(a + begin, len, start, factor);
+            else block_scan_scalar(a + begin, len, start, factor);
+            totals[t + 1] = a[begin + len - 1] * factor;
+        } else if (t < SCAN_MAX_THREADS) {
+            totals[t + 1] = 1.0;
+        }
+
+        // Carries: running product of the totals of the blocks before each one
+        #pragma omp barrier
+        #pragma omp single
+        {
+            double carry = 1.0;
+            for (int b = 1; b < nt; b++) {
+                carry *= totals[b];
+                totals[b] = carry;
+            }
+        }
+
+        // Pass 2: scale every block but the first by its carry
+        if (len > 0 && t > 0) {
+            if (avx2) block_scale_avx2(a + begin, len, totals[t]);
+            else block_scale(a + begin, len, totals[t]);
+        }
+    }
+}
+
+void scan_mul_pow(double *a, long n, double first, double factor) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; i++) {
+        a[i] = first * pow(factor, (double)i);
+    }
+}
+
+double scan_max_rel_error(const double *a, const double *ref, long n) {
+    double worst = 0.0;
+    for (long i = 0; i < n; i++) {
+        double d = fabs(a[i] - ref[i]);
+        double r = fabs(ref[i]);
+        double e = r > 0.0 ? d / r : d;
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+double scan_error_bound(long n) {
+    return (2.0 * n + 4.0) * (DBL_EPSILON / 2.0);
+}
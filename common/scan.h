@@ -0,0 +1,35 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+// Multiplicative scan for the add_noise / generate_noise recurrence
+//   a[0] = first, a[i] = a[i-1] * factor      (so a[i] = first * factor^i)
+// The serial loop is one dependent multiply per element; the variants below
+// break the chain so the work spreads over SIMD lanes and threads.
+
+// Elements per AVX2 step of the in-block scan (two independent 4-lane chains)
+#define SCAN_SIMD_WIDTH 8
+
+// Reference: the loop of exercice3.c
+void scan_mul_serial(double *a, long n, double first, double factor);
+
+// Blocked two-pass scan: every thread scans its own block starting from 1.0
+// (SIMD lanes seeded with factor^0..factor^7, stepped by factor^8), the block
+// totals are scanned serially, then every thread scales its block by its carry.
+// Runs on omp_get_max_threads() threads when built with -fopenmp.
+void scan_mul_blocked(double *a, long n, double first, double factor);
+
+// Closed form a[i] = first * pow(factor, i): no dependency at all
+void scan_mul_pow(double *a, long n, double first, double factor);
+
+// Largest relative difference |a[i] - ref[i]| / |ref[i]|
+double scan_max_rel_error(const double *a, const double *ref, long n);
+
+// Bound on the relative difference between any two variants: each rounds at
+// most n times (serial chain) against the exact first * factor^i, so two of
+// them differ by at most 2n unit roundoffs (first order), plus a few for pow
+double scan_error_bound(long n);
+
+// Name of the in-block kernel picked at runtime ("avx2" or "scalar")
+const char* scan_kernel_name(void);
+
+#endif
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "strassen.h"
+#include "gemm.h"
+
+// Workspace rows are padded to whole cache lines like allocate_matrix rows
+#define LINE_DOUBLES (MATRIX_ALIGNMENT / (int)sizeof(double))
+
+// Function to round a row length up to a whole number of cache lines
+static int padded(int cols) {
+    return (cols + LINE_DOUBLES - 1) / LINE_DOUBLES * LINE_DOUBLES;
+}
+
+// Function to carve a rows x cols matrix out of the workspace
+static Matrix take(double **ws, int rows, int cols) {
+    Matrix t;
+    t.data = *ws;
+    t.rows = rows;
+    t.cols = cols;
+    t.ld = padded(cols);
+    t.owner = 0;
+    *ws += (size_t)rows * t.ld;
+    return t;
+}
+
+// Function to tell whether a level recurses
+static int recurses(int m, int n, int k, int crossover) {
+    int smallest = m < n ? (m < k ? m : k) : (n < k ? n : k);
+    return smallest > crossover && smallest >= 2;
+}
+
+// Workspace per level: X (m2 x k2), Y (k2 x n2), Z (m2 x n2) plus the next level
+size_t strassen_workspace_size(int m, int n, int k, int crossover) {
+    if (!recurses(m, n, k, crossover)) return 0;
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    size_t level = (size_t)m2 * padded(k2) + (size_t)k2 * padded(n2) + (size_t)m2 * padded(n2);
+    return level + strassen_workspace_size(m2, n2, k2, crossover);
+}
+
+// Function to allocate the Strassen workspace
+double* strassen_allocate_workspace(int m, int n, int k, int crossover) {
+    size_t count = strassen_workspace_size(m, n, k, crossover);
+    void *p = NULL;
+    if (posix_memalign(&p, MATRIX_ALIGNMENT, (count ? count : 1) * sizeof(double)) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return (double*)p;
+}
+
+// Z = X + Y (Z may alias X or Y)
+static void add(const Matrix *X, const Matrix *Y, Matrix *Z) {
+    for (int i = 0; i < Z->rows; i++) {
+        const double *x = &MAT(X, i, 0), *y = &MAT(Y, i, 0);
+        double *z = &MAT(Z, i, 0);
+        for (int j = 0; j < Z->cols; j++) z[j] = x[j] + y[j];
+    }
+}
+
+// Z = X - Y (Z may alias X or Y)
+static void sub(const Matrix *X, const Matrix *Y, Matrix *Z) {
+    for (int i = 0; i < Z->rows; i++) {
+        const double *x = &MAT(X, i, 0), *y = &MAT(Y, i, 0);
+        double *z = &MAT(Z, i, 0);
+        for (int j = 0; j < Z->cols; j++) z[j] = x[j] - y[j];
+    }
+}
+
+// Classic C = A * B through the packed engine
+static void classic(const Matrix *A, const Matrix *B, Matrix *C) {
+    zero_matrix(C);
+    gemm_packed(A, B, C, NULL);
+}
+
+static void winograd(const Matrix *A, const Matrix *B, Matrix *C, int crossover, double *ws);
+
+// Function to handle odd dimensions by peeling the last row / column / k slice
+static void peel(const Matrix *A, const Matrix *B, Matrix *C, int crossover, double *ws) {
+    const int m = C->rows, n = C->cols, k = A->cols;
+    const int me = m & ~1, ne = n & ~1, ke = k & ~1;
+
+    Matrix Ae = matrix_view(A, 0, 0, me, ke);
+    Matrix Be = matrix_view(B, 0, 0, ke, ne);
+    Matrix Ce = matrix_view(C, 0, 0, me, ne);
+    winograd(&Ae, &Be, &Ce, crossover, ws);
+
+    // Odd K: rank-1 update with the last column of A and last row of B
+    if (k != ke) {
+        for (int i = 0; i < me; i++) {
+            const double a = MAT(A, i, k - 1);
+            const double *b = &MAT(B, k - 1, 0);
+            double *c = &MAT(C, i, 0);
+            for (int j = 0; j < ne; j++) c[j] += a * b[j];
+        }
+    }
+    // Odd N: last column of C over all rows
+    if (n != ne) {
+        for (int i = 0; i < m; i++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) sum += MAT(A, i, p) * MAT(B, p, n - 1);
+            MAT(C, i, n - 1) = sum;
+        }
+    }
+    // Odd M: last row of C (the corner was done with the column)
+    if (m != me) {
+        double *c = &MAT(C, m - 1, 0);
+        for (int j = 0; j < ne; j++) c[j] = 0.0;
+        for (int p = 0; p < k; p++) {
+            const double a = MAT(A, m - 1, p);
+            const double *b = &MAT(B, p, 0);
+            for (int j = 0; j < ne; j++) c[j] += a * b[j];
+        }
+    }
+}
+
+// One Strassen-Winograd level on even-sized operands.
+// Schedule keeps the 7 products in the quadrants of C plus three temporaries
+// X, Y, Z from the workspace:
+//   S1 = A21 + A22   S2 = S1 - A11   S3 = A11 - A21   S4 = A12 - S2
+//   T1 = B12 - B11   T2 = B22 - T1   T3 = B22 - B12   T4 = T2 - B21
+//   P1 = A11 B11  P2 = A12 B21  P3 = S4 B22  P4 = A22 T4
+//   P5 = S1 T1    P6 = S2 T2    P7 = S3 T3
+//   C11 = P1 + P2           C12 = P1 + P6 + P5 + P3
+//   C21 = P1 + P6 + P7 - P4 C22 = P1 + P6 + P7 + P5
+static void winograd(const Matrix *A, const Matrix *B, Matrix *C, int crossover, double *ws) {
+    const int m = C->rows, n = C->cols, k = A->cols;
+
+    if (!recurses(m, n, k, crossover)) {
+        classic(A, B, C);
+        return;
+    }
+    if ((m | n | k) & 1) {
+        peel(A, B, C, crossover, ws);
+        return;
+    }
+
+    const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    Matrix A11 = matrix_view(A, 0, 0, m2, k2), A12 = matrix_view(A, 0, k2, m2, k2);
+    Matrix A21 = matrix_view(A, m2, 0, m2, k2), A22 = matrix_view(A, m2, k2, m2, k2);
+    Matrix B11 = matrix_view(B, 0, 0, k2, n2), B12 = matrix_view(B, 0, n2, k2, n2);
+    Matrix B21 = matrix_view(B, k2, 0, k2, n2), B22 = matrix_view(B, k2, n2, k2, n2);
+    Matrix C11 = matrix_view(C, 0, 0, m2, n2), C12 = matrix_view(C, 0, n2, m2, n2);
+    Matrix C21 = matrix_view(C, m2, 0, m2, n2), C22 = matrix_view(C, m2, n2, m2, n2);
+
+    double *next = ws;
+    Matrix X = take(&next, m2, k2);
+    Matrix Y = take(&next, k2, n2);
+    Matrix Z = take(&next, m2, n2);
+
+    sub(&A11, &A21, &X);                        // X = S3
+    sub(&B22, &B12, &Y);                        // Y = T3
+    winograd(&X, &Y, &C21, crossover, next);    // C21 = P7
+    add(&A21, &A22, &X);                        // X = S1
+    sub(&B12, &B11, &Y);                        // Y = T1
+    winograd(&X, &Y, &C22, crossover, next);    // C22 = P5
+    sub(&X, &A11, &X);                          // X = S2
+    sub(&B22, &Y, &Y);                          // Y = T2
+    winograd(&X, &Y, &C12, crossover, next);    // C12 = P6
+    sub(&A12, &X, &X);                          // X = S4
+    winograd(&X, &B22, &C11, crossover, next);  // C11 = P3
+    winograd(&A11, &B11, &Z, crossover, next);  // Z = P1
+    add(&C12, &Z, &C12);                        // C12 = U2 = P1 + P6
+    add(&C21, &C12, &C21);                      // C21 = U3 = U2 + P7
+    add(&C12, &C22, &C12);                      // C12 = U4 = U2 + P5
+    add(&C22, &C21, &C22);                      // C22 = U7 = U3 + P5  (final)
+    add(&C12, &C11, &C12);                      // C12 = U5 = U4 + P3  (final)
+    sub(&Y, &B21, &Y);                          // Y = T4
+    winograd(&A22, &Y, &C11, crossover, next);  // C11 = P4
+    sub(&C21, &C11, &C21);                      // C21 = U6 = U3 - P4  (final)
+    winograd(&A12, &B21, &C11, crossover, next); // C11 = P2
+    add(&C11, &Z, &C11);                        // C11 = U1 = P1 + P2  (final)
+}
+
+// Strassen-Winograd entry point
+void strassen_multiply(const Matrix *A, const Matrix *B, Matrix *C, int crossover,
+                       double *workspace) {
+    if (crossover < 1) crossover = STRASSEN_CROSSOVER;
+    winograd(A, B, C, crossover, workspace);
+}
@@ -0,0 +1,28 @@
+#ifndef STRASSEN_H
+#define STRASSEN_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+// Recurse while the smallest of M, N and K is above this size
+#ifndef STRASSEN_CROSSOVER
+#define STRASSEN_CROSSOVER 512
+#endif
+
+// Number of doubles of workspace strassen_multiply needs for these sizes
+size_t strassen_workspace_size(int m, int n, int k, int crossover);
+
+// Allocate a workspace for strassen_multiply (exits on failure)
+double* strassen_allocate_workspace(int m, int n, int k, int crossover);
+
+// C = A * B with the Strassen-Winograd variant (7 multiplies, 15 additions
+// per level). Below the crossover it calls gemm_packed. Odd dimensions are
+// handled by dynamic peeling: the even part recurses, and the last row,
+// column or rank-1 term is fixed up with classic loops.
+// workspace must hold strassen_workspace_size(m, n, k, crossover) doubles;
+// no other memory is allocated during the recursion.
+void strassen_multiply(const Matrix *A, const Matrix *B, Matrix *C, int crossover,
+                       double *workspace);
+
+#endif
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "tune_profile.h"
+
+static TuneProfile active_profile;
+static int active_loaded = 0;
+static pthread_once_t active_once = PTHREAD_ONCE_INIT;
+
+// Function to read the CPU model name
+void tune_cpu_name(char *buf, size_t len) {
+    snprintf(buf, len, "unknown-cpu");
+
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if (!f) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "model name", 10) == 0) {
+            char *value = strchr(line, ':');
+            if (value) {
+                value++;
+                while (*value == ' ' || *value == '\t') value++;
+                value[strcspn(value, "\n")] = '\0';
+                snprintf(buf, len, "%s", value);
+            }
+            break;
+        }
+    }
+    fclose(f);
+}
+
+// Function to build the profile directory name
+static void profile_dir(char *buf, size_t len) {
+    const char *dir = getenv(TUNE_PROFILE_DIR_ENV);
+    if (dir && *dir) {
+        snprintf(buf, len, "%s", dir);
+        return;
+    }
+    const char *home = getenv("HOME");
+    snprintf(buf, len, "%s/.cache/mxm", home ? home : ".");
+}
+
+// Function to build the profile file path: <dir>/<sanitized cpu model>.profile
+void tune_profile_path(char *buf, size_t len) {
+    char dir[512], cpu[128], name[128];
+    profile_dir(dir, sizeof(dir));
+    tune_cpu_name(cpu, sizeof(cpu));
+
+    size_t j = 0;
+    for (size_t i = 0; cpu[i] && j + 1 < sizeof(name); i++) {
+        unsigned char ch = (unsigned char)cpu[i];
+        if (isalnum(ch) || ch == '-' || ch == '.') {
+            name[j++] = ch;
+        } else if (j > 0 && name[j - 1] != '_') {
+            name[j++] = '_';
+        }
+    }
+    while (j > 0 && name[j - 1] == '_') j--;
+    name[j] = '\0';
+
+    snprintf(buf, len, "%s/%s.profile", dir, name);
+}
+
+// Function to load the profile of this machine
+int tune_profile_load(TuneProfile *p) {
+    char path[768];
+    tune_profile_path(path, sizeof(path));
+
+    memset(p, 0, sizeof(*p));
+    tune_cpu_name(p->cpu, sizeof(p->cpu));
+
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "caches l1d=%zu l2=%zu llc=%zu",
+                   &p->cache_l1d, &p->cache_l2, &p->cache_llc) == 3) {
+            continue;
+        }
+        if (sscanf(line, "stream_threads=%d", &p->stream_threads) == 1) {
+            continue;
+        }
+        TuneIlpEntry ilp;
+        memset(&ilp, 0, sizeof(ilp));
+        if (sscanf(line, "ilp op=%7s width=%7s latency=%lf throughput=%lf chains=%d",
+                   ilp.op, ilp.width, &ilp.latency, &ilp.throughput, &ilp.chains) == 5) {
+            tune_profile_set_ilp(p, &ilp);
+            continue;
+        }
+        if (p->count >= TUNE_MAX_ENTRIES) {
+            continue;
+        }
+        TuneEntry e;
+        memset(&e, 0, sizeof(e));
+        if (sscanf(line, "n=%d mc=%d kc=%d nc=%d tile_m=%d tile_k=%d tile_n=%d "
+                         "order=%3s unroll=%d gemm_gflops=%lf tiled_gflops=%lf",
+                   &e.n, &e.mc, &e.kc, &e.nc, &e.tile_m, &e.tile_k, &e.tile_n,
+                   e.order, &e.unroll, &e.gemm_gflops, &e.tiled_gflops) == 11) {
+            p->entries[p->count++] = e;
+        }
+    }
+    fclose(f);
+    return p->count > 0 || p->cache_l1d > 0 || p->stream_threads > 0 || p->ilp_count > 0;
+}
+
+// Function to save the profile of this machine
+int tune_profile_save(const TuneProfile *p) {
+    char dir[512], path[768];
+    profile_dir(dir, sizeof(dir));
+    tune_profile_path(path, sizeof(path));
+
+    // mkdir -p
+    for (char *s = dir + 1; *s; s++) {
+        if (*s == '/') {
+            *s = '\0';
+            mkdir(dir, 0755);
+            *s = '/';
+        }
+    }
+    mkdir(dir, 0755);
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    fprintf(f, "# mxm autotune profile\n");
+    fprintf(f, "# cpu: %s\n", p->cpu);
+    if (p->cache_l1d || p->cache_l2 || p->cache_llc) {
+        fprintf(f, "caches l1d=%zu l2=%zu llc=%zu\n", p->cache_l1d, p->cache_l2, p->cache_llc);
+    }
+    if (p->stream_threads > 0) {
+        fprintf(f, "stream_threads=%d\n", p->stream_threads);
+    }
+    for (int i = 0; i < p->ilp_count; i++) {
+        const TuneIlpEntry *e = &p->ilp[i];
+        fprintf(f, "ilp op=%s width=%s latency=%.2f throughput=%.2f chains=%d\n",
+                e->op, e->width, e->latency, e->throughput, e->chains);
+    }
+    for (int i = 0; i < p->count; i++) {
+        const TuneEntry *e = &p->entries[i];
+        fprintf(f, "n=%d mc=%d kc=%d nc=%d tile_m=%d tile_k=%d tile_n=%d "
+                   "order=%s unroll=%d gemm_gflops=%.2f tiled_gflops=%.2f\n",
+                e->n, e->mc, e->kc, e->nc, e->tile_m, e->tile_k, e->tile_n,
+                e->order, e->unroll, e->gemm_gflops, e->tiled_gflops);
+    }
+    fclose(f);
+    return 1;
+}
+
+// Function to find the entry tuned for the closest matrix size
+const TuneEntry* tune_profile_lookup(const TuneProfile *p, int n) {
+    const TuneEntry *best = NULL;
+    int best_dist = 0;
+    for (int i = 0; i < p->count; i++) {
+        int dist = abs(p->entries[i].n - n);
+        if (!best || dist < best_dist) {
+            best = &p->entries[i];
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+// Function to add or replace the entry for one matrix size
+void tune_profile_set(TuneProfile *p, const TuneEntry *e) {
+    for (int i = 0; i < p->count; i++) {
+        if (p->entries[i].n == e->n) {
+            p->entries[i] = *e;
+            return;
+        }
+    }
+    if (p->count < TUNE_MAX_ENTRIES) {
+        p->entries[p->count++] = *e;
+    }
+}
+
+// Function to find the ILP entry of one operation and vector width
+const TuneIlpEntry* tune_profile_ilp(const TuneProfile *p, const char *op, const char *width) {
+    for (int i = 0; i < p->ilp_count; i++) {
+        if (strcmp(p->ilp[i].op, op) == 0 && strcmp(p->ilp[i].width, width) == 0) {
+            return &p->ilp[i];
+        }
+    }
+    return NULL;
+}
+
+// Function to add or replace the ILP entry of one operation and vector width
+void tune_profile_set_ilp(TuneProfile *p, const TuneIlpEntry *e) {
+    for (int i = 0; i < p->ilp_count; i++) {
+        if (strcmp(p->ilp[i].op, e->op) == 0 && strcmp(p->ilp[i].width, e->width) == 0) {
+            p->ilp[i] = *e;
+            return;
+        }
+    }
+    if (p->ilp_count < TUNE_MAX_ILP) {
+        p->ilp[p->ilp_count++] = *e;
+    }
+}
+
+// Function to load the active profile exactly once
+static void load_active(void) {
+    const char *env = getenv(TUNE_PROFILE_ENV);
+    if (env && strcmp(env, "off") == 0) return;
+    active_loaded = tune_profile_load(&active_profile);
+}
+
+// Function to return the process-wide profile
+const TuneProfile* tune_profile_active(void) {
+    pthread_once(&active_once, load_active);
+    return active_loaded ? &active_profile : NULL;
+}
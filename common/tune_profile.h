@@ -0,0 +1,75 @@
+#ifndef TUNE_PROFILE_H
+#define TUNE_PROFILE_H
+
+#include <stddef.h>
+
+// Tuned configurations kept per profile (one per matrix size)
+#define TUNE_MAX_ENTRIES 32
+
+// Environment variables:
+//   MXM_PROFILE_DIR  directory holding <cpu-model>.profile (default ~/.cache/mxm)
+//   MXM_PROFILE=off  ignore any saved profile
+#define TUNE_PROFILE_DIR_ENV "MXM_PROFILE_DIR"
+#define TUNE_PROFILE_ENV     "MXM_PROFILE"
+
+// Winners of one autotuning run at size n
+typedef struct {
+    int n;
+    int mc, kc, nc;                  // packed GEMM blocking
+    int tile_m, tile_k, tile_n;      // tiled (portable) kernel blocking
+    char order[4];                   // loop order inside a tile ("ikj", ...)
+    int unroll;                      // unroll-and-jam factor of the k loop
+    double gemm_gflops;
+    double tiled_gflops;
+} TuneEntry;
+
+// FP instruction timing of one operation at one vector width (ilp_bench --save)
+#define TUNE_MAX_ILP 16
+
+typedef struct {
+    char op[8];                      // "add", "mul", "fma", "div", "sqrt"
+    char width[8];                   // "scalar", "sse", "avx2"
+    double latency;                  // cycles, one dependent chain
+    double throughput;               // instructions per cycle, best chain count
+    int chains;                      // independent chains reaching 90% of that throughput
+} TuneIlpEntry;
+
+typedef struct {
+    char cpu[128];
+    size_t cache_l1d, cache_l2, cache_llc;   // measured by stride --latency --save (0: not measured)
+    int stream_threads;                      // threads saturating memory bandwidth (stride --parallel)
+    int count;
+    TuneEntry entries[TUNE_MAX_ENTRIES];
+    int ilp_count;
+    TuneIlpEntry ilp[TUNE_MAX_ILP];
+} TuneProfile;
+
+// CPU model name from /proc/cpuinfo ("unknown-cpu" if unavailable)
+void tune_cpu_name(char *buf, size_t len);
+
+// Full path of this machine's profile file
+void tune_profile_path(char *buf, size_t len);
+
+// Load this machine's profile; returns 1 on success, 0 if there is none
+// (a profile holding only stride probe or ilp_bench results counts as one)
+int tune_profile_load(TuneProfile *p);
+
+// Save the profile (creates the directory if needed); returns 1 on success
+int tune_profile_save(const TuneProfile *p);
+
+// Entry whose n is closest to the requested size (NULL if empty)
+const TuneEntry* tune_profile_lookup(const TuneProfile *p, int n);
+
+// Insert an entry, replacing any previous entry for the same n
+void tune_profile_set(TuneProfile *p, const TuneEntry *e);
+
+// ILP entry of one operation and width (NULL if not measured)
+const TuneIlpEntry* tune_profile_ilp(const TuneProfile *p, const char *op, const char *width);
+
+// Insert an ILP entry, replacing any previous entry for the same op and width
+void tune_profile_set_ilp(TuneProfile *p, const TuneIlpEntry *e);
+
+// Profile loaded once per process at first use (NULL if none or disabled)
+const TuneProfile* tune_profile_active(void);
+
+#endif
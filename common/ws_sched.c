@@ -0,0 +1,227 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+
+#include "ws_sched.h"
+
+// Worker index of the current thread (-1 outside the scheduler)
+static __thread int current_worker = -1;
+
+// ===== Chase-Lev deque =====
+// Memory orderings follow Le, Pop, Cohen, Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+
+// Function to push a task at the bottom (owner only); returns 0 if full
+static int deque_push(WsDeque *d, WsTask *task) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= WS_DEQUE_CAPACITY) return 0;
+
+    atomic_store_explicit(&d->buffer[b % WS_DEQUE_CAPACITY], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+// Function to pop a task from the bottom (owner only)
+static WsTask* deque_pop(WsDeque *d) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    WsTask *task = NULL;
+    if (t <= b) {
+        task = atomic_load_explicit(&d->buffer[b % WS_DEQUE_CAPACITY], memory_order_relaxed);
+        if (t == b) {
+            // Last element: race against thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                         memory_order_seq_cst,
+                                                         memory_order_relaxed)) {
+                task = NULL;
+            }
+            atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Function to steal a task from the top (any thread)
+static WsTask* deque_steal(WsDeque *d) {
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+    if (t < b) {
+        WsTask *task = atomic_load_explicit(&d->buffer[t % WS_DEQUE_CAPACITY],
+                                            memory_order_relaxed);
+        if (atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                    memory_order_seq_cst,
+                                                    memory_order_relaxed)) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+// ===== Workers =====
+
+// Function to run a task and signal its group
+static void run_task(WsWorker *w, WsTask *task) {
+    task->fn(task->arg);
+    w->executed++;
+    atomic_fetch_sub_explicit(&task->group->pending, 1, memory_order_release);
+}
+
+// Function to try stealing from one random victim
+static WsTask* try_steal(WsWorker *w) {
+    WsScheduler *s = w->sched;
+    if (s->num_workers < 2) return NULL;
+
+    int victim = rand_r(&w->seed) % (s->num_workers - 1);
+    if (victim >= w->id) victim++;
+    WsTask *task = deque_steal(&s->workers[victim].deque);
+    if (task) w->steals++;
+    return task;
+}
+
+// Function to back off when there is nothing to steal
+static void idle(int *failures) {
+    if (++(*failures) < 64) {
+        sched_yield();
+    } else {
+        struct timespec ts = {0, 50000}; // 50 us
+        nanosleep(&ts, NULL);
+    }
+}
+
+// Helper thread main loop: steal until the scheduler stops
+static void* worker_main(void *arg) {
+    WsWorker *w = (WsWorker*)arg;
+    current_worker = w->id;
+    int failures = 0;
+
+    while (!atomic_load_explicit(&w->sched->stop, memory_order_acquire)) {
+        WsTask *task = deque_pop(&w->deque);
+        if (!task) task = try_steal(w);
+        if (task) {
+            run_task(w, task);
+            failures = 0;
+        } else {
+            idle(&failures);
+        }
+    }
+    return NULL;
+}
+
+// Function to create the scheduler
+WsScheduler* ws_create(int num_workers) {
+    if (num_workers < 1) num_workers = 1;
+
+    WsScheduler *s = (WsScheduler*)malloc(sizeof(WsScheduler));
+    WsWorker *workers = NULL;
+    if (!s || posix_memalign((void**)&workers, 64, num_workers * sizeof(WsWorker)) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    s->num_workers = num_workers;
+    s->workers = workers;
+    atomic_init(&s->stop, 0);
+
+    for (int i = 0; i < num_workers; i++) {
+        WsWorker *w = &workers[i];
+        w->sched = s;
+        w->id = i;
+        w->seed = 12345u + 7919u * i;
+        w->executed = 0;
+        w->steals = 0;
+        atomic_init(&w->deque.top, 0);
+        atomic_init(&w->deque.bottom, 0);
+    }
+
+    current_worker = 0;
+    for (int i = 1; i < num_workers; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "Failed to start worker thread %d\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return s;
+}
+
+// Function to stop and free the scheduler
+void ws_destroy(WsScheduler *s) {
+    if (!s) return;
+    atomic_store_explicit(&s->stop, 1, memory_order_release);
+    for (int i = 1; i < s->num_workers; i++) {
+        pthread_join(s->workers[i].thread, NULL);
+    }
+    current_worker = -1;
+    free(s->workers);
+    free(s);
+}
+
+// Function to initialize a task group
+void ws_group_init(WsGroup *g) {
+    atomic_init(&g->pending, 0);
+}
+
+// Function to spawn a task
+void ws_spawn(WsScheduler *s, WsTask *task, ws_task_func fn, void *arg, WsGroup *g) {
+    task->fn = fn;
+    task->arg = arg;
+    task->group = g;
+    atomic_fetch_add_explicit(&g->pending, 1, memory_order_relaxed);
+
+    int id = current_worker;
+    if (id < 0 || id >= s->num_workers || !deque_push(&s->workers[id].deque, task)) {
+        // Not a worker thread or deque full: run it right away
+        fn(arg);
+        atomic_fetch_sub_explicit(&g->pending, 1, memory_order_release);
+    }
+}
+
+// Function to wait for a task group, helping with other work meanwhile
+void ws_wait(WsScheduler *s, WsGroup *g) {
+    int id = current_worker;
+    if (id < 0) {
+        while (atomic_load_explicit(&g->pending, memory_order_acquire) > 0) sched_yield();
+        return;
+    }
+
+    WsWorker *w = &s->workers[id];
+    int failures = 0;
+    while (atomic_load_explicit(&g->pending, memory_order_acquire) > 0) {
+        // Own deque first (our children sit at the bottom), then steal
+        WsTask *task = deque_pop(&w->deque);
+        if (!task) task = try_steal(w);
+        if (task) {
+            run_task(w, task);
+            failures = 0;
+        } else {
+            idle(&failures);
+        }
+    }
+}
+
+// Function to reset the scheduler statistics
+void ws_reset_stats(WsScheduler *s) {
+    for (int i = 0; i < s->num_workers; i++) {
+        s->workers[i].executed = 0;
+        s->workers[i].steals = 0;
+    }
+}
+
+// Function to sum the scheduler statistics
+void ws_stats(const WsScheduler *s, long *executed, long *steals) {
+    *executed = 0;
+    *steals = 0;
+    for (int i = 0; i < s->num_workers; i++) {
+        *executed += s->workers[i].executed;
+        *steals += s->workers[i].steals;
+    }
+}
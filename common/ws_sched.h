@@ -0,0 +1,72 @@
+#ifndef WS_SCHED_H
+#define WS_SCHED_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Slots per worker deque; a spawn that finds the deque full runs inline
+#define WS_DEQUE_CAPACITY 4096
+
+typedef void (*ws_task_func)(void *arg);
+
+// Set of spawned tasks a parent waits for
+typedef struct {
+    atomic_int pending;
+} WsGroup;
+
+// A task lives in its spawner's stack frame: the spawner always waits for
+// its group before returning, so the storage outlives the execution.
+typedef struct {
+    ws_task_func fn;
+    void *arg;
+    WsGroup *group;
+} WsTask;
+
+// Chase-Lev work-stealing deque (fixed capacity, C11 atomics).
+// The owner pushes and pops at the bottom, thieves steal from the top.
+typedef struct {
+    atomic_long top;
+    atomic_long bottom;
+    _Atomic(WsTask*) buffer[WS_DEQUE_CAPACITY];
+} WsDeque;
+
+typedef struct WsScheduler WsScheduler;
+
+typedef struct {
+    WsScheduler *sched;
+    WsDeque deque;
+    pthread_t thread;
+    int id;
+    unsigned int seed;
+    long executed;
+    long steals;
+} WsWorker;
+
+struct WsScheduler {
+    int num_workers;
+    WsWorker *workers;
+    atomic_int stop;
+};
+
+// Create a scheduler with num_workers workers; the calling thread becomes
+// worker 0 and num_workers - 1 helper threads are started.
+WsScheduler* ws_create(int num_workers);
+
+// Stop the helper threads and free the scheduler
+void ws_destroy(WsScheduler *s);
+
+// Initialize an empty task group
+void ws_group_init(WsGroup *g);
+
+// Push a task on the current worker's deque (runs inline if it is full
+// or if called from a thread that is not a worker)
+void ws_spawn(WsScheduler *s, WsTask *task, ws_task_func fn, void *arg, WsGroup *g);
+
+// Execute local and stolen tasks until every task of the group has finished
+void ws_wait(WsScheduler *s, WsGroup *g);
+
+// Reset / sum the per-worker executed and stolen task counters
+void ws_reset_stats(WsScheduler *s);
+void ws_stats(const WsScheduler *s, long *executed, long *steals);
+
+#endif